@@ -52,4 +52,8 @@ endif
 
 ifeq (${ENABLE_PMF},1)
 BL2_SOURCES		+=	lib/pmf/pmf_main.c
-endif
\ No newline at end of file
+endif
+
+ifeq (${AUTH_VERIFIED_CACHE},1)
+BL2_SOURCES		+=	lib/transfer_list/transfer_list.c
+endif
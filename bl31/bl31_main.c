@@ -18,6 +18,7 @@
 #include <common/runtime_svc.h>
 #include <drivers/console.h>
 #include <lib/bootmarker_capture.h>
+#include <lib/el3_trace.h>
 #include <lib/el3_runtime/context_mgmt.h>
 #include <lib/pmf/pmf.h>
 #include <lib/runtime_instr.h>
@@ -145,6 +146,11 @@ void bl31_main(void)
 	/* Initialise helper libraries */
 	bl31_lib_init();
 
+#if EL3_TRACE
+	/* Initialise the EL3 trace buffer before the first trace point */
+	el3_trace_init();
+#endif
+
 #if EL3_EXCEPTION_HANDLING
 	INFO("BL31: Initialising Exception Handling Framework\n");
 	ehf_init();
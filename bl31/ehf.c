@@ -16,6 +16,7 @@
 #include <context.h>
 #include <common/debug.h>
 #include <drivers/arm/gic_common.h>
+#include <lib/el3_trace.h>
 #include <lib/el3_runtime/context_mgmt.h>
 #include <lib/el3_runtime/cpu_data.h>
 #include <lib/el3_runtime/pubsub_events.h>
@@ -150,6 +151,7 @@ void ehf_activate_priority(unsigned int priority)
 	if (cur_pri_idx == EHF_INVALID_IDX)
 		pe_data->init_pri_mask = (uint8_t) old_mask;
 
+	EL3_TRACE_EVENT(EL3_TRACE_EHF_ACTIVATE, priority, 0);
 	EHF_LOG("activate prio=%d\n", get_pe_highest_active_idx(pe_data));
 }
 
@@ -214,6 +216,7 @@ void ehf_deactivate_priority(unsigned int priority)
 		panic();
 	}
 
+	EL3_TRACE_EVENT(EL3_TRACE_EHF_DEACTIVATE, priority, 0);
 	EHF_LOG("deactivate prio=%d\n", get_pe_highest_active_idx(pe_data));
 }
 
@@ -440,6 +443,8 @@ static uint64_t ehf_el3_interrupt_handler(uint32_t id, uint32_t flags,
 		panic();
 	}
 
+	EL3_TRACE_EVENT(EL3_TRACE_EHF_INTR, intr, pri);
+
 	/*
 	 * Call registered handler. Pass the raw interrupt value to registered
 	 * handlers.
@@ -6,6 +6,7 @@
 
 #include <assert.h>
 #include <errno.h>
+#include <stdbool.h>
 #include <string.h>
 
 #include <arch.h>
@@ -13,7 +14,9 @@
 #include <arch_helpers.h>
 #include <common/bl_common.h>
 #include <common/debug.h>
+#include <common/image_decompress.h>
 #include <drivers/auth/auth_mod.h>
+#include <drivers/auth/crypto_mod.h>
 #include <drivers/io/io_storage.h>
 #include <lib/utils.h>
 #include <lib/xlat_tables/xlat_tables_defs.h>
@@ -59,6 +62,100 @@ uintptr_t page_align(uintptr_t value, unsigned dir)
 	return value;
 }
 
+#if IMAGE_DECOMPRESS_STREAM
+/******************************************************************************
+ * Function to determine whether the images are authenticated once loaded.
+ *****************************************************************************/
+static bool is_auth_enabled(void)
+{
+#if TRUSTED_BOARD_BOOT
+	return dyn_is_auth_disabled() == 0;
+#else
+	return false;
+#endif
+}
+#endif /* IMAGE_DECOMPRESS_STREAM */
+
+#if HASH_ON_LOAD || IMAGE_DECOMPRESS_STREAM
+/*
+ * Size of the chunks an image is read in when it is hashed or decompressed
+ * while loading. Each chunk is processed right after it is read, while it is
+ * still in the data cache.
+ */
+#define LOAD_CHUNK_SIZE		U(0x8000)
+
+/*******************************************************************************
+ * Internal function to read an image in chunks and to process each chunk as
+ * soon as it is read:
+ * - with HASH_ON_LOAD, the chunk is hashed so that the crypto module can verify
+ *   and measure the image without reading it again.
+ * - with IMAGE_DECOMPRESS_STREAM, the chunk is inflated to the final
+ *   destination of the image, if the image is compressed. An authenticated
+ *   image is only inflated while it is loaded with HASH_ON_LOAD, which reads
+ *   it in chunks anyway. Its final destination is erased if it then fails
+ *   authentication. Without HASH_ON_LOAD, an authenticated image is only
+ *   decompressed once it has been authenticated.
+ * The image is read in one go if there is nothing to do with the chunks.
+ ******************************************************************************/
+static int read_in_chunks(uintptr_t image_handle, image_info_t *image_data,
+			  size_t image_size, size_t *bytes_read)
+{
+	uintptr_t image_base = image_data->image_base;
+	size_t offset, chunk, chunk_read = 0U;
+	bool hash = false;
+	bool stream = false;
+	int io_result = 0;
+
+#if HASH_ON_LOAD
+	hash = (crypto_mod_load_hash_start() == 0);
+#endif
+#if IMAGE_DECOMPRESS_STREAM
+	stream = (!is_auth_enabled() || (HASH_ON_LOAD != 0)) &&
+		 (image_decompress_stream_start(image_data) == 0);
+#endif
+	if (!hash && !stream) {
+		return io_read(image_handle, image_base, image_size,
+			       bytes_read);
+	}
+
+	for (offset = 0U; offset < image_size; offset += chunk_read) {
+		chunk = MIN(image_size - offset, (size_t)LOAD_CHUNK_SIZE);
+		io_result = io_read(image_handle, image_base + offset, chunk,
+				    &chunk_read);
+		if ((io_result != 0) || (chunk_read == 0U)) {
+			break;
+		}
+
+#if HASH_ON_LOAD
+		if (hash && (crypto_mod_load_hash_update(
+				(void *)(image_base + offset),
+				(unsigned int)chunk_read) != 0)) {
+			hash = false;
+		}
+#endif
+#if IMAGE_DECOMPRESS_STREAM
+		if (stream && (image_decompress_stream_update(
+				image_base + offset, chunk_read) != 0)) {
+			stream = false;
+		}
+#endif
+	}
+
+	*bytes_read = offset;
+
+#if HASH_ON_LOAD
+	if (hash && (offset == image_size)) {
+		(void)crypto_mod_load_hash_finish((void *)image_base,
+						  (unsigned int)image_size);
+	} else {
+		crypto_mod_load_hash_clear();
+	}
+#endif
+
+	return io_result;
+}
+#endif /* HASH_ON_LOAD || IMAGE_DECOMPRESS_STREAM */
+
 /*******************************************************************************
  * Internal function to load an image at a specific address given
  * an image ID and extents of free memory.
@@ -123,7 +220,12 @@ static int load_image(unsigned int image_id, image_info_t *image_data)
 
 	/* We have enough space so load the image now */
 	/* TODO: Consider whether to try to recover/retry a partially successful read */
+#if HASH_ON_LOAD || IMAGE_DECOMPRESS_STREAM
+	io_result = read_in_chunks(image_handle, image_data, image_size,
+				   &bytes_read);
+#else
 	io_result = io_read(image_handle, image_base, image_size, &bytes_read);
+#endif
 	if ((io_result != 0) || (bytes_read < image_size)) {
 		WARN("Failed to load image id=%u (%i)\n", image_id, io_result);
 		goto exit;
@@ -180,6 +282,10 @@ static int load_auth_image_recursive(unsigned int image_id,
 			       image_data->image_size);
 		flush_dcache_range(image_data->image_base,
 				   image_data->image_size);
+#if IMAGE_DECOMPRESS_STREAM
+		/* Also erase what was inflated while the image was loaded */
+		image_decompress_stream_abort(image_data);
+#endif
 		return -EAUTH;
 	}
 
@@ -230,18 +336,22 @@ int load_auth_image(unsigned int image_id, image_info_t *image_data)
 		 * it (if MEASURED_BOOT flag is enabled).
 		 */
 		err = plat_mboot_measure_image(image_id, image_data);
-		if (err != 0) {
-			return err;
+		if (err == 0) {
+			/*
+			 * Flush the image to main memory so that it can be
+			 * executed later by any CPU, regardless of cache and
+			 * MMU state.
+			 */
+			flush_dcache_range(image_data->image_base,
+					   image_data->image_size);
 		}
-
-		/*
-		 * Flush the image to main memory so that it can be executed
-		 * later by any CPU, regardless of cache and MMU state.
-		 */
-		flush_dcache_range(image_data->image_base,
-				   image_data->image_size);
 	}
 
+#if HASH_ON_LOAD
+	/* The digests computed while loading are only valid for this image */
+	crypto_mod_load_hash_clear();
+#endif
+
 	return err;
 }
 
@@ -142,6 +142,8 @@ void detect_arch_features(void)
 
 	/* v8.0 features */
 	check_feature(ENABLE_FEAT_SB, read_feat_sb_id_field(), "SB", 1, 1);
+	check_feature(ENABLE_FEAT_CRC32, read_feat_crc32_id_field(),
+		      "CRC32", 1, 1);
 	check_feature(ENABLE_FEAT_CSV2_2, read_feat_csv2_id_field(),
 		      "CSV2_2", 2, 3);
 	/*
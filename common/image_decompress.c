@@ -5,24 +5,110 @@
  */
 
 #include <assert.h>
+#include <errno.h>
+#include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 
 #include <arch_helpers.h>
 #include <common/bl_common.h>
 #include <common/debug.h>
 #include <common/image_decompress.h>
+#include <lib/utils.h>
 
 static uintptr_t decompressor_buf_base;
 static uint32_t decompressor_buf_size;
 static decompressor_t *decompressor;
+static const image_decompressor_t *const *decompressors;
+static unsigned int decompressors_count;
 static struct image_info saved_image_info;
 
+#if IMAGE_DECOMPRESS_STREAM
+static const decompressor_stream_t *decompressor_stream;
+static const struct image_info *stream_image_info;
+
+/* Workspace of the stream, after the compressed image */
+static uintptr_t stream_work_base;
+static uint32_t stream_work_size;
+
+static enum {
+	STREAM_IDLE,
+	STREAM_STARTED,		/* Waiting for the first chunk of the image */
+	STREAM_RUNNING,
+	STREAM_DONE,
+	STREAM_FAILED,
+} stream_state;
+#endif
+
 void image_decompress_init(uintptr_t buf_base, uint32_t buf_size,
 			   decompressor_t *_decompressor)
 {
 	decompressor_buf_base = buf_base;
 	decompressor_buf_size = buf_size;
 	decompressor = _decompressor;
+	decompressors = NULL;
+	decompressors_count = 0U;
+}
+
+/*
+ * Same as image_decompress_init(), but the decompressor of each image is
+ * selected among several ones by the magic number at the start of the
+ * compressed image, so that each image can use a different format.
+ */
+void image_decompress_init_multi(uintptr_t buf_base, uint32_t buf_size,
+				 const image_decompressor_t *const *_decompressors,
+				 unsigned int count)
+{
+	decompressor_buf_base = buf_base;
+	decompressor_buf_size = buf_size;
+	decompressor = NULL;
+	decompressors = _decompressors;
+	decompressors_count = count;
+}
+
+static bool match_magic(const image_decompressor_t *desc,
+			uintptr_t compressed_image_base,
+			size_t compressed_image_size)
+{
+	return (compressed_image_size >= desc->magic_len) &&
+	       (memcmp((const void *)compressed_image_base, desc->magic,
+		       desc->magic_len) == 0);
+}
+
+/* Find the format of an image among the registered decompressors */
+static const image_decompressor_t *find_format(uintptr_t compressed_image_base,
+					       size_t compressed_image_size)
+{
+	unsigned int i;
+
+	for (i = 0U; i < decompressors_count; i++) {
+		if (match_magic(decompressors[i], compressed_image_base,
+				compressed_image_size)) {
+			return decompressors[i];
+		}
+	}
+
+	return NULL;
+}
+
+static decompressor_t *select_decompressor(uintptr_t compressed_image_base,
+					   uint32_t compressed_image_size)
+{
+	const image_decompressor_t *desc;
+
+	if (decompressors == NULL) {
+		return decompressor;
+	}
+
+	desc = find_format(compressed_image_base, compressed_image_size);
+	if (desc == NULL) {
+		ERROR("Unknown image compression format\n");
+		return NULL;
+	}
+
+	VERBOSE("Image compressed with %s\n", desc->name);
+
+	return desc->decompress;
 }
 
 void image_decompress_prepare(struct image_info *info)
@@ -36,14 +122,190 @@ void image_decompress_prepare(struct image_info *info)
 	saved_image_info = *info;
 	info->image_base = decompressor_buf_base;
 	info->image_max_size = decompressor_buf_size;
+
+#if IMAGE_DECOMPRESS_STREAM
+	stream_image_info = info;
+	stream_state = STREAM_IDLE;
+#endif
 }
 
-int image_decompress(struct image_info *info)
+#if IMAGE_DECOMPRESS_STREAM
+void image_decompress_init_stream(const decompressor_stream_t *stream)
+{
+	decompressor_stream = stream;
+}
+
+/*
+ * Called by load_image() before it reads an image. If the image has been
+ * prepared for decompression, a new stream is started so that the compressed
+ * data can be inflated to the final destination while it is read. The stream
+ * is restarted on each load of the image, so the certificates loaded through
+ * the same image_info and the retries of a failed load are discarded.
+ */
+int image_decompress_stream_start(const struct image_info *info)
+{
+	if ((decompressor_stream == NULL) || (info != stream_image_info)) {
+		return -1;
+	}
+
+	assert(info->image_size <= decompressor_buf_size);
+
+	/*
+	 * The compressed image is still loaded to the temporary buffer, as it
+	 * is authenticated and measured as a whole, so the rest of the buffer
+	 * is the workspace of the decompressor, like in image_decompress().
+	 */
+	stream_work_base = decompressor_buf_base + info->image_size;
+	stream_work_size = decompressor_buf_size - info->image_size;
+	stream_state = STREAM_STARTED;
+
+	return 0;
+}
+
+/*
+ * Check that the image, whose first chunk is given, is in the format of the
+ * streaming decompressor. The format is found from the magic number at the
+ * start of the image, in the same way as image_decompress() selects the
+ * decompressor of the image. Images in other formats are not streamed.
+ */
+static bool stream_format_matches(uintptr_t buf, size_t len)
+{
+	const image_decompressor_t *format = decompressor_stream->format;
+
+	if (decompressors != NULL) {
+		return find_format(buf, len) == format;
+	}
+
+	return (decompressor == format->decompress) &&
+	       match_magic(format, buf, len);
+}
+
+/*
+ * Called by load_image() with each chunk of the image it has read. Errors
+ * are not fatal: the image is then decompressed from the temporary buffer by
+ * image_decompress(), which reports them.
+ */
+int image_decompress_stream_update(uintptr_t buf, size_t len)
 {
-	uintptr_t compressed_image_base, image_base, work_base;
-	uint32_t compressed_image_size, work_size;
 	int ret;
 
+	if (stream_state == STREAM_DONE) {
+		/* Ignore any trailing data, like the one-shot decompressor */
+		return 0;
+	}
+
+	if (stream_state == STREAM_STARTED) {
+		if (!stream_format_matches(buf, len)) {
+			stream_state = STREAM_FAILED;
+			return -1;
+		}
+
+		ret = decompressor_stream->init(saved_image_info.image_base,
+						saved_image_info.image_max_size,
+						stream_work_base,
+						stream_work_size);
+		if (ret != 0) {
+			stream_state = STREAM_FAILED;
+			return ret;
+		}
+
+		stream_state = STREAM_RUNNING;
+	}
+
+	if (stream_state != STREAM_RUNNING) {
+		return -1;
+	}
+
+	ret = decompressor_stream->update(buf, len);
+	if (ret < 0) {
+		VERBOSE("Streaming decompression failed (err=%d)\n", ret);
+		stream_state = STREAM_FAILED;
+		return ret;
+	}
+
+	if (ret > 0) {
+		stream_state = STREAM_DONE;
+	}
+
+	return 0;
+}
+
+/*
+ * Called when an image loaded through `info` fails authentication. If a stream
+ * has been started for it, the output of the decompressor has reached the
+ * final destination of the image before it was authenticated, so the whole
+ * destination is zeroed and flushed, and the stream is dropped.
+ */
+void image_decompress_stream_abort(const struct image_info *info)
+{
+	if ((info != stream_image_info) || (stream_state == STREAM_IDLE) ||
+	    (stream_state == STREAM_STARTED)) {
+		return;
+	}
+
+	zero_normalmem((void *)saved_image_info.image_base,
+		       saved_image_info.image_max_size);
+	flush_dcache_range(saved_image_info.image_base,
+			   saved_image_info.image_max_size);
+
+	stream_state = STREAM_FAILED;
+}
+
+/*
+ * If the whole image has been inflated while it was loaded, collect the end
+ * of the output in image_base. Otherwise, return an error so that the image
+ * is decompressed from the temporary buffer instead.
+ */
+static int stream_finish(uintptr_t *image_base)
+{
+	bool done = (stream_state == STREAM_DONE);
+
+	stream_state = STREAM_IDLE;
+	stream_image_info = NULL;
+
+	if (!done) {
+		return -1;
+	}
+
+	return decompressor_stream->finish(image_base);
+}
+#endif /* IMAGE_DECOMPRESS_STREAM */
+
+/*
+ * Decompress the image from the temporary buffer to image_base, and update
+ * image_base to the end of the output.
+ */
+static int decompress_buf(uintptr_t compressed_image_base,
+			  uint32_t compressed_image_size,
+			  uintptr_t *image_base, uint32_t image_max_size)
+{
+	decompressor_t *decompress;
+	uintptr_t work_base;
+	uint32_t work_size;
+
+	decompress = select_decompressor(compressed_image_base,
+					 compressed_image_size);
+	if (decompress == NULL) {
+		return -EINVAL;
+	}
+
+	/*
+	 * Use the rest of the temporary buffer as workspace of the
+	 * decompressor since the decompressor may need additional memory.
+	 */
+	work_base = compressed_image_base + compressed_image_size;
+	work_size = decompressor_buf_size - compressed_image_size;
+
+	return decompress(&compressed_image_base, compressed_image_size,
+			  image_base, image_max_size, work_base, work_size);
+}
+
+int image_decompress(struct image_info *info)
+{
+	uintptr_t compressed_image_base, image_base;
+	uint32_t compressed_image_size;
+	int ret = -1;
+
 	/*
 	 * The size of compressed data has been filled by load_image().
 	 * Read it out before restoring image_info.
@@ -56,16 +318,16 @@ int image_decompress(struct image_info *info)
 
 	image_base = info->image_base;
 
-	/*
-	 * Use the rest of the temporary buffer as workspace of the
-	 * decompressor since the decompressor may need additional memory.
-	 */
-	work_base = compressed_image_base + compressed_image_size;
-	work_size = decompressor_buf_size - compressed_image_size;
-
-	ret = decompressor(&compressed_image_base, compressed_image_size,
-			   &image_base, info->image_max_size,
-			   work_base, work_size);
+#if IMAGE_DECOMPRESS_STREAM
+	ret = stream_finish(&image_base);
+#endif
+	if (ret != 0) {
+		/* Decompress the image from the temporary buffer */
+		image_base = info->image_base;
+		ret = decompress_buf(compressed_image_base,
+				     compressed_image_size, &image_base,
+				     info->image_max_size);
+	}
 	if (ret) {
 		ERROR("Failed to decompress image (err=%d)\n", ret);
 		return ret;
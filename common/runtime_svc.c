@@ -25,6 +25,55 @@ uint8_t rt_svc_descs_indices[MAX_RT_SVCS];
 #define RT_SVC_DECS_NUM		((RT_SVC_DESCS_END - RT_SVC_DESCS_START)\
 					/ sizeof(rt_svc_desc_t))
 
+/*******************************************************************************
+ * The 'rt_svc_fid_descs' array holds the fast-path descriptors exported by
+ * services by placing them in the 'rt_svc_fid_descs' linker section. When
+ * SMC_FAST_PATH is enabled, the function id of an SMC is looked up once the
+ * owning runtime service has been found, and the handler of a matching
+ * descriptor is called instead of the handler of the runtime service.
+ *
+ * The lookup takes constant time. The unique oen and the calling convention of
+ * the SMC give a window of function numbers in the 'rt_svc_fid_windows' array,
+ * and the function number gives an entry of the window in the
+ * 'rt_svc_fid_indices' array. That entry holds the index of the descriptor in
+ * the 'rt_svc_fid_descs' array plus one, or 0 if the function id has no
+ * fast-path descriptor. SMC32 and SMC64 function ids have separate windows, as
+ * they may share an owning entity number and a function number.
+ ******************************************************************************/
+#define RT_SVC_FID_DESCS_NUM	((RT_SVC_FID_DESCS_END - RT_SVC_FID_DESCS_START)\
+					/ sizeof(rt_svc_fid_desc_t))
+
+#if SMC_FAST_PATH
+rt_svc_fid_window_t rt_svc_fid_windows[RT_SVC_FID_WINDOWS_NUM];
+uint8_t rt_svc_fid_indices[RT_SVC_FID_INDICES_NUM];
+
+/*******************************************************************************
+ * Function to look up the fast-path handler registered for the smc_fid. The
+ * handler of the owning runtime service is returned if there is none.
+ ******************************************************************************/
+static rt_svc_handle_t get_rt_svc_fid_handler(uint32_t smc_fid,
+					      rt_svc_handle_t svc_handler)
+{
+	const rt_svc_fid_desc_t *fid_descs;
+	const rt_svc_fid_window_t *window;
+	unsigned int idx, fn;
+	uint8_t index;
+
+	idx = get_rt_svc_fid_window_from_smc_fid(smc_fid);
+	window = &rt_svc_fid_windows[idx];
+	fn = GET_SMC_NUM(smc_fid) - window->fn_base;
+	if (fn >= window->fn_count)
+		return svc_handler;
+
+	index = rt_svc_fid_indices[window->offset + fn];
+	if (index == 0U)
+		return svc_handler;
+
+	fid_descs = (rt_svc_fid_desc_t *) RT_SVC_FID_DESCS_START;
+	return fid_descs[index - 1U].handle;
+}
+#endif
+
 /*******************************************************************************
  * Function to invoke the registered `handle` corresponding to the smc_fid in
  * AArch32 mode.
@@ -38,6 +87,7 @@ uintptr_t handle_runtime_svc(uint32_t smc_fid,
 	unsigned int index;
 	unsigned int idx;
 	const rt_svc_desc_t *rt_svc_descs;
+	rt_svc_handle_t smc_handler;
 
 	assert(handle != NULL);
 	idx = get_unique_oen_from_smc_fid(smc_fid);
@@ -48,11 +98,15 @@ uintptr_t handle_runtime_svc(uint32_t smc_fid,
 		SMC_RET1(handle, SMC_UNK);
 
 	rt_svc_descs = (rt_svc_desc_t *) RT_SVC_DESCS_START;
+	smc_handler = rt_svc_descs[index].handle;
+
+#if SMC_FAST_PATH
+	smc_handler = get_rt_svc_fid_handler(smc_fid, smc_handler);
+#endif
 
 	get_smc_params_from_ctx(handle, x1, x2, x3, x4);
 
-	return rt_svc_descs[index].handle(smc_fid, x1, x2, x3, x4, cookie,
-						handle, flags);
+	return smc_handler(smc_fid, x1, x2, x3, x4, cookie, handle, flags);
 }
 
 /*******************************************************************************
@@ -80,6 +134,103 @@ static int32_t validate_rt_svc_desc(const rt_svc_desc_t *desc)
 	return 0;
 }
 
+#if SMC_FAST_PATH
+/*******************************************************************************
+ * This function builds the fast-path index once the runtime services have been
+ * initialised. A descriptor without a handler cannot be used, and one for a
+ * function id that no runtime service owns is never reached, so it is left out
+ * of the index. The windows of all the unique oens and calling conventions must
+ * fit in the 'rt_svc_fid_indices' array.
+ ******************************************************************************/
+static void __init rt_svc_fid_index_init(void)
+{
+	const rt_svc_fid_desc_t *fid_descs;
+	rt_svc_fid_window_t *window;
+	unsigned int index, idx, fn, offset = 0U;
+
+	assert(RT_SVC_FID_DESCS_END >= RT_SVC_FID_DESCS_START);
+
+	if (RT_SVC_FID_DESCS_NUM > UINT8_MAX) {
+		ERROR("Too many runtime service fast-path descriptors\n");
+		panic();
+	}
+
+	/* Find the lowest function number of each window */
+	fid_descs = (rt_svc_fid_desc_t *) RT_SVC_FID_DESCS_START;
+	for (index = 0U; index < RT_SVC_FID_DESCS_NUM; index++) {
+		if (fid_descs[index].handle == NULL) {
+			ERROR("Invalid runtime service fast-path descriptor %p\n",
+				(const void *) &fid_descs[index]);
+			panic();
+		}
+
+		idx = get_unique_oen_from_smc_fid(fid_descs[index].smc_fid);
+		if (rt_svc_descs_indices[idx] >= RT_SVC_DECS_NUM) {
+			WARN("No runtime service for fast-path SMC 0x%x\n",
+				fid_descs[index].smc_fid);
+			continue;
+		}
+
+		idx = get_rt_svc_fid_window_from_smc_fid(fid_descs[index].smc_fid);
+		window = &rt_svc_fid_windows[idx];
+		fn = GET_SMC_NUM(fid_descs[index].smc_fid);
+		if ((window->fn_count == 0U) || (fn < window->fn_base)) {
+			window->fn_base = (uint16_t)fn;
+			window->fn_count = 1U;
+		}
+	}
+
+	/* Size the windows, then lay them out one after the other */
+	for (index = 0U; index < RT_SVC_FID_DESCS_NUM; index++) {
+		idx = get_rt_svc_fid_window_from_smc_fid(fid_descs[index].smc_fid);
+		window = &rt_svc_fid_windows[idx];
+		if (window->fn_count == 0U)
+			continue;
+
+		fn = GET_SMC_NUM(fid_descs[index].smc_fid) - window->fn_base;
+		if (fn >= UINT8_MAX) {
+			ERROR("Fast-path SMC 0x%x too far from SMC 0x%x\n",
+				fid_descs[index].smc_fid,
+				fid_descs[index].smc_fid - fn);
+			panic();
+		}
+		if (fn >= window->fn_count)
+			window->fn_count = (uint8_t)(fn + 1U);
+	}
+
+	for (idx = 0U; idx < RT_SVC_FID_WINDOWS_NUM; idx++) {
+		window = &rt_svc_fid_windows[idx];
+		if (window->fn_count == 0U)
+			continue;
+
+		if ((offset > UINT8_MAX) ||
+		    ((offset + window->fn_count) > RT_SVC_FID_INDICES_NUM)) {
+			ERROR("Runtime service fast-path index is full\n");
+			panic();
+		}
+		window->offset = (uint8_t)offset;
+		offset += window->fn_count;
+	}
+
+	/* Fill the windows with the indices of the descriptors */
+	for (index = 0U; index < RT_SVC_FID_DESCS_NUM; index++) {
+		idx = get_rt_svc_fid_window_from_smc_fid(fid_descs[index].smc_fid);
+		window = &rt_svc_fid_windows[idx];
+		if (window->fn_count == 0U)
+			continue;
+
+		fn = window->offset + GET_SMC_NUM(fid_descs[index].smc_fid) -
+			window->fn_base;
+		if (rt_svc_fid_indices[fn] != 0U) {
+			ERROR("Duplicate fast-path descriptor for SMC 0x%x\n",
+				fid_descs[index].smc_fid);
+			panic();
+		}
+		rt_svc_fid_indices[fn] = (uint8_t)(index + 1U);
+	}
+}
+#endif
+
 /*******************************************************************************
  * This function calls the initialisation routine in the descriptor exported by
  * a runtime service. Once a descriptor has been validated, its start & end
@@ -151,4 +302,8 @@ void __init runtime_svc_init(void)
 		for (; start_idx <= end_idx; start_idx++)
 			rt_svc_descs_indices[start_idx] = index;
 	}
+
+#if SMC_FAST_PATH
+	rt_svc_fid_index_init();
+#endif
 }
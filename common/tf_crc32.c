@@ -1,22 +1,160 @@
 /*
- * Copyright (c) 2021, Arm Limited. All rights reserved.
+ * Copyright (c) 2021-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
 #include <stdarg.h>
 #include <assert.h>
+#include <stdbool.h>
 
 #include <arm_acle.h>
+#include <arch_features.h>
 #include <common/debug.h>
 #include <common/tf_crc32.h>
 
-/* compute CRC using Arm intrinsic function
+/*
+ * On AArch64, the CRC32 instructions are used if FEAT_CRC32 is enabled, or if
+ * it is detected at runtime when ENABLE_FEAT_CRC32 is 2. The function using
+ * them is built for a CPU with FEAT_CRC32 regardless of the architecture
+ * version of the build. On AArch32, they are used only if the build targets
+ * a CPU with FEAT_CRC32 ('-march=armv8-a+crc').
+ */
+#ifdef __aarch64__
+#define CRC32_HW	(ENABLE_FEAT_CRC32 != FEAT_STATE_DISABLED)
+#define CRC32_SW	(ENABLE_FEAT_CRC32 != FEAT_STATE_ALWAYS)
+#elif defined(__ARM_FEATURE_CRC32)
+#define CRC32_HW	1
+#define CRC32_SW	0
+#else
+#define CRC32_HW	0
+#define CRC32_SW	1
+#endif
+
+#if CRC32_HW
+#ifdef __aarch64__
+#ifdef __clang__
+#define CRC32_TARGET	__attribute__((target("crc")))
+#else
+#define CRC32_TARGET	__attribute__((target("+crc")))
+#endif
+#else
+#define CRC32_TARGET
+#endif
+
+/*
+ * Compute CRC using the CRC32 instructions, 8 bytes (4 on AArch32) at a time
+ * once the buffer is aligned.
+ */
+static CRC32_TARGET uint32_t crc32_hw(uint32_t crc, const unsigned char *buf,
+				      size_t size)
+{
+	while ((size != 0U) && (((uintptr_t)buf % sizeof(u_register_t)) != 0U)) {
+		crc = __crc32b(crc, *buf);
+		buf++;
+		size--;
+	}
+
+	while (size >= sizeof(u_register_t)) {
+#ifdef __aarch64__
+		crc = __crc32d(crc, *(const uint64_t *)buf);
+#else
+		crc = __crc32w(crc, *(const uint32_t *)buf);
+#endif
+		buf += sizeof(u_register_t);
+		size -= sizeof(u_register_t);
+	}
+
+	while (size != 0U) {
+		crc = __crc32b(crc, *buf);
+		buf++;
+		size--;
+	}
+
+	return crc;
+}
+#endif /* CRC32_HW */
+
+#if CRC32_SW
+/* Reversed CRC-32 polynomial, as used by zlib and the GPT headers */
+#define CRC32_POLY	U(0xEDB88320)
+
+/*
+ * Tables for the slicing-by-8 algorithm: crc32_table[0] is the usual table
+ * for one byte, and crc32_table[n] advances the CRC over n more zero bytes.
+ * They are computed on first use, rather than taking 8KB of read-only data.
+ */
+static uint32_t crc32_table[8][256];
+static bool crc32_table_ready;
+
+static void crc32_table_init(void)
+{
+	unsigned int i, j;
+	uint32_t c;
+
+	for (i = 0U; i < 256U; i++) {
+		c = i;
+		for (j = 0U; j < 8U; j++) {
+			c = ((c & 1U) != 0U) ? ((c >> 1) ^ CRC32_POLY) : (c >> 1);
+		}
+		crc32_table[0][i] = c;
+	}
+
+	for (i = 0U; i < 256U; i++) {
+		for (j = 1U; j < 8U; j++) {
+			c = crc32_table[j - 1U][i];
+			crc32_table[j][i] = (c >> 8) ^ crc32_table[0][c & 0xFFU];
+		}
+	}
+
+	crc32_table_ready = true;
+}
+
+static inline uint32_t get_le32(const unsigned char *p)
+{
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+	       ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/* Compute CRC with the slicing-by-8 algorithm, 8 bytes at a time */
+static uint32_t crc32_sw(uint32_t crc, const unsigned char *buf, size_t size)
+{
+	uint32_t lo, hi;
+
+	if (!crc32_table_ready) {
+		crc32_table_init();
+	}
+
+	while (size >= 8U) {
+		lo = crc ^ get_le32(buf);
+		hi = get_le32(buf + 4);
+		crc = crc32_table[7][lo & 0xFFU] ^
+		      crc32_table[6][(lo >> 8) & 0xFFU] ^
+		      crc32_table[5][(lo >> 16) & 0xFFU] ^
+		      crc32_table[4][lo >> 24] ^
+		      crc32_table[3][hi & 0xFFU] ^
+		      crc32_table[2][(hi >> 8) & 0xFFU] ^
+		      crc32_table[1][(hi >> 16) & 0xFFU] ^
+		      crc32_table[0][hi >> 24];
+		buf += 8;
+		size -= 8U;
+	}
+
+	while (size != 0U) {
+		crc = (crc >> 8) ^ crc32_table[0][(crc ^ *buf) & 0xFFU];
+		buf++;
+		size--;
+	}
+
+	return crc;
+}
+#endif /* CRC32_SW */
+
+/* compute CRC32, as used by the GPT and FWU metadata
  *
- * This function is useful for the platforms with the CPU ARMv8.0
- * (with CRC instructions supported), and onwards.
- * Platforms with CPU ARMv8.0 should make sure to add a compile switch
- * '-march=armv8-a+crc" for successful compilation of this file.
+ * The CRC32 instructions are used when the CPU implements them and the build
+ * allows it (see ENABLE_FEAT_CRC32), otherwise a table-driven implementation
+ * is used.
  *
  * @crc: previous accumulated CRC
  * @buf: buffer base address
@@ -28,18 +166,15 @@ uint32_t tf_crc32(uint32_t crc, const unsigned char *buf, size_t size)
 {
 	assert(buf != NULL);
 
-	uint32_t calc_crc = ~crc;
-	const unsigned char *local_buf = buf;
-	size_t local_size = size;
-
-	/*
-	 * calculate CRC over byte data
-	 */
-	while (local_size != 0UL) {
-		calc_crc = __crc32b(calc_crc, *local_buf);
-		local_buf++;
-		local_size--;
+#if CRC32_HW && CRC32_SW
+	if (is_feat_crc32_supported()) {
+		return ~crc32_hw(~crc, buf, size);
 	}
 
-	return ~calc_crc;
+	return ~crc32_sw(~crc, buf, size);
+#elif CRC32_HW
+	return ~crc32_hw(~crc, buf, size);
+#else
+	return ~crc32_sw(~crc, buf, size);
+#endif
 }
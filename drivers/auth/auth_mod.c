@@ -17,7 +17,9 @@
 #include <drivers/auth/crypto_mod.h>
 #include <drivers/auth/img_parser_mod.h>
 #include <drivers/fwu/fwu.h>
+#include <lib/cassert.h>
 #include <lib/fconf/fconf_tbbr_getter.h>
+#include <lib/transfer_list.h>
 #include <plat/common/platform.h>
 
 #include <tools_share/zero_oid.h>
@@ -34,6 +36,32 @@
 
 #pragma weak plat_set_nv_ctr2
 
+#if AUTH_VERIFIED_CACHE
+/*
+ * Cache of the certificates verified by the current or an earlier boot stage,
+ * held in the data of a transfer list entry. Each record holds the ID and the
+ * SHA-256 digest of a certificate, followed by the parameters extracted from
+ * it. Records and parameters are padded to 8 bytes.
+ */
+#define AUTH_CACHE_DIGEST_LEN	U(32)
+#define AUTH_CACHE_ALIGN	U(8)
+
+typedef struct auth_cache_rec {
+	uint32_t img_id;
+	uint32_t size;		/* Size of the record, including parameters */
+	uint8_t digest[AUTH_CACHE_DIGEST_LEN];
+} auth_cache_rec_t;
+
+typedef struct auth_cache_param {
+	uint32_t idx;		/* Index in the authenticated data */
+	uint32_t len;
+} auth_cache_param_t;
+
+CASSERT(COT_MAX_VERIFIED_PARAMS <= 32, assert_auth_cache_max_params);
+
+static struct transfer_list_header *auth_cache_tl;
+#endif /* AUTH_VERIFIED_CACHE */
+
 static int cmp_auth_param_type_desc(const auth_param_type_desc_t *a,
 		const auth_param_type_desc_t *b)
 {
@@ -392,6 +420,184 @@ void auth_mod_init(void)
 	img_parser_init();
 }
 
+#if AUTH_VERIFIED_CACHE
+/*
+ * Use the transfer list `tl` to hold the cache of verified certificates. The
+ * cache entry is created if the list does not contain one yet, for example
+ * when called by the first boot stage. The list must be in Secure memory and
+ * only be written by trusted boot stages, as it is trusted without further
+ * checks.
+ *
+ * Return: 0 = success, Otherwise = error
+ */
+int auth_mod_cache_init(struct transfer_list_header *tl)
+{
+	if ((tl == NULL) || (transfer_list_check_header(tl) != TL_OPS_ALL)) {
+		return -1;
+	}
+
+	if ((transfer_list_find(tl, TL_TAG_TFA_AUTH_CACHE) == NULL) &&
+	    (transfer_list_add(tl, TL_TAG_TFA_AUTH_CACHE, 0U, NULL) == NULL)) {
+		return -1;
+	}
+
+	auth_cache_tl = tl;
+
+	return 0;
+}
+
+/*
+ * Look up a certificate in the cache and, if it was verified before, restore
+ * the parameters extracted from it to the authenticated data of the image
+ * descriptor and measure its public keys, as done for a full verification.
+ *
+ * Return: 0 = hit, Otherwise = miss
+ */
+static int auth_cache_lookup(const auth_img_desc_t *img_desc,
+			     const uint8_t *digest)
+{
+	struct transfer_list_entry *te;
+	const auth_cache_rec_t *rec = NULL;
+	const auth_cache_param_t *param;
+	const auth_param_desc_t *data;
+	unsigned int lens[COT_MAX_VERIFIED_PARAMS] = { 0 };
+	uint32_t found = 0U, expected = 0U;
+	uintptr_t ptr, end;
+	size_t sz;
+	int i, rc;
+
+	te = transfer_list_find(auth_cache_tl, TL_TAG_TFA_AUTH_CACHE);
+	if (te == NULL) {
+		return 1;
+	}
+
+	ptr = (uintptr_t)transfer_list_entry_data(te);
+	end = ptr + te->data_size;
+	while ((end - ptr) >= sizeof(auth_cache_rec_t)) {
+		rec = (const auth_cache_rec_t *)ptr;
+		if ((rec->size < sizeof(*rec)) || (rec->size > (end - ptr))) {
+			return 1;
+		}
+		if ((rec->img_id == img_desc->img_id) &&
+		    (memcmp(rec->digest, digest, AUTH_CACHE_DIGEST_LEN) == 0)) {
+			break;
+		}
+		ptr += rec->size;
+		rec = NULL;
+	}
+
+	if (rec == NULL) {
+		return 1;
+	}
+
+	/* Restore the parameters extracted from the certificate */
+	end = (uintptr_t)rec + rec->size;
+	for (ptr = (uintptr_t)(rec + 1);
+	     (end - ptr) >= sizeof(auth_cache_param_t);
+	     ptr += sz) {
+		param = (const auth_cache_param_t *)ptr;
+		sz = sizeof(*param) + round_up(param->len, AUTH_CACHE_ALIGN);
+		if ((param->idx >= COT_MAX_VERIFIED_PARAMS) ||
+		    (sz > (end - ptr))) {
+			return 1;
+		}
+
+		data = &img_desc->authenticated_data[param->idx];
+		if ((data->type_desc == NULL) || (param->len > data->data.len)) {
+			return 1;
+		}
+
+		memcpy(data->data.ptr, param + 1, param->len);
+		lens[param->idx] = param->len;
+		found |= 1U << param->idx;
+	}
+
+	for (i = 0 ; i < COT_MAX_VERIFIED_PARAMS ; i++) {
+		if (img_desc->authenticated_data[i].type_desc != NULL) {
+			expected |= 1U << i;
+		}
+	}
+
+	if (found != expected) {
+		return 1;
+	}
+
+	for (i = 0 ; i < COT_MAX_VERIFIED_PARAMS ; i++) {
+		data = &img_desc->authenticated_data[i];
+		if ((data->type_desc != NULL) &&
+		    (data->type_desc->type == AUTH_PARAM_PUB_KEY)) {
+			rc = plat_mboot_measure_key(data->type_desc->cookie,
+						    data->data.ptr, lens[i]);
+			if (rc != 0) {
+				WARN("Public Key measurement "
+				     "failure = %d\n", rc);
+			}
+		}
+	}
+
+	VERBOSE("Certificate %u found in the verified cache\n",
+		img_desc->img_id);
+
+	return 0;
+}
+
+/*
+ * Add a certificate that has just been verified to the cache, along with the
+ * parameters extracted from it. The certificate is not cached if the transfer
+ * list is full.
+ */
+static void auth_cache_add(const auth_img_desc_t *img_desc,
+			   const uint8_t *digest, const unsigned int *lens)
+{
+	struct transfer_list_entry *te;
+	auth_cache_rec_t *rec;
+	auth_cache_param_t *param;
+	uint32_t size, old_size;
+	int i;
+
+	te = transfer_list_find(auth_cache_tl, TL_TAG_TFA_AUTH_CACHE);
+	if (te == NULL) {
+		return;
+	}
+
+	size = sizeof(*rec);
+	for (i = 0 ; i < COT_MAX_VERIFIED_PARAMS ; i++) {
+		if (img_desc->authenticated_data[i].type_desc != NULL) {
+			size += sizeof(*param) +
+				round_up(lens[i], AUTH_CACHE_ALIGN);
+		}
+	}
+
+	old_size = te->data_size;
+	if (!transfer_list_set_data_size(auth_cache_tl, te, old_size + size)) {
+		VERBOSE("Verified certificate cache is full\n");
+		return;
+	}
+
+	rec = (auth_cache_rec_t *)((uintptr_t)transfer_list_entry_data(te) +
+				   old_size);
+	rec->img_id = img_desc->img_id;
+	rec->size = size;
+	memcpy(rec->digest, digest, AUTH_CACHE_DIGEST_LEN);
+
+	param = (auth_cache_param_t *)(rec + 1);
+	for (i = 0 ; i < COT_MAX_VERIFIED_PARAMS ; i++) {
+		if (img_desc->authenticated_data[i].type_desc == NULL) {
+			continue;
+		}
+
+		param->idx = (uint32_t)i;
+		param->len = lens[i];
+		memcpy(param + 1, img_desc->authenticated_data[i].data.ptr,
+		       lens[i]);
+		param = (auth_cache_param_t *)((uintptr_t)(param + 1) +
+				round_up(lens[i], AUTH_CACHE_ALIGN));
+	}
+
+	transfer_list_update_checksum(auth_cache_tl);
+}
+#endif /* AUTH_VERIFIED_CACHE */
+
 /*
  * Authenticate a certificate/image
  *
@@ -411,10 +617,33 @@ int auth_mod_verify_img(unsigned int img_id,
 	bool need_nv_ctr_upgrade = false;
 	bool sig_auth_done = false;
 	const auth_method_param_nv_ctr_t *nv_ctr_param = NULL;
+#if AUTH_VERIFIED_CACHE
+	unsigned char digest[CRYPTO_MD_MAX_SIZE];
+	unsigned int lens[COT_MAX_VERIFIED_PARAMS] = { 0 };
+	bool cacheable = false;
+#endif
 
 	/* Get the image descriptor from the chain of trust */
 	img_desc = FCONF_GET_PROPERTY(tbbr, cot, img_id);
 
+#if AUTH_VERIFIED_CACHE
+	/*
+	 * A certificate verified before, by this or an earlier boot stage, only
+	 * needs its digest to be compared with the cached one.
+	 */
+	if ((auth_cache_tl != NULL) && (img_desc->img_type == IMG_CERT) &&
+	    (img_desc->authenticated_data != NULL) &&
+	    (crypto_mod_calc_hash(CRYPTO_MD_SHA256, img_ptr, img_len,
+				  digest) == 0)) {
+		if (auth_cache_lookup(img_desc, digest) == 0) {
+			auth_img_flags[img_desc->img_id] |=
+				IMG_FLAG_AUTHENTICATED;
+			return 0;
+		}
+		cacheable = true;
+	}
+#endif /* AUTH_VERIFIED_CACHE */
+
 	/* Ask the parser to check the image integrity */
 	rc = img_parser_check_integrity(img_desc->img_type, img_ptr, img_len);
 	return_if_error(rc);
@@ -484,6 +713,9 @@ int auth_mod_verify_img(unsigned int img_id,
 			/* Copy the parameter for later use */
 			memcpy((void *)img_desc->authenticated_data[i].data.ptr,
 					(void *)param_ptr, param_len);
+#if AUTH_VERIFIED_CACHE
+			lens[i] = param_len;
+#endif
 
 			/*
 			 * If this is a public key then measure and publicise
@@ -502,6 +734,12 @@ int auth_mod_verify_img(unsigned int img_id,
 		}
 	}
 
+#if AUTH_VERIFIED_CACHE
+	if (cacheable) {
+		auth_cache_add(img_desc, digest, lens);
+	}
+#endif
+
 	/* Mark image as authenticated */
 	auth_img_flags[img_desc->img_id] |= IMG_FLAG_AUTHENTICATED;
 
@@ -156,6 +156,48 @@ int crypto_mod_convert_pk(void *full_pk_ptr, unsigned int full_pk_len,
 	return 0;
 }
 
+#if HASH_ON_LOAD
+/*
+ * Hash data in chunks while it is loaded
+ *
+ * The digests computed between crypto_mod_load_hash_start() and
+ * crypto_mod_load_hash_finish() are reused to verify or calculate the hash of
+ * the same data, until crypto_mod_load_hash_clear() is called. The caller must
+ * call crypto_mod_load_hash_clear() before the data is modified or released.
+ */
+int crypto_mod_load_hash_start(void)
+{
+	if (crypto_lib_desc.load_hash == NULL) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	return crypto_lib_desc.load_hash->start();
+}
+
+int crypto_mod_load_hash_update(void *data_ptr, unsigned int data_len)
+{
+	assert(crypto_lib_desc.load_hash != NULL);
+	assert(data_ptr != NULL);
+
+	return crypto_lib_desc.load_hash->update(data_ptr, data_len);
+}
+
+int crypto_mod_load_hash_finish(void *data_ptr, unsigned int data_len)
+{
+	assert(crypto_lib_desc.load_hash != NULL);
+	assert(data_ptr != NULL);
+
+	return crypto_lib_desc.load_hash->finish(data_ptr, data_len);
+}
+
+void crypto_mod_load_hash_clear(void)
+{
+	if (crypto_lib_desc.load_hash != NULL) {
+		crypto_lib_desc.load_hash->clear();
+	}
+}
+#endif /* HASH_ON_LOAD */
+
 /*
  * Authenticated decryption of data
  *
@@ -187,3 +229,57 @@ int crypto_mod_auth_decrypt(enum crypto_dec_algo dec_algo, void *data_ptr,
 					    key_len, key_flags, iv, iv_len, tag,
 					    tag_len);
 }
+
+/*
+ * Authenticated decryption of data in chunks
+ *
+ * The data is decrypted in place by crypto_mod_auth_decrypt_update(), in
+ * the order of the chunks, and is only authenticated once
+ * crypto_mod_auth_decrypt_finish() has checked the tag. An operation that
+ * will not be finished must be discarded with crypto_mod_auth_decrypt_abort().
+ *
+ * crypto_mod_auth_decrypt_start() fails if the crypto library does not support
+ * decryption in chunks, in which case crypto_mod_auth_decrypt() must be used.
+ */
+int crypto_mod_auth_decrypt_start(enum crypto_dec_algo dec_algo,
+				  const void *key, unsigned int key_len,
+				  unsigned int key_flags, const void *iv,
+				  unsigned int iv_len)
+{
+	assert(key != NULL);
+	assert(key_len != 0U);
+	assert(iv != NULL);
+	assert((iv_len != 0U) && (iv_len <= CRYPTO_MAX_IV_SIZE));
+
+	if (crypto_lib_desc.auth_decrypt_stream == NULL) {
+		return CRYPTO_ERR_DECRYPTION;
+	}
+
+	return crypto_lib_desc.auth_decrypt_stream->start(dec_algo, key,
+							  key_len, key_flags,
+							  iv, iv_len);
+}
+
+int crypto_mod_auth_decrypt_update(void *data_ptr, size_t len)
+{
+	assert(crypto_lib_desc.auth_decrypt_stream != NULL);
+	assert(data_ptr != NULL);
+
+	return crypto_lib_desc.auth_decrypt_stream->update(data_ptr, len);
+}
+
+int crypto_mod_auth_decrypt_finish(const void *tag, unsigned int tag_len)
+{
+	assert(crypto_lib_desc.auth_decrypt_stream != NULL);
+	assert(tag != NULL);
+	assert((tag_len != 0U) && (tag_len <= CRYPTO_MAX_TAG_SIZE));
+
+	return crypto_lib_desc.auth_decrypt_stream->finish(tag, tag_len);
+}
+
+void crypto_mod_auth_decrypt_abort(void)
+{
+	if (crypto_lib_desc.auth_decrypt_stream != NULL) {
+		crypto_lib_desc.auth_decrypt_stream->abort();
+	}
+}
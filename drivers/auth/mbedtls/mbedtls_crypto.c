@@ -6,6 +6,7 @@
 
 #include <assert.h>
 #include <stddef.h>
+#include <stdbool.h>
 #include <string.h>
 
 /* mbed TLS headers */
@@ -63,6 +64,168 @@ static void init(void)
 	mbedtls_init();
 }
 
+#if HASH_ON_LOAD
+/*
+ * Hashing of data while it is loaded. The data is hashed with every algorithm
+ * that has been used so far to verify or calculate a hash, starting with the
+ * algorithm of the chain of trust, so that verify_hash() and calc_hash() can
+ * reuse the digests instead of reading the data again.
+ */
+#define LOAD_HASH_ALG_NUM	((unsigned int)CRYPTO_MD_SHA512 + 1U)
+
+static const mbedtls_md_type_t load_hash_md[LOAD_HASH_ALG_NUM] = {
+	[CRYPTO_MD_SHA256] = MBEDTLS_MD_SHA256,
+	[CRYPTO_MD_SHA384] = MBEDTLS_MD_SHA384,
+	[CRYPTO_MD_SHA512] = MBEDTLS_MD_SHA512,
+};
+
+static struct {
+	unsigned int algs;	/* Algorithms to hash loaded data with */
+	unsigned int started;	/* Algorithms with a context in use */
+	unsigned int valid;	/* Algorithms with a digest of the data */
+	uintptr_t data_ptr;
+	unsigned int data_len;
+	mbedtls_md_context_t ctx[LOAD_HASH_ALG_NUM];
+	unsigned char digest[LOAD_HASH_ALG_NUM][MBEDTLS_MD_MAX_SIZE];
+} load_hash = {
+#if TF_MBEDTLS_HASH_ALG_ID == TF_MBEDTLS_SHA384
+	.algs = 1U << CRYPTO_MD_SHA384,
+#elif TF_MBEDTLS_HASH_ALG_ID == TF_MBEDTLS_SHA512
+	.algs = 1U << CRYPTO_MD_SHA512,
+#else
+	.algs = 1U << CRYPTO_MD_SHA256,
+#endif
+};
+
+static void load_hash_clear(void)
+{
+	unsigned int i;
+
+	for (i = 0U; i < LOAD_HASH_ALG_NUM; i++) {
+		if ((load_hash.started & (1U << i)) != 0U) {
+			mbedtls_md_free(&load_hash.ctx[i]);
+		}
+	}
+
+	load_hash.started = 0U;
+	load_hash.valid = 0U;
+}
+
+static int load_hash_start(void)
+{
+	const mbedtls_md_info_t *md_info;
+	mbedtls_md_context_t *ctx;
+	unsigned int i;
+
+	load_hash_clear();
+
+	for (i = 0U; i < LOAD_HASH_ALG_NUM; i++) {
+		md_info = mbedtls_md_info_from_type(load_hash_md[i]);
+		if (((load_hash.algs & (1U << i)) == 0U) || (md_info == NULL)) {
+			continue;
+		}
+
+		ctx = &load_hash.ctx[i];
+		mbedtls_md_init(ctx);
+		if ((mbedtls_md_setup(ctx, md_info, 0) != 0) ||
+		    (mbedtls_md_starts(ctx) != 0)) {
+			mbedtls_md_free(ctx);
+			continue;
+		}
+
+		load_hash.started |= 1U << i;
+	}
+
+	return (load_hash.started != 0U) ? CRYPTO_SUCCESS : CRYPTO_ERR_HASH;
+}
+
+static int load_hash_update(void *data_ptr, unsigned int data_len)
+{
+	unsigned int i;
+
+	for (i = 0U; i < LOAD_HASH_ALG_NUM; i++) {
+		if (((load_hash.started & (1U << i)) != 0U) &&
+		    (mbedtls_md_update(&load_hash.ctx[i], data_ptr,
+				       data_len) != 0)) {
+			load_hash_clear();
+			return CRYPTO_ERR_HASH;
+		}
+	}
+
+	return CRYPTO_SUCCESS;
+}
+
+static int load_hash_finish(void *data_ptr, unsigned int data_len)
+{
+	unsigned int i;
+	int rc = CRYPTO_SUCCESS;
+
+	for (i = 0U; i < LOAD_HASH_ALG_NUM; i++) {
+		if ((load_hash.started & (1U << i)) == 0U) {
+			continue;
+		}
+
+		if (mbedtls_md_finish(&load_hash.ctx[i],
+				      load_hash.digest[i]) == 0) {
+			load_hash.valid |= 1U << i;
+		} else {
+			rc = CRYPTO_ERR_HASH;
+		}
+
+		mbedtls_md_free(&load_hash.ctx[i]);
+	}
+
+	load_hash.started = 0U;
+	load_hash.data_ptr = (uintptr_t)data_ptr;
+	load_hash.data_len = data_len;
+
+	return rc;
+}
+
+static const crypto_load_hash_t load_hash_ops = {
+	.start = load_hash_start,
+	.update = load_hash_update,
+	.finish = load_hash_finish,
+	.clear = load_hash_clear,
+};
+
+#define LIB_LOAD_HASH		(&load_hash_ops)
+#else
+#define LIB_LOAD_HASH		NULL
+#endif /* HASH_ON_LOAD */
+
+/*
+ * Calculate the hash of data, reusing the digest computed while the data was
+ * loaded if there is one.
+ */
+static int hash_data(const mbedtls_md_info_t *md_info, void *data_ptr,
+		     unsigned int data_len, unsigned char *output)
+{
+#if HASH_ON_LOAD
+	mbedtls_md_type_t md_alg = mbedtls_md_get_type(md_info);
+	unsigned int i;
+
+	for (i = 0U; i < LOAD_HASH_ALG_NUM; i++) {
+		if (load_hash_md[i] != md_alg) {
+			continue;
+		}
+
+		/* Also hash the next loaded data with this algorithm */
+		load_hash.algs |= 1U << i;
+
+		if (((load_hash.valid & (1U << i)) != 0U) &&
+		    (load_hash.data_ptr == (uintptr_t)data_ptr) &&
+		    (load_hash.data_len == data_len)) {
+			memcpy(output, load_hash.digest[i],
+			       mbedtls_md_get_size(md_info));
+			return 0;
+		}
+	}
+#endif /* HASH_ON_LOAD */
+
+	return mbedtls_md(md_info, data_ptr, data_len, output);
+}
+
 #if CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_ONLY || \
 CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_AND_HASH_CALC
 /*
@@ -216,7 +379,7 @@ static int verify_hash(void *data_ptr, unsigned int data_len,
 
 	/* Calculate the hash of the data */
 	p = (unsigned char *)data_ptr;
-	rc = mbedtls_md(md_info, p, data_len, data_hash);
+	rc = hash_data(md_info, p, data_len, data_hash);
 	if (rc != 0) {
 		return CRYPTO_ERR_HASH;
 	}
@@ -274,7 +437,7 @@ static int calc_hash(enum crypto_md_algo md_algo, void *data_ptr,
 	 * 'output' hash buffer pointer considering its size is always
 	 * bigger than or equal to MBEDTLS_MD_MAX_SIZE.
 	 */
-	return mbedtls_md(md_info, data_ptr, data_len, output);
+	return hash_data(md_info, data_ptr, data_len, output);
 }
 #endif /* CRYPTO_SUPPORT == CRYPTO_HASH_CALC_ONLY || \
 	  CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_AND_HASH_CALC */
@@ -286,50 +449,84 @@ static int calc_hash(enum crypto_md_algo md_algo, void *data_ptr,
  */
 #define DEC_OP_BUF_SIZE		128
 
-static int aes_gcm_decrypt(void *data_ptr, size_t len, const void *key,
-			   unsigned int key_len, const void *iv,
-			   unsigned int iv_len, const void *tag,
-			   unsigned int tag_len)
+/* Context of the authenticated decryption in progress */
+static mbedtls_gcm_context dec_ctx;
+static bool dec_started;
+
+static void auth_decrypt_abort(void)
 {
-	mbedtls_gcm_context ctx;
-	mbedtls_cipher_id_t cipher = MBEDTLS_CIPHER_ID_AES;
-	unsigned char buf[DEC_OP_BUF_SIZE];
-	unsigned char tag_buf[CRYPTO_MAX_TAG_SIZE];
-	unsigned char *pt = data_ptr;
-	size_t dec_len;
-	int diff, i, rc;
-	size_t output_length __unused;
+	if (dec_started) {
+		/* This also wipes the expanded key */
+		mbedtls_gcm_free(&dec_ctx);
+		dec_started = false;
+	}
+}
 
-	mbedtls_gcm_init(&ctx);
+static int auth_decrypt_start(enum crypto_dec_algo dec_algo, const void *key,
+			      unsigned int key_len, unsigned int key_flags,
+			      const void *iv, unsigned int iv_len)
+{
+	int rc;
 
-	rc = mbedtls_gcm_setkey(&ctx, cipher, key, key_len * 8);
-	if (rc != 0) {
-		rc = CRYPTO_ERR_DECRYPTION;
-		goto exit_gcm;
+	assert((key_flags & ENC_KEY_IS_IDENTIFIER) == 0);
+
+	auth_decrypt_abort();
+
+	if (dec_algo != CRYPTO_GCM_DECRYPT) {
+		return CRYPTO_ERR_DECRYPTION;
 	}
 
+	mbedtls_gcm_init(&dec_ctx);
+	dec_started = true;
+
+	rc = mbedtls_gcm_setkey(&dec_ctx, MBEDTLS_CIPHER_ID_AES, key,
+				key_len * 8);
+	if (rc == 0) {
 #if (MBEDTLS_VERSION_MAJOR < 3)
-	rc = mbedtls_gcm_starts(&ctx, MBEDTLS_GCM_DECRYPT, iv, iv_len, NULL, 0);
+		rc = mbedtls_gcm_starts(&dec_ctx, MBEDTLS_GCM_DECRYPT, iv,
+					iv_len, NULL, 0);
 #else
-	rc = mbedtls_gcm_starts(&ctx, MBEDTLS_GCM_DECRYPT, iv, iv_len);
+		rc = mbedtls_gcm_starts(&dec_ctx, MBEDTLS_GCM_DECRYPT, iv,
+					iv_len);
 #endif
+	}
+
 	if (rc != 0) {
-		rc = CRYPTO_ERR_DECRYPTION;
-		goto exit_gcm;
+		auth_decrypt_abort();
+		return CRYPTO_ERR_DECRYPTION;
+	}
+
+	return CRYPTO_SUCCESS;
+}
+
+/*
+ * Decrypt a chunk in place. The size of every chunk but the last one is a
+ * multiple of the AES block size, which Mbed TLS 2.x requires.
+ */
+static int auth_decrypt_update(void *data_ptr, size_t len)
+{
+	unsigned char buf[DEC_OP_BUF_SIZE];
+	unsigned char *pt = data_ptr;
+	size_t dec_len;
+	int rc;
+	size_t output_length __unused;
+
+	if (!dec_started) {
+		return CRYPTO_ERR_DECRYPTION;
 	}
 
 	while (len > 0) {
 		dec_len = MIN(sizeof(buf), len);
 
 #if (MBEDTLS_VERSION_MAJOR < 3)
-		rc = mbedtls_gcm_update(&ctx, dec_len, pt, buf);
+		rc = mbedtls_gcm_update(&dec_ctx, dec_len, pt, buf);
 #else
-		rc = mbedtls_gcm_update(&ctx, pt, dec_len, buf, sizeof(buf), &output_length);
+		rc = mbedtls_gcm_update(&dec_ctx, pt, dec_len, buf, sizeof(buf), &output_length);
 #endif
 
 		if (rc != 0) {
-			rc = CRYPTO_ERR_DECRYPTION;
-			goto exit_gcm;
+			auth_decrypt_abort();
+			return CRYPTO_ERR_DECRYPTION;
 		}
 
 		memcpy(pt, buf, dec_len);
@@ -337,34 +534,51 @@ static int aes_gcm_decrypt(void *data_ptr, size_t len, const void *key,
 		len -= dec_len;
 	}
 
+	return CRYPTO_SUCCESS;
+}
+
+static int auth_decrypt_finish(const void *tag, unsigned int tag_len)
+{
+	unsigned char tag_buf[CRYPTO_MAX_TAG_SIZE];
+	unsigned int i;
+	int diff, rc;
+	size_t output_length __unused;
+
+	if (!dec_started) {
+		return CRYPTO_ERR_DECRYPTION;
+	}
+
 #if (MBEDTLS_VERSION_MAJOR < 3)
-	rc = mbedtls_gcm_finish(&ctx, tag_buf, sizeof(tag_buf));
+	rc = mbedtls_gcm_finish(&dec_ctx, tag_buf, sizeof(tag_buf));
 #else
-	rc = mbedtls_gcm_finish(&ctx, NULL, 0, &output_length, tag_buf, sizeof(tag_buf));
+	rc = mbedtls_gcm_finish(&dec_ctx, NULL, 0, &output_length, tag_buf, sizeof(tag_buf));
 #endif
 
+	auth_decrypt_abort();
+
 	if (rc != 0) {
-		rc = CRYPTO_ERR_DECRYPTION;
-		goto exit_gcm;
+		return CRYPTO_ERR_DECRYPTION;
 	}
 
 	/* Check tag in "constant-time" */
-	for (diff = 0, i = 0; i < tag_len; i++)
+	for (diff = 0, i = 0U; i < tag_len; i++)
 		diff |= ((const unsigned char *)tag)[i] ^ tag_buf[i];
 
 	if (diff != 0) {
-		rc = CRYPTO_ERR_DECRYPTION;
-		goto exit_gcm;
+		return CRYPTO_ERR_DECRYPTION;
 	}
 
 	/* GCM decryption success */
-	rc = CRYPTO_SUCCESS;
-
-exit_gcm:
-	mbedtls_gcm_free(&ctx);
-	return rc;
+	return CRYPTO_SUCCESS;
 }
 
+static const crypto_auth_decrypt_stream_t auth_decrypt_stream_ops = {
+	.start = auth_decrypt_start,
+	.update = auth_decrypt_update,
+	.finish = auth_decrypt_finish,
+	.abort = auth_decrypt_abort,
+};
+
 /*
  * Authenticated decryption of an image
  */
@@ -376,20 +590,15 @@ static int auth_decrypt(enum crypto_dec_algo dec_algo, void *data_ptr,
 {
 	int rc;
 
-	assert((key_flags & ENC_KEY_IS_IDENTIFIER) == 0);
-
-	switch (dec_algo) {
-	case CRYPTO_GCM_DECRYPT:
-		rc = aes_gcm_decrypt(data_ptr, len, key, key_len, iv, iv_len,
-				     tag, tag_len);
-		if (rc != 0)
-			return rc;
-		break;
-	default:
-		return CRYPTO_ERR_DECRYPTION;
+	rc = auth_decrypt_start(dec_algo, key, key_len, key_flags, iv, iv_len);
+	if (rc == CRYPTO_SUCCESS) {
+		rc = auth_decrypt_update(data_ptr, len);
+	}
+	if (rc == CRYPTO_SUCCESS) {
+		rc = auth_decrypt_finish(tag, tag_len);
 	}
 
-	return CRYPTO_SUCCESS;
+	return rc;
 }
 #endif /* TF_MBEDTLS_USE_AES_GCM */
 
@@ -398,20 +607,36 @@ static int auth_decrypt(enum crypto_dec_algo dec_algo, void *data_ptr,
  */
 #if CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_AND_HASH_CALC
 #if TF_MBEDTLS_USE_AES_GCM
-REGISTER_CRYPTO_LIB(LIB_NAME, init, verify_signature, verify_hash, calc_hash,
-		    auth_decrypt, NULL);
+REGISTER_CRYPTO_LIB(LIB_NAME, init,
+		    .verify_signature = verify_signature,
+		    .verify_hash = verify_hash,
+		    .calc_hash = calc_hash,
+		    .auth_decrypt = auth_decrypt,
+		    .load_hash = LIB_LOAD_HASH,
+		    .auth_decrypt_stream = &auth_decrypt_stream_ops);
 #else
-REGISTER_CRYPTO_LIB(LIB_NAME, init, verify_signature, verify_hash, calc_hash,
-		    NULL, NULL);
+REGISTER_CRYPTO_LIB(LIB_NAME, init,
+		    .verify_signature = verify_signature,
+		    .verify_hash = verify_hash,
+		    .calc_hash = calc_hash,
+		    .load_hash = LIB_LOAD_HASH);
 #endif
 #elif CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_ONLY
 #if TF_MBEDTLS_USE_AES_GCM
-REGISTER_CRYPTO_LIB(LIB_NAME, init, verify_signature, verify_hash, NULL,
-		    auth_decrypt, NULL);
+REGISTER_CRYPTO_LIB(LIB_NAME, init,
+		    .verify_signature = verify_signature,
+		    .verify_hash = verify_hash,
+		    .auth_decrypt = auth_decrypt,
+		    .load_hash = LIB_LOAD_HASH,
+		    .auth_decrypt_stream = &auth_decrypt_stream_ops);
 #else
-REGISTER_CRYPTO_LIB(LIB_NAME, init, verify_signature, verify_hash, NULL,
-		    NULL, NULL);
+REGISTER_CRYPTO_LIB(LIB_NAME, init,
+		    .verify_signature = verify_signature,
+		    .verify_hash = verify_hash,
+		    .load_hash = LIB_LOAD_HASH);
 #endif
 #elif CRYPTO_SUPPORT == CRYPTO_HASH_CALC_ONLY
-REGISTER_CRYPTO_LIB(LIB_NAME, init, NULL, NULL, calc_hash, NULL, NULL);
+REGISTER_CRYPTO_LIB(LIB_NAME, init,
+		    .calc_hash = calc_hash,
+		    .load_hash = LIB_LOAD_HASH);
 #endif /* CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_AND_HASH_CALC */
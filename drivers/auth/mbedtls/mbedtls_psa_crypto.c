@@ -480,20 +480,29 @@ static int auth_decrypt(enum crypto_dec_algo dec_algo, void *data_ptr,
  */
 #if CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_AND_HASH_CALC
 #if TF_MBEDTLS_USE_AES_GCM
-REGISTER_CRYPTO_LIB(LIB_NAME, init, verify_signature, verify_hash, calc_hash,
-		    auth_decrypt, NULL);
+REGISTER_CRYPTO_LIB(LIB_NAME, init,
+		    .verify_signature = verify_signature,
+		    .verify_hash = verify_hash,
+		    .calc_hash = calc_hash,
+		    .auth_decrypt = auth_decrypt);
 #else
-REGISTER_CRYPTO_LIB(LIB_NAME, init, verify_signature, verify_hash, calc_hash,
-		    NULL, NULL);
+REGISTER_CRYPTO_LIB(LIB_NAME, init,
+		    .verify_signature = verify_signature,
+		    .verify_hash = verify_hash,
+		    .calc_hash = calc_hash);
 #endif
 #elif CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_ONLY
 #if TF_MBEDTLS_USE_AES_GCM
-REGISTER_CRYPTO_LIB(LIB_NAME, init, verify_signature, verify_hash, NULL,
-		    auth_decrypt, NULL);
+REGISTER_CRYPTO_LIB(LIB_NAME, init,
+		    .verify_signature = verify_signature,
+		    .verify_hash = verify_hash,
+		    .auth_decrypt = auth_decrypt);
 #else
-REGISTER_CRYPTO_LIB(LIB_NAME, init, verify_signature, verify_hash, NULL,
-		    NULL, NULL);
+REGISTER_CRYPTO_LIB(LIB_NAME, init,
+		    .verify_signature = verify_signature,
+		    .verify_hash = verify_hash);
 #endif
 #elif CRYPTO_SUPPORT == CRYPTO_HASH_CALC_ONLY
-REGISTER_CRYPTO_LIB(LIB_NAME, init, NULL, NULL, calc_hash, NULL, NULL);
+REGISTER_CRYPTO_LIB(LIB_NAME, init,
+		    .calc_hash = calc_hash);
 #endif /* CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_AND_HASH_CALC */
@@ -5,11 +5,54 @@
  */
 
 #include <assert.h>
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdlib.h>
 
 #include <drivers/console.h>
 
+/* Only BL31 defers its runtime output, the other images write it directly. */
+#if CONSOLE_DEFERRED_LOG && defined(IMAGE_BL31)
+#define CONSOLE_LOG_DEFERRED	1
+#else
+#define CONSOLE_LOG_DEFERRED	0
+#endif
+
+#if CONSOLE_LOG_DEFERRED
+#include <arch_helpers.h>
+#include <lib/cassert.h>
+#include <lib/spinlock.h>
+#include <platform_def.h>
+
+#ifndef PLAT_CONSOLE_LOG_BUF_SIZE
+#define PLAT_CONSOLE_LOG_BUF_SIZE	4096U
+#endif
+
+/*
+ * Characters moved out of the buffer at a time to be written out. It is also
+ * the most that a CPU writes out when the buffer is full or when it enters
+ * idle, which bounds the time it spends writing to the consoles then.
+ */
+#define CONSOLE_LOG_CHUNK_SIZE		64U
+
+CASSERT(IS_POWER_OF_TWO(PLAT_CONSOLE_LOG_BUF_SIZE),
+	assert_console_log_buf_size_not_power_of_two);
+
+/*
+ * Characters written in the runtime state, waiting to be written out. `head`
+ * and `tail` count the characters ever written to and removed from the
+ * buffer, so the buffer is full when they are PLAT_CONSOLE_LOG_BUF_SIZE apart.
+ * `console_log_lock` protects them and is only held to copy characters.
+ * `console_log_drain_lock` is held by the one CPU writing the buffer out to the
+ * consoles, so that the output stays in order.
+ */
+static spinlock_t console_log_lock;
+static spinlock_t console_log_drain_lock;
+static char console_log_buf[PLAT_CONSOLE_LOG_BUF_SIZE];
+static size_t console_log_head;
+static size_t console_log_tail;
+#endif /* CONSOLE_LOG_DEFERRED */
+
 console_t *console_list;
 static uint8_t console_state = CONSOLE_FLAG_BOOT;
 
@@ -62,6 +105,13 @@ int console_is_registered(console_t *to_find)
 
 void console_switch_state(unsigned int new_state)
 {
+#if CONSOLE_LOG_DEFERRED
+	/* Keep the output in order when leaving the runtime state. */
+	if ((console_state == CONSOLE_FLAG_RUNTIME) &&
+	    (new_state != CONSOLE_FLAG_RUNTIME)) {
+		console_log_drain();
+	}
+#endif
 	console_state = new_state;
 }
 
@@ -86,7 +136,7 @@ static int do_putc(int c, console_t *console)
 	return console->putc(c, console);
 }
 
-int console_putc(int c)
+static int do_console_putc(int c)
 {
 	int err = ERROR_NO_VALID_CONSOLE;
 	console_t *console;
@@ -100,6 +150,160 @@ int console_putc(int c)
 	return err;
 }
 
+#if CONSOLE_LOG_DEFERRED
+/*
+ * The buffer is protected by a spinlock, which cannot be used with the data
+ * cache disabled, e.g. late in a CPU power down. Output produced at that time
+ * is written out directly.
+ */
+static bool console_log_usable(void)
+{
+	return (read_sctlr_el3() & SCTLR_C_BIT) != 0U;
+}
+
+/* Remove up to `len` characters from the buffer. The lock must be held. */
+static size_t console_log_remove(char *buf, size_t len)
+{
+	size_t i;
+
+	for (i = 0U; (i < len) && (console_log_tail != console_log_head); i++) {
+		buf[i] = console_log_buf[console_log_tail &
+				(PLAT_CONSOLE_LOG_BUF_SIZE - 1U)];
+		console_log_tail++;
+	}
+
+	return i;
+}
+
+/*
+ * Write out up to `max` characters of the buffer, one chunk at a time, without
+ * holding the buffer lock while the consoles are written, so that other CPUs
+ * can keep buffering their output. Returns false without waiting if another CPU
+ * is already doing it. With `nowait`, it also stops rather than wait for the
+ * buffer lock, so that it never spins.
+ */
+static bool console_log_try_drain(size_t max, bool nowait)
+{
+	char chunk[CONSOLE_LOG_CHUNK_SIZE];
+	size_t i, len;
+
+	if (!spin_trylock(&console_log_drain_lock)) {
+		return false;
+	}
+
+	do {
+		if (nowait) {
+			if (!spin_trylock(&console_log_lock)) {
+				break;
+			}
+		} else {
+			spin_lock(&console_log_lock);
+		}
+		len = console_log_remove(chunk, MIN(sizeof(chunk), max));
+		spin_unlock(&console_log_lock);
+
+		for (i = 0U; i < len; i++) {
+			(void)do_console_putc(chunk[i]);
+		}
+		max -= len;
+	} while ((len != 0U) && (max != 0U));
+
+	spin_unlock(&console_log_drain_lock);
+
+	return true;
+}
+
+static int console_log_putc(int c)
+{
+	for (;;) {
+		spin_lock(&console_log_lock);
+
+		if ((console_log_head - console_log_tail) <
+		    PLAT_CONSOLE_LOG_BUF_SIZE) {
+			console_log_buf[console_log_head &
+					(PLAT_CONSOLE_LOG_BUF_SIZE - 1U)] =
+				(char)c;
+			console_log_head++;
+			spin_unlock(&console_log_lock);
+			return 0;
+		}
+
+		spin_unlock(&console_log_lock);
+
+		/*
+		 * The buffer is full. Make room by writing out one chunk, or
+		 * let the CPU already writing it out make room. Either way, a
+		 * CPU adding a character to a full buffer waits for at most
+		 * CONSOLE_LOG_CHUNK_SIZE characters to be written to the
+		 * consoles, rather than for the whole buffer.
+		 */
+		(void)console_log_try_drain(CONSOLE_LOG_CHUNK_SIZE, false);
+	}
+}
+
+void console_log_drain(void)
+{
+	if (!console_log_usable()) {
+		return;
+	}
+
+	(void)console_log_try_drain(SIZE_MAX, false);
+}
+
+void console_log_drain_idle(void)
+{
+	if (!console_log_usable()) {
+		return;
+	}
+
+	(void)console_log_try_drain(CONSOLE_LOG_CHUNK_SIZE, true);
+}
+
+/*
+ * Write out the buffer on a flush, which panic() also does. The buffer lock is
+ * only held to copy characters, so it is never held by a CPU that panics. The
+ * drain lock may be, if this CPU panicked while writing out the buffer, so it
+ * is not waited for: the characters left in the buffer are then written out
+ * without removing them, and some of them may be written twice.
+ */
+static void console_log_flush(void)
+{
+	size_t i;
+
+	if (!console_log_usable() || console_log_try_drain(SIZE_MAX, false)) {
+		return;
+	}
+
+	for (i = console_log_tail; i != console_log_head; i++) {
+		(void)do_console_putc(console_log_buf[i &
+				(PLAT_CONSOLE_LOG_BUF_SIZE - 1U)]);
+	}
+}
+
+size_t console_log_read(char *buf, size_t len)
+{
+	size_t ret;
+
+	assert((buf != NULL) || (len == 0U));
+
+	spin_lock(&console_log_lock);
+	ret = console_log_remove(buf, len);
+	spin_unlock(&console_log_lock);
+
+	return ret;
+}
+#endif /* CONSOLE_LOG_DEFERRED */
+
+int console_putc(int c)
+{
+#if CONSOLE_LOG_DEFERRED
+	if ((console_state == CONSOLE_FLAG_RUNTIME) && console_log_usable()) {
+		return console_log_putc(c);
+	}
+#endif
+	return do_console_putc(c);
+}
+
 int putchar(int c)
 {
 	if (console_putc(c) == 0)
@@ -132,6 +336,10 @@ void console_flush(void)
 {
 	console_t *console;
 
+#if CONSOLE_LOG_DEFERRED
+	console_log_flush();
+#endif
+
 	for (console = console_list; console != NULL; console = console->next)
 		if ((console->flags & console_state) && (console->flush != NULL)) {
 			console->flush(console);
@@ -6,6 +6,7 @@
 
 #include <assert.h>
 #include <errno.h>
+#include <stdint.h>
 #include <string.h>
 
 #include <platform_def.h>
@@ -14,6 +15,7 @@
 #include <drivers/io/io_block.h>
 #include <drivers/io/io_driver.h>
 #include <drivers/io/io_storage.h>
+#include <lib/cassert.h>
 #include <lib/utils.h>
 
 typedef struct {
@@ -25,6 +27,52 @@ typedef struct {
 
 #define is_power_of_2(x)	(((x) != 0U) && (((x) & ((x) - 1U)) == 0U))
 
+/*
+ * Optional read cache between the block driver and the low level ops->read
+ * callback. IO_BLOCK_CACHE_LINES lines of IO_BLOCK_CACHE_LINE_SIZE bytes are
+ * shared by all block devices and replaced in LRU order. Small reads (FIP
+ * ToC, GPT header and entries, image headers) are served from the cache,
+ * reads larger than a line bypass it. When a miss follows a miss on the
+ * previous line, IO_BLOCK_CACHE_READAHEAD lines are fetched in one request.
+ */
+#ifndef IO_BLOCK_CACHE_LINES
+#define IO_BLOCK_CACHE_LINES		0
+#endif
+
+#if IO_BLOCK_CACHE_LINES > 0
+#ifndef IO_BLOCK_CACHE_LINE_SIZE
+#define IO_BLOCK_CACHE_LINE_SIZE	4096U
+#endif
+
+#ifndef IO_BLOCK_CACHE_READAHEAD
+#define IO_BLOCK_CACHE_READAHEAD	2U
+#endif
+
+CASSERT(is_power_of_2(IO_BLOCK_CACHE_LINE_SIZE),
+	assert_io_block_cache_line_size_power_of_2);
+CASSERT(IO_BLOCK_CACHE_READAHEAD > 0U, assert_io_block_cache_readahead);
+
+typedef struct {
+	/* Device the line belongs to, NULL if the line is free */
+	const io_block_dev_spec_t	*dev_spec;
+	/* Byte offset of the line in the device */
+	unsigned long long		offset;
+	/* Number of valid bytes in the line */
+	size_t				length;
+	/* Value of cache_tick when the line was last used */
+	unsigned int			last_use;
+	uint8_t				data[IO_BLOCK_CACHE_LINE_SIZE];
+} block_cache_line_t;
+
+static block_cache_line_t cache_lines[IO_BLOCK_CACHE_LINES];
+static unsigned int cache_tick;
+static io_block_cache_stats_t cache_stats;
+
+/* Last line that missed, used to detect sequential accesses */
+static const io_block_dev_spec_t *last_miss_dev;
+static unsigned long long last_miss_offset;
+#endif /* IO_BLOCK_CACHE_LINES > 0 */
+
 io_type_t device_type_block(void);
 
 static int block_open(io_dev_info_t *dev_info, const uintptr_t spec,
@@ -147,6 +195,169 @@ static int block_open(io_dev_info_t *dev_info, const uintptr_t spec,
 	return 0;
 }
 
+#if IO_BLOCK_CACHE_LINES > 0
+static block_cache_line_t *block_cache_find(const io_block_dev_spec_t *dev_spec,
+					    unsigned long long offset)
+{
+	unsigned int i;
+
+	for (i = 0U; i < IO_BLOCK_CACHE_LINES; i++) {
+		if ((cache_lines[i].dev_spec == dev_spec) &&
+		    (cache_lines[i].offset == offset)) {
+			return &cache_lines[i];
+		}
+	}
+	return NULL;
+}
+
+/* Return a free line, or the least recently used one */
+static block_cache_line_t *block_cache_victim(void)
+{
+	block_cache_line_t *victim = &cache_lines[0];
+	unsigned int i;
+
+	for (i = 0U; i < IO_BLOCK_CACHE_LINES; i++) {
+		if (cache_lines[i].dev_spec == NULL) {
+			return &cache_lines[i];
+		}
+		if ((cache_tick - cache_lines[i].last_use) >
+		    (cache_tick - victim->last_use)) {
+			victim = &cache_lines[i];
+		}
+	}
+	return victim;
+}
+
+/* Drop all lines of a device overlapping [start, end) */
+static void block_cache_invalidate(const io_block_dev_spec_t *dev_spec,
+				   unsigned long long start,
+				   unsigned long long end)
+{
+	unsigned int i;
+
+	for (i = 0U; i < IO_BLOCK_CACHE_LINES; i++) {
+		if ((cache_lines[i].dev_spec == dev_spec) &&
+		    (cache_lines[i].offset < end) &&
+		    ((cache_lines[i].offset + IO_BLOCK_CACHE_LINE_SIZE) >
+		     start)) {
+			zeromem(&cache_lines[i], sizeof(cache_lines[i]));
+		}
+	}
+
+	if (last_miss_dev == dev_spec) {
+		last_miss_dev = NULL;
+	}
+}
+
+/*
+ * Read the line at 'offset', and the following lines if the access looks
+ * sequential, through the device buffer and copy them into the cache. At
+ * least 'needed' bytes of the first line must be read. Returns the first
+ * line, or NULL if the low level driver failed.
+ */
+static block_cache_line_t *block_cache_fill(block_dev_state_t *cur,
+					    unsigned long long offset,
+					    size_t needed)
+{
+	const io_block_dev_spec_t *dev_spec = cur->dev_spec;
+	const io_block_spec_t *buf = &(dev_spec->buffer);
+	unsigned long long end = cur->base + cur->size;
+	block_cache_line_t *line;
+	block_cache_line_t *first = NULL;
+	unsigned int nlines = 1U;
+	unsigned int i;
+	size_t request;
+
+	if ((last_miss_dev == dev_spec) &&
+	    ((last_miss_offset + IO_BLOCK_CACHE_LINE_SIZE) == offset)) {
+		nlines = IO_BLOCK_CACHE_READAHEAD;
+	}
+	nlines = MIN(nlines, (unsigned int)IO_BLOCK_CACHE_LINES);
+	nlines = MIN(nlines, (unsigned int)(buf->length /
+					    IO_BLOCK_CACHE_LINE_SIZE));
+
+	/*
+	 * Don't read past the end of the region, except to read its last
+	 * block in full, as the low level driver only reads whole blocks.
+	 */
+	request = (size_t)MIN((unsigned long long)nlines *
+			      IO_BLOCK_CACHE_LINE_SIZE, end - offset);
+	request = (request + (dev_spec->block_size - 1U)) &
+		~(dev_spec->block_size - 1U);
+
+	request = dev_spec->ops.read((int)(offset / dev_spec->block_size),
+				     buf->offset, request);
+	request &= ~(dev_spec->block_size - 1U);
+	cache_stats.misses++;
+	cache_stats.reads++;
+	if (request < needed) {
+		return NULL;
+	}
+
+	last_miss_dev = dev_spec;
+	last_miss_offset = offset;
+
+	for (i = 0U; (i < nlines) &&
+		     (request > (i * IO_BLOCK_CACHE_LINE_SIZE)); i++) {
+		line = block_cache_find(dev_spec, offset);
+		if (line == NULL) {
+			line = block_cache_victim();
+		}
+		line->dev_spec = dev_spec;
+		line->offset = offset;
+		line->length = MIN(request - (i * IO_BLOCK_CACHE_LINE_SIZE),
+				   (size_t)IO_BLOCK_CACHE_LINE_SIZE);
+		line->last_use = ++cache_tick;
+		memcpy(line->data,
+		       (void *)(buf->offset + (i * IO_BLOCK_CACHE_LINE_SIZE)),
+		       line->length);
+		if (first == NULL) {
+			first = line;
+		}
+		offset += IO_BLOCK_CACHE_LINE_SIZE;
+	}
+
+	return first;
+}
+
+/* Serve a read of at most one line's worth of data from the cache */
+static int block_cache_read(block_dev_state_t *cur, uintptr_t buffer,
+			    size_t length)
+{
+	block_cache_line_t *line;
+	unsigned long long pos;
+	unsigned long long line_offset;
+	size_t skip, nbytes;
+	size_t count = 0U;
+
+	while (count < length) {
+		pos = cur->base + cur->file_pos;
+		line_offset = pos & ~((unsigned long long)
+				      IO_BLOCK_CACHE_LINE_SIZE - 1U);
+		skip = (size_t)(pos - line_offset);
+		nbytes = MIN(length - count, IO_BLOCK_CACHE_LINE_SIZE - skip);
+
+		line = block_cache_find(cur->dev_spec, line_offset);
+		if ((line != NULL) && (line->length >= (skip + nbytes))) {
+			cache_stats.hits++;
+			line->last_use = ++cache_tick;
+		} else {
+			line = block_cache_fill(cur, line_offset,
+						skip + nbytes);
+			if (line == NULL) {
+				return -EIO;
+			}
+		}
+
+		memcpy((void *)(buffer + count), &line->data[skip], nbytes);
+		cur->file_pos += nbytes;
+		count += nbytes;
+	}
+
+	return 0;
+}
+#endif /* IO_BLOCK_CACHE_LINES > 0 */
+
 /* parameter offset is relative address at here */
 static int block_seek(io_entity_t *entity, int mode, signed long long offset)
 {
@@ -273,6 +484,17 @@ static int block_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 	       (length > 0U) &&
 	       (ops->read != NULL));
 
+#if IO_BLOCK_CACHE_LINES > 0
+	if (length <= IO_BLOCK_CACHE_LINE_SIZE) {
+		int result = block_cache_read(cur, buffer, length);
+
+		if (result == 0) {
+			*length_read = length;
+		}
+		return result;
+	}
+#endif
+
 	/*
 	 * We don't know the number of bytes that we are going
 	 * to read in every iteration, because it will depend
@@ -315,6 +537,9 @@ static int block_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 				~(block_size - 1U);
 		}
 		request = ops->read(lba, buf->offset, request);
+#if IO_BLOCK_CACHE_LINES > 0
+		cache_stats.reads++;
+#endif
 
 		if (request <= skip) {
 			/*
@@ -386,6 +611,11 @@ static int block_write(io_entity_t *entity, const uintptr_t buffer,
 	       (ops->read != NULL) &&
 	       (ops->write != NULL));
 
+#if IO_BLOCK_CACHE_LINES > 0
+	block_cache_invalidate(cur->dev_spec, cur->base + cur->file_pos,
+			       cur->base + cur->file_pos + length);
+#endif
+
 	/*
 	 * We don't know the number of bytes that we are going
 	 * to write in every iteration, because it will depend
@@ -519,6 +749,10 @@ static int block_dev_open(const uintptr_t dev_spec, io_dev_info_t **dev_info)
 	       (is_power_of_2(block_size) != 0U) &&
 	       ((buffer->offset % block_size) == 0U) &&
 	       ((buffer->length % block_size) == 0U));
+#if IO_BLOCK_CACHE_LINES > 0
+	assert((block_size <= IO_BLOCK_CACHE_LINE_SIZE) &&
+	       (buffer->length >= IO_BLOCK_CACHE_LINE_SIZE));
+#endif
 
 	*dev_info = info;	/* cast away const */
 	(void)block_size;
@@ -528,11 +762,31 @@ static int block_dev_open(const uintptr_t dev_spec, io_dev_info_t **dev_info)
 
 static int block_dev_close(io_dev_info_t *dev_info)
 {
+#if IO_BLOCK_CACHE_LINES > 0
+	block_dev_state_t *cur;
+
+	cur = (block_dev_state_t *)dev_info->info;
+	VERBOSE("io_block cache: %u hits, %u misses, %u reads\n",
+		cache_stats.hits, cache_stats.misses, cache_stats.reads);
+	block_cache_invalidate(cur->dev_spec, 0ULL, ~0ULL);
+#endif
 	return free_dev_info(dev_info);
 }
 
 /* Exported functions */
 
+/* Return the block cache statistics, all zero if the cache is disabled */
+void io_block_get_cache_stats(io_block_cache_stats_t *stats)
+{
+	assert(stats != NULL);
+
+#if IO_BLOCK_CACHE_LINES > 0
+	*stats = cache_stats;
+#else
+	zeromem(stats, sizeof(*stats));
+#endif
+}
+
 /* Register the Block driver with the IO abstraction */
 int register_io_dev_block(const io_dev_connector_t **dev_con)
 {
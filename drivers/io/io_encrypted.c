@@ -18,6 +18,7 @@
 #include <drivers/io/io_driver.h>
 #include <drivers/io/io_encrypted.h>
 #include <drivers/io/io_storage.h>
+#include <lib/cassert.h>
 #include <lib/utils.h>
 #include <plat/common/platform.h>
 #include <tools_share/firmware_encrypted.h>
@@ -30,6 +31,31 @@ static uintptr_t backend_image_spec;
 
 static io_dev_info_t enc_dev_info;
 
+/*
+ * Size of the chunks the encrypted payload is read in. Each chunk is decrypted
+ * right after it is read, while it is still in the data cache. It must be a
+ * multiple of the AES block size.
+ */
+#define ENC_READ_CHUNK_SIZE	U(0x8000)
+
+CASSERT((ENC_READ_CHUNK_SIZE % CRYPTO_DEC_BLOCK_SIZE) == 0U,
+	assert_enc_read_chunk_size_not_block_aligned);
+
+/* State of the decryption of the open file */
+enum enc_file_state {
+	ENC_FILE_IDLE,		/* Header not read yet */
+	ENC_FILE_RUNNING,	/* Payload being decrypted in chunks */
+	ENC_FILE_DONE,		/* Whole payload decrypted and authenticated */
+	ENC_FILE_FAILED,
+};
+
+static struct {
+	enum enc_file_state state;
+	struct fw_enc_hdr header;
+	size_t payload_len;
+	size_t offset;
+} enc_file;
+
 /* Encrypted firmware driver functions */
 static int enc_dev_open(const uintptr_t dev_spec, io_dev_info_t **dev_info);
 static int enc_file_open(io_dev_info_t *dev_info, const uintptr_t spec,
@@ -114,6 +140,7 @@ static int enc_file_open(io_dev_info_t *dev_info, const uintptr_t spec,
 	assert(entity != NULL);
 
 	backend_image_spec = spec;
+	zeromem(&enc_file, sizeof(enc_file));
 
 	result = io_open(backend_dev_handle, backend_image_spec,
 			 &backend_handle);
@@ -150,50 +177,188 @@ static int enc_file_len(io_entity_t *entity, size_t *length)
 	return result;
 }
 
-static int enc_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
-			 size_t *length_read)
+static int enc_read_header(void)
 {
 	int result;
-	struct fw_enc_hdr header;
-	enum fw_enc_status_t fw_enc_status;
-	size_t bytes_read;
-	uint8_t key[ENC_MAX_KEY_SIZE];
-	size_t key_len = sizeof(key);
-	unsigned int key_flags = 0;
-	const io_uuid_spec_t *uuid_spec = (io_uuid_spec_t *)backend_image_spec;
+	size_t length, bytes_read;
+	struct fw_enc_hdr *header = &enc_file.header;
 
-	assert(entity != NULL);
-	assert(length_read != NULL);
+	result = io_size(backend_handle, &length);
+	if ((result != 0) || (length < sizeof(*header))) {
+		WARN("Failed to read blob length (%i)\n", result);
+		return -ENOENT;
+	}
+
+	enc_file.payload_len = length - sizeof(*header);
 
-	result = io_read(backend_handle, (uintptr_t)&header, sizeof(header),
+	result = io_read(backend_handle, (uintptr_t)header, sizeof(*header),
 			 &bytes_read);
-	if (result != 0) {
+	if ((result != 0) || (bytes_read != sizeof(*header))) {
 		WARN("Failed to read encryption header (%i)\n", result);
 		return -ENOENT;
 	}
 
-	if (!is_valid_header(&header)) {
+	if (!is_valid_header(header)) {
 		WARN("Encryption header check failed.\n");
 		return -ENOENT;
 	}
 
 	VERBOSE("Encryption header looks OK.\n");
-	fw_enc_status = header.flags & FW_ENC_STATUS_FLAG_MASK;
 
-	if ((header.iv_len > ENC_MAX_IV_SIZE) ||
-	    (header.tag_len > ENC_MAX_TAG_SIZE)) {
+	if ((header->iv_len > ENC_MAX_IV_SIZE) ||
+	    (header->tag_len > ENC_MAX_TAG_SIZE)) {
 		WARN("Incorrect IV or tag length\n");
 		return -ENOENT;
 	}
 
-	result = io_read(backend_handle, buffer, length, &bytes_read);
+	return 0;
+}
+
+/*
+ * Read and decrypt the next chunks of the payload. The tag is checked by the
+ * read reaching the end of the payload: the data returned by the previous
+ * reads must not be trusted until then.
+ *
+ * The crypto library is only given whole AES blocks before the end of the
+ * payload, so a read that does not reach it is shortened to a multiple of
+ * the block size, and the blocks split by short reads of the backend are
+ * only decrypted once they have been read in full.
+ */
+static int enc_read_chunks(uintptr_t buffer, size_t length,
+			   size_t *length_read)
+{
+	int result = 0;
+	size_t offset, end, decrypted = 0U, chunk, chunk_read = 0U;
+
+	assert((enc_file.offset % CRYPTO_DEC_BLOCK_SIZE) == 0U);
+
+	if (length < (enc_file.payload_len - enc_file.offset)) {
+		length = round_down(length, CRYPTO_DEC_BLOCK_SIZE);
+		if (length == 0U) {
+			WARN("Encrypted payload must be read in blocks of %u bytes\n",
+			     CRYPTO_DEC_BLOCK_SIZE);
+			return -EINVAL;
+		}
+	} else {
+		length = enc_file.payload_len - enc_file.offset;
+	}
+
+	for (offset = 0U; offset < length; offset += chunk_read) {
+		chunk = MIN(length - offset, (size_t)ENC_READ_CHUNK_SIZE);
+		result = io_read(backend_handle, buffer + offset, chunk,
+				 &chunk_read);
+		if ((result != 0) || (chunk_read == 0U)) {
+			WARN("Failed to read encrypted payload (%i)\n",
+			     result);
+			result = -ENOENT;
+			break;
+		}
+
+		end = offset + chunk_read;
+		if (end < (enc_file.payload_len - enc_file.offset)) {
+			end = round_down(end, CRYPTO_DEC_BLOCK_SIZE);
+		}
+		if (end == decrypted) {
+			continue;
+		}
+
+		result = crypto_mod_auth_decrypt_update(
+				(void *)(buffer + decrypted), end - decrypted);
+		if (result != 0) {
+			ERROR("File decryption failed (%i)\n", result);
+			result = -ENOENT;
+			break;
+		}
+		decrypted = end;
+	}
+
 	if (result != 0) {
+		crypto_mod_auth_decrypt_abort();
+		enc_file.state = ENC_FILE_FAILED;
+		return result;
+	}
+
+	enc_file.offset += offset;
+	*length_read = offset;
+
+	if (enc_file.offset == enc_file.payload_len) {
+		result = crypto_mod_auth_decrypt_finish(enc_file.header.tag,
+							enc_file.header.tag_len);
+		if (result != 0) {
+			ERROR("File decryption failed (%i)\n", result);
+			enc_file.state = ENC_FILE_FAILED;
+			return -ENOENT;
+		}
+
+		enc_file.state = ENC_FILE_DONE;
+	}
+
+	return 0;
+}
+
+/*
+ * Read and decrypt the whole payload at once, for crypto libraries that cannot
+ * decrypt it in chunks.
+ */
+static int enc_read_one_go(uintptr_t buffer, size_t length,
+			   size_t *length_read, const uint8_t *key,
+			   size_t key_len, unsigned int key_flags)
+{
+	int result;
+	size_t bytes_read;
+	struct fw_enc_hdr *header = &enc_file.header;
+
+	if (length < enc_file.payload_len) {
+		WARN("Encrypted payload must be read in one go\n");
+		return -ENOTSUP;
+	}
+
+	result = io_read(backend_handle, buffer, enc_file.payload_len,
+			 &bytes_read);
+	if ((result != 0) || (bytes_read != enc_file.payload_len)) {
 		WARN("Failed to read encrypted payload (%i)\n", result);
 		return -ENOENT;
 	}
 
+	result = crypto_mod_auth_decrypt(header->dec_algo,
+					 (void *)buffer, bytes_read, key,
+					 key_len, key_flags, header->iv,
+					 header->iv_len, header->tag,
+					 header->tag_len);
+	if (result != 0) {
+		ERROR("File decryption failed (%i)\n", result);
+		return -ENOENT;
+	}
+
+	enc_file.offset = bytes_read;
+	enc_file.state = ENC_FILE_DONE;
 	*length_read = bytes_read;
 
+	return 0;
+}
+
+/*
+ * First read of the file: read the header, obtain the key and start the
+ * decryption, which carries on over the next reads.
+ */
+static int enc_read_first(uintptr_t buffer, size_t length,
+			  size_t *length_read)
+{
+	int result;
+	enum fw_enc_status_t fw_enc_status;
+	uint8_t key[ENC_MAX_KEY_SIZE];
+	size_t key_len = sizeof(key);
+	unsigned int key_flags = 0;
+	const io_uuid_spec_t *uuid_spec = (io_uuid_spec_t *)backend_image_spec;
+	struct fw_enc_hdr *header = &enc_file.header;
+
+	result = enc_read_header();
+	if (result != 0) {
+		return result;
+	}
+
+	fw_enc_status = header->flags & FW_ENC_STATUS_FLAG_MASK;
+
 	result = plat_get_enc_key_info(fw_enc_status, key, &key_len, &key_flags,
 				       (uint8_t *)&uuid_spec->uuid,
 				       sizeof(uuid_t));
@@ -202,26 +367,59 @@ static int enc_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 		return -ENOENT;
 	}
 
-	result = crypto_mod_auth_decrypt(header.dec_algo,
-					 (void *)buffer, *length_read, key,
-					 key_len, key_flags, header.iv,
-					 header.iv_len, header.tag,
-					 header.tag_len);
+	result = crypto_mod_auth_decrypt_start(header->dec_algo, key, key_len,
+					       key_flags, header->iv,
+					       header->iv_len);
+	if (result == 0) {
+		memset(key, 0, key_len);
+		enc_file.state = ENC_FILE_RUNNING;
+		return enc_read_chunks(buffer, length, length_read);
+	}
+
+	result = enc_read_one_go(buffer, length, length_read, key, key_len,
+				 key_flags);
 	memset(key, 0, key_len);
 
-	if (result != 0) {
-		ERROR("File decryption failed (%i)\n", result);
+	return result;
+}
+
+static int enc_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
+			 size_t *length_read)
+{
+	int result;
+
+	assert(entity != NULL);
+	assert(length_read != NULL);
+
+	*length_read = 0U;
+
+	switch (enc_file.state) {
+	case ENC_FILE_IDLE:
+		result = enc_read_first(buffer, length, length_read);
+		if (result != 0) {
+			enc_file.state = ENC_FILE_FAILED;
+		}
+		return result;
+	case ENC_FILE_RUNNING:
+		return enc_read_chunks(buffer, length, length_read);
+	case ENC_FILE_DONE:
+		/* End of the payload */
+		return 0;
+	default:
 		return -ENOENT;
 	}
-
-	return result;
 }
 
 static int enc_file_close(io_entity_t *entity)
 {
+	if (enc_file.state == ENC_FILE_RUNNING) {
+		crypto_mod_auth_decrypt_abort();
+	}
+
 	io_close(backend_handle);
 
 	backend_image_spec = (uintptr_t)NULL;
+	zeromem(&enc_file, sizeof(enc_file));
 	entity->info = 0;
 
 	return 0;
@@ -6,6 +6,7 @@
 
 #include <assert.h>
 #include <errno.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
 
@@ -25,6 +26,19 @@
 #define MAX_FIP_DEVICES		1
 #endif
 
+/*
+ * Number of ToC entries cached per FIP device at dev_init time. A value of 0
+ * disables the cache and every file open walks the ToC in the backend.
+ */
+#ifndef MAX_FIP_TOC_ENTRIES
+#define MAX_FIP_TOC_ENTRIES	0
+#endif
+
+/* Number of files that can be open at the same time across all FIP devices */
+#ifndef MAX_FIP_FILES
+#define MAX_FIP_FILES		1
+#endif
+
 /* Useful for printing UUIDs when debugging.*/
 #define PRINT_UUID2(x)								\
 	"%08x-%04hx-%04hx-%02hhx%02hhx-%02hhx%02hhx%02hhx%02hhx%02hhx%02hhx",	\
@@ -47,16 +61,31 @@ typedef struct {
 typedef struct {
 	uintptr_t dev_spec;
 	uint16_t plat_toc_flag;
+#if MAX_FIP_TOC_ENTRIES > 0
+	/*
+	 * ToC entries sorted by UUID. The extra entry holds the end marker of
+	 * the ToC when it is read, or shows that the ToC does not fit.
+	 */
+	fip_toc_entry_t toc_cache[MAX_FIP_TOC_ENTRIES + 1];
+	unsigned int toc_cache_count;
+	/* Set when the cache matches the FIP described below */
+	bool toc_cache_valid;
+	/* Set when the whole ToC fits in the cache */
+	bool toc_cache_complete;
+	uintptr_t toc_cache_dev_handle;
+	uintptr_t toc_cache_image_spec;
+	fip_toc_header_t toc_cache_header;
+#endif
 } fip_dev_state_t;
 
 /*
- * Only one file can be open across all FIP device
- * as backends like io_memmap don't support
- * multiple open files. The file state and
- * backend handle should be maintained per FIP device
- * if the same support is available in the backend
+ * Up to MAX_FIP_FILES files can be open across all FIP devices. Backends
+ * like io_memmap don't support multiple open files, so the backend is only
+ * opened for the duration of each ToC walk or read and is never held open
+ * by a FIP file. We know the FIP header lives at offset zero, so a pool
+ * entry with a zero offset_address is free.
  */
-static fip_file_state_t current_fip_file = {0};
+static fip_file_state_t file_pool[MAX_FIP_FILES];
 static uintptr_t backend_dev_handle;
 static uintptr_t backend_image_spec;
 
@@ -95,6 +124,118 @@ static inline int is_valid_header(fip_toc_header_t *header)
 }
 
 
+#if MAX_FIP_TOC_ENTRIES > 0
+/*
+ * Check whether the ToC cache was built from the FIP the backend now points to.
+ * FIP devices are initialised before each image is loaded, so this avoids
+ * reading the ToC again when nothing changed.
+ */
+static bool fip_toc_cache_is_current(const fip_dev_state_t *state,
+				     const fip_toc_header_t *header)
+{
+	return state->toc_cache_valid &&
+	       (state->toc_cache_dev_handle == backend_dev_handle) &&
+	       (state->toc_cache_image_spec == backend_image_spec) &&
+	       (memcmp(&state->toc_cache_header, header,
+		       sizeof(*header)) == 0);
+}
+
+/*
+ * Read the ToC from the backend, which must be positioned just past the FIP
+ * header, and build a UUID sorted cache of it in the device state. The ToC is
+ * read with a single backend read of the size of the cache. The cache is only
+ * an optimisation: on failure it is left empty and file opens fall back to
+ * walking the ToC in the backend.
+ */
+static void fip_toc_cache_build(fip_dev_state_t *state,
+				const fip_toc_header_t *header,
+				uintptr_t backend_handle)
+{
+	static const uuid_t uuid_null = { {0} }; /* Double braces for clang */
+	fip_toc_entry_t *cache = state->toc_cache;
+	fip_toc_entry_t entry;
+	size_t bytes_read;
+	unsigned int count, i, j;
+	int result;
+
+	state->toc_cache_valid = false;
+	state->toc_cache_count = 0U;
+	state->toc_cache_complete = false;
+
+	result = io_read(backend_handle, (uintptr_t)cache,
+			 sizeof(state->toc_cache), &bytes_read);
+	if (result != 0) {
+		VERBOSE("FIP ToC cache: failed to read ToC (%i)\n", result);
+		return;
+	}
+
+	for (count = 0U; count < (bytes_read / sizeof(entry)); count++) {
+		if (compare_uuids(&cache[count].uuid, &uuid_null) == 0) {
+			state->toc_cache_complete = true;
+			break;
+		}
+	}
+
+	if (count > (unsigned int)MAX_FIP_TOC_ENTRIES) {
+		VERBOSE("FIP ToC cache: more than %u entries\n",
+			(unsigned int)MAX_FIP_TOC_ENTRIES);
+		count = (unsigned int)MAX_FIP_TOC_ENTRIES;
+	}
+
+	/* Insertion sort on UUID, the ToC only has a few entries */
+	for (i = 1U; i < count; i++) {
+		entry = cache[i];
+		for (j = i; j > 0U; j--) {
+			if (compare_uuids(&cache[j - 1U].uuid,
+					  &entry.uuid) <= 0) {
+				break;
+			}
+			cache[j] = cache[j - 1U];
+		}
+		cache[j] = entry;
+	}
+
+	state->toc_cache_count = count;
+	state->toc_cache_dev_handle = backend_dev_handle;
+	state->toc_cache_image_spec = backend_image_spec;
+	state->toc_cache_header = *header;
+	state->toc_cache_valid = true;
+}
+
+/*
+ * Look up a UUID in the ToC cache. Returns 0 and fills in 'entry' on a hit,
+ * -ENOENT if the UUID is known not to be in the FIP and -EAGAIN if the cache
+ * cannot tell, in which case the ToC has to be read from the backend.
+ */
+static int fip_toc_cache_lookup(const fip_dev_state_t *state,
+				const uuid_t *uuid, fip_toc_entry_t *entry)
+{
+	unsigned int low = 0U;
+	unsigned int high = state->toc_cache_count;
+	unsigned int mid;
+	int cmp;
+
+	if (!state->toc_cache_valid) {
+		return -EAGAIN;
+	}
+
+	while (low < high) {
+		mid = low + ((high - low) / 2U);
+		cmp = compare_uuids(&state->toc_cache[mid].uuid, uuid);
+		if (cmp == 0) {
+			*entry = state->toc_cache[mid];
+			return 0;
+		} else if (cmp < 0) {
+			low = mid + 1U;
+		} else {
+			high = mid;
+		}
+	}
+
+	return state->toc_cache_complete ? -ENOENT : -EAGAIN;
+}
+#endif /* MAX_FIP_TOC_ENTRIES > 0 */
+
 /* Identify the device type as a virtual driver */
 static io_type_t device_type_fip(void)
 {
@@ -119,6 +260,20 @@ static const io_dev_funcs_t fip_dev_funcs = {
 	.dev_close = fip_dev_close,
 };
 
+/* Allocate a free file state from the pool */
+static fip_file_state_t *allocate_file_state(void)
+{
+	unsigned int index;
+
+	for (index = 0; index < (unsigned int)MAX_FIP_FILES; ++index) {
+		if (file_pool[index].entry.offset_address == 0U) {
+			return &file_pool[index];
+		}
+	}
+
+	return NULL;
+}
+
 /* Locate a file state in the pool, specified by address */
 static int find_first_fip_state(const uintptr_t dev_spec,
 				  unsigned int *index_out)
@@ -183,8 +338,8 @@ static int free_dev_info(io_dev_info_t *dev_info)
 
 /*
  * Multiple FIP devices can be opened depending on the value of
- * MAX_FIP_DEVICES. Given that there is only one backend, only a
- * single file can be open at a time by any FIP device.
+ * MAX_FIP_DEVICES. Files of any FIP device are allocated from a shared
+ * pool of MAX_FIP_FILES entries.
  */
 static int fip_dev_open(const uintptr_t dev_spec,
 			 io_dev_info_t **dev_info)
@@ -205,6 +360,9 @@ static int fip_dev_open(const uintptr_t dev_spec,
 	state = (fip_dev_state_t *)info->info;
 
 	state->dev_spec = dev_spec;
+#if MAX_FIP_TOC_ENTRIES > 0
+	state->toc_cache_valid = false;
+#endif
 
 	*dev_info = info;
 
@@ -258,12 +416,24 @@ static int fip_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params)
 			 * bits [32-47] in fip header.
 			 */
 			state->plat_toc_flag = (header.flags >> 32) & 0xffff;
+#if MAX_FIP_TOC_ENTRIES > 0
+			if (!fip_toc_cache_is_current(state, &header)) {
+				fip_toc_cache_build(state, &header,
+						    backend_handle);
+			}
+#endif
 		}
 	}
 
 	io_close(backend_handle);
 
  fip_dev_init_exit:
+#if MAX_FIP_TOC_ENTRIES > 0
+	/* Do not keep using the ToC of a FIP that can no longer be accessed */
+	if (result != 0) {
+		state->toc_cache_valid = false;
+	}
+#endif
 	return result;
 }
 
@@ -290,21 +460,41 @@ static int fip_file_open(io_dev_info_t *dev_info, const uintptr_t spec,
 	static const uuid_t uuid_null = { {0} }; /* Double braces for clang */
 	size_t bytes_read;
 	int found_file = 0;
+	fip_file_state_t *fp;
+#if MAX_FIP_TOC_ENTRIES > 0
+	const fip_dev_state_t *state;
+#endif
 
 	assert(uuid_spec != NULL);
 	assert(entity != NULL);
 
-	/* Can only have one file open at a time for the moment. We need to
-	 * track state like file cursor position. We know the header lives at
-	 * offset zero, so this entry should never be zero for an active file.
-	 * When the system supports dynamic memory allocation we can allow more
-	 * than one open file at a time if needed.
+	/*
+	 * We need to track state like file cursor position for each open
+	 * file, so take a free entry from the file pool. The entry only
+	 * becomes in use once a non-zero ToC offset has been stored in it.
 	 */
-	if (current_fip_file.entry.offset_address != 0U) {
-		WARN("fip_file_open : Only one open file at a time.\n");
+	fp = allocate_file_state();
+	if (fp == NULL) {
+		WARN("fip_file_open : Too many open files.\n");
 		return -ENFILE;
 	}
 
+#if MAX_FIP_TOC_ENTRIES > 0
+	assert(dev_info != NULL);
+	state = (const fip_dev_state_t *)dev_info->info;
+
+	/* Resolve the file from the ToC cache without touching the backend */
+	result = fip_toc_cache_lookup(state, &uuid_spec->uuid, &fp->entry);
+	if (result == 0) {
+		fp->file_pos = 0;
+		entity->info = (uintptr_t)fp;
+		return 0;
+	} else if (result == -ENOENT) {
+		fp->entry.offset_address = 0;
+		return -ENOENT;
+	}
+#endif
+
 	/* Attempt to access the FIP image */
 	result = io_open(backend_dev_handle, backend_image_spec,
 			 &backend_handle);
@@ -326,32 +516,34 @@ static int fip_file_open(io_dev_info_t *dev_info, const uintptr_t spec,
 	found_file = 0;
 	do {
 		result = io_read(backend_handle,
-				 (uintptr_t)&current_fip_file.entry,
-				 sizeof(current_fip_file.entry),
+				 (uintptr_t)&fp->entry,
+				 sizeof(fp->entry),
 				 &bytes_read);
 		if (result == 0) {
-			if (compare_uuids(&current_fip_file.entry.uuid,
+			if (compare_uuids(&fp->entry.uuid,
 					  &uuid_spec->uuid) == 0) {
 				found_file = 1;
 			}
 		} else {
 			WARN("Failed to read FIP (%i)\n", result);
+			/* Release the file state entry */
+			fp->entry.offset_address = 0;
 			goto fip_file_open_close;
 		}
 	} while ((found_file == 0) &&
-			(compare_uuids(&current_fip_file.entry.uuid,
+			(compare_uuids(&fp->entry.uuid,
 				&uuid_null) != 0));
 
 	if (found_file == 1) {
 		/* All fine. Update entity info with file state and return. Set
-		 * the file position to 0. The 'current_fip_file.entry' holds
-		 * the base and size of the file.
+		 * the file position to 0. The 'fp->entry' holds the base and
+		 * size of the file.
 		 */
-		current_fip_file.file_pos = 0;
-		entity->info = (uintptr_t)&current_fip_file;
+		fp->file_pos = 0;
+		entity->info = (uintptr_t)fp;
 	} else {
 		/* Did not find the file in the FIP. */
-		current_fip_file.entry.offset_address = 0;
+		fp->entry.offset_address = 0;
 		result = -ENOENT;
 	}
 
@@ -434,11 +626,16 @@ static int fip_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 /* Close a file in package */
 static int fip_file_close(io_entity_t *entity)
 {
-	/* Clear our current file pointer.
+	fip_file_state_t *fp;
+
+	assert(entity != NULL);
+
+	/* Release the file state back to the pool.
 	 * If we had malloc() we would free() here.
 	 */
-	if (current_fip_file.entry.offset_address != 0U) {
-		zeromem(&current_fip_file, sizeof(current_fip_file));
+	fp = (fip_file_state_t *)entity->info;
+	if (fp != NULL) {
+		zeromem(fp, sizeof(*fp));
 	}
 
 	/* Clear the Entity info. */
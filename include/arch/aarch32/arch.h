@@ -560,6 +560,7 @@
 #define TLBIALL		p15, 0, c8, c7, 0
 #define TLBIALLH	p15, 4, c8, c7, 0
 #define TLBIALLIS	p15, 0, c8, c3, 0
+#define TLBIALLHIS	p15, 4, c8, c3, 0
 #define TLBIMVA		p15, 0, c8, c7, 1
 #define TLBIMVAA	p15, 0, c8, c7, 3
 #define TLBIMVAAIS	p15, 0, c8, c3, 3
@@ -256,6 +256,13 @@
 #define ID_AA64ISAR0_RNDR_SHIFT	U(60)
 #define ID_AA64ISAR0_RNDR_MASK	ULL(0xf)
 
+#define ID_AA64ISAR0_TLB_SHIFT		U(56)
+#define ID_AA64ISAR0_TLB_MASK		ULL(0xf)
+#define ID_AA64ISAR0_TLB_RANGE		ULL(0x2)
+
+#define ID_AA64ISAR0_CRC32_SHIFT	U(16)
+#define ID_AA64ISAR0_CRC32_MASK		ULL(0xf)
+
 /* ID_AA64ISAR1_EL1 definitions */
 #define ID_AA64ISAR1_EL1		S3_0_C0_C6_1
 
@@ -994,6 +1001,17 @@
 #define TLBI_ADDR_MASK		ULL(0x00000FFFFFFFFFFF)
 #define TLBI_ADDR(x)		(((x) >> TLBI_ADDR_SHIFT) & TLBI_ADDR_MASK)
 
+/* Fields of the operand of the TLBI range instructions (FEAT_TLBIRANGE) */
+#define TLBI_RANGE_TG_SHIFT	U(46)
+#define TLBI_RANGE_TG_4KB	ULL(1)
+#define TLBI_RANGE_TG_16KB	ULL(2)
+#define TLBI_RANGE_TG_64KB	ULL(3)
+#define TLBI_RANGE_SCALE_SHIFT	U(44)
+#define TLBI_RANGE_SCALE_MAX	U(3)
+#define TLBI_RANGE_NUM_SHIFT	U(39)
+#define TLBI_RANGE_NUM_MAX	U(31)
+#define TLBI_RANGE_BADDR_MASK	ULL(0x1FFFFFFFFF)
+
 /*******************************************************************************
  * Definitions of register offsets and fields in the CNTCTLBase Frame of the
  * system level implementation of the Generic Timer.
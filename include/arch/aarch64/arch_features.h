@@ -83,6 +83,12 @@ static inline bool is_armv8_4_ttst_present(void)
 		ID_AA64MMFR2_EL1_ST_MASK) == 1U;
 }
 
+static inline bool is_armv8_4_tlbirange_present(void)
+{
+	return ((read_id_aa64isar0_el1() >> ID_AA64ISAR0_TLB_SHIFT) &
+		ID_AA64ISAR0_TLB_MASK) >= ID_AA64ISAR0_TLB_RANGE;
+}
+
 static inline bool is_armv8_5_bti_present(void)
 {
 	return ((read_id_aa64pfr1_el1() >> ID_AA64PFR1_EL1_BT_SHIFT) &
@@ -110,6 +116,8 @@ CREATE_FEATURE_FUNCS_VER(feat_ecv_v2, read_feat_ecv_id_field,
 
 CREATE_FEATURE_FUNCS(feat_rng, id_aa64isar0_el1, ID_AA64ISAR0_RNDR_SHIFT,
 		     ENABLE_FEAT_RNG)
+CREATE_FEATURE_FUNCS(feat_crc32, id_aa64isar0_el1, ID_AA64ISAR0_CRC32_SHIFT,
+		     ENABLE_FEAT_CRC32)
 CREATE_FEATURE_FUNCS(feat_tcr2, id_aa64mmfr3_el1, ID_AA64MMFR3_EL1_TCRX_SHIFT,
 		     ENABLE_FEAT_TCR2)
 
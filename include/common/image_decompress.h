@@ -16,9 +16,44 @@ typedef int (decompressor_t)(uintptr_t *in_buf, size_t in_len,
 			     uintptr_t *out_buf, size_t out_len,
 			     uintptr_t work_buf, size_t work_len);
 
+/* Decompressor selected by the magic number at the start of the image */
+typedef struct image_decompressor {
+	const char *name;
+	uint8_t magic[4];
+	size_t magic_len;
+	decompressor_t *decompress;
+} image_decompressor_t;
+
+/*
+ * Streaming decompressor, fed with the compressed image while it is loaded.
+ * format is the one-shot decompressor of the same format, whose magic number
+ * identifies the images that the stream can inflate. init() starts a new
+ * stream writing to out_buf, update() inflates the next chunk of compressed
+ * data and returns 1 once the end of the stream is reached, 0 if it needs more
+ * input or a negative error code, and finish() returns the end of the output
+ * in out_buf.
+ */
+typedef struct decompressor_stream {
+	const image_decompressor_t *format;
+	int (*init)(uintptr_t out_buf, size_t out_len,
+		    uintptr_t work_buf, size_t work_len);
+	int (*update)(uintptr_t in_buf, size_t in_len);
+	int (*finish)(uintptr_t *out_buf);
+} decompressor_stream_t;
+
 void image_decompress_init(uintptr_t buf_base, uint32_t buf_size,
 			   decompressor_t *decompressor);
+void image_decompress_init_multi(uintptr_t buf_base, uint32_t buf_size,
+				 const image_decompressor_t *const *decompressors,
+				 unsigned int count);
 void image_decompress_prepare(struct image_info *info);
 int image_decompress(struct image_info *info);
 
+#if IMAGE_DECOMPRESS_STREAM
+void image_decompress_init_stream(const decompressor_stream_t *stream);
+int image_decompress_stream_start(const struct image_info *info);
+int image_decompress_stream_update(uintptr_t buf, size_t len);
+void image_decompress_stream_abort(const struct image_info *info);
+#endif
+
 #endif /* IMAGE_DECOMPRESS_H */
@@ -31,6 +31,37 @@
 #endif /* __aarch64__ */
 #define SIZEOF_RT_SVC_DESC	(U(1) << RT_SVC_SIZE_LOG2)
 
+/*
+ * Constants to allow the assembler access a runtime service fast-path
+ * descriptor
+ */
+#define RT_SVC_FID_DESC_FID	U(0)
+#ifdef __aarch64__
+#define RT_SVC_FID_SIZE_LOG2	U(4)
+#define RT_SVC_FID_DESC_HANDLE	U(8)
+#else
+#define RT_SVC_FID_SIZE_LOG2	U(3)
+#define RT_SVC_FID_DESC_HANDLE	U(4)
+#endif /* __aarch64__ */
+#define SIZEOF_RT_SVC_FID_DESC	(U(1) << RT_SVC_FID_SIZE_LOG2)
+
+/*
+ * Constants to allow the assembler access the fast-path index. Each unique
+ * owning entity number has a window of function numbers per calling
+ * convention, as SMC32 and SMC64 function IDs may share a function number.
+ * The window of the SMC64 calling convention follows the MAX_RT_SVCS windows
+ * of the SMC32 one. A window is packed in a word with the first function
+ * number in bits [15:0], the number of function numbers in bits [23:16] and
+ * the offset of the window in the 'rt_svc_fid_indices' array in bits [31:24].
+ */
+#define RT_SVC_FID_WINDOW_CC_SHIFT	U(7)
+#define RT_SVC_FID_WINDOW_SIZE_LOG2	U(2)
+#define RT_SVC_FID_WINDOW_BASE_SHIFT	U(0)
+#define RT_SVC_FID_WINDOW_BASE_WIDTH	U(16)
+#define RT_SVC_FID_WINDOW_COUNT_SHIFT	U(16)
+#define RT_SVC_FID_WINDOW_COUNT_WIDTH	U(8)
+#define RT_SVC_FID_WINDOW_OFFSET_SHIFT	U(24)
+#define RT_SVC_FID_INDICES_NUM		U(256)
 
 /*
  * In SMCCC 1.X, the function identifier has 6 bits for the owning entity number
@@ -38,6 +69,7 @@
  * limit the maximum number of runtime services to 128.
  */
 #define MAX_RT_SVCS		U(128)
+#define RT_SVC_FID_WINDOWS_NUM	(MAX_RT_SVCS << FUNCID_CC_WIDTH)
 
 #ifndef __ASSEMBLER__
 
@@ -81,6 +113,42 @@ typedef struct rt_svc_desc {
 			.handle = (_smch)				\
 		}
 
+/*
+ * Descriptor of a fast-path handler for a single SMC function ID. When
+ * SMC_FAST_PATH is enabled, an SMC whose function ID matches one of these
+ * descriptors is passed directly to its handler instead of the handler of the
+ * runtime service owning the function ID, which would have to decode it again.
+ * The handler must therefore perform all the checks that the runtime service
+ * would have done for this function ID. It is only called once the owning
+ * runtime service has been successfully initialised.
+ */
+typedef struct rt_svc_fid_desc {
+	uint32_t smc_fid;
+	rt_svc_handle_t handle;
+} rt_svc_fid_desc_t;
+
+/*
+ * Convenience macro to declare a fast-path descriptor for a function ID
+ */
+#define DECLARE_RT_SVC_FID(_name, _fid, _smch)				\
+	static const rt_svc_fid_desc_t __svc_fid_desc_ ## _name		\
+		__section(".rt_svc_fid_descs") __used = {		\
+			.smc_fid = (_fid),				\
+			.handle = (_smch)				\
+		}
+
+/*
+ * Window of the function numbers of a unique owning entity number that have
+ * fast-path descriptors. The function number 'fn_base + n', for n lower than
+ * 'fn_count', has the entry 'offset + n' in the 'rt_svc_fid_indices' array,
+ * which holds the index of its descriptor plus one, or 0 if it has none.
+ */
+typedef struct rt_svc_fid_window {
+	uint16_t fn_base;
+	uint8_t fn_count;
+	uint8_t offset;
+} rt_svc_fid_window_t;
+
 /*
  * Compile time assertions related to the 'rt_svc_desc' structure to:
  * 1. ensure that the assembler and the compiler view of the size
@@ -97,6 +165,36 @@ CASSERT(RT_SVC_DESC_INIT == __builtin_offsetof(rt_svc_desc_t, init),
 CASSERT(RT_SVC_DESC_HANDLE == __builtin_offsetof(rt_svc_desc_t, handle),
 	assert_rt_svc_desc_handle_offset_mismatch);
 
+/*
+ * Compile time assertions related to the 'rt_svc_fid_desc' structure, for the
+ * same reasons as above.
+ */
+CASSERT((sizeof(rt_svc_fid_desc_t) == SIZEOF_RT_SVC_FID_DESC),
+	assert_sizeof_rt_svc_fid_desc_mismatch);
+CASSERT(RT_SVC_FID_DESC_FID == __builtin_offsetof(rt_svc_fid_desc_t, smc_fid),
+	assert_rt_svc_fid_desc_fid_offset_mismatch);
+CASSERT(RT_SVC_FID_DESC_HANDLE ==
+	__builtin_offsetof(rt_svc_fid_desc_t, handle),
+	assert_rt_svc_fid_desc_handle_offset_mismatch);
+
+/*
+ * Compile time assertions related to the 'rt_svc_fid_window' structure, to
+ * ensure that the assembler sees its fields in the word it loads.
+ */
+CASSERT(sizeof(rt_svc_fid_window_t) == (U(1) << RT_SVC_FID_WINDOW_SIZE_LOG2),
+	assert_sizeof_rt_svc_fid_window_mismatch);
+CASSERT((U(1) << RT_SVC_FID_WINDOW_CC_SHIFT) == MAX_RT_SVCS,
+	assert_rt_svc_fid_window_cc_shift_mismatch);
+CASSERT((RT_SVC_FID_WINDOW_BASE_SHIFT / 8U) ==
+	__builtin_offsetof(rt_svc_fid_window_t, fn_base),
+	assert_rt_svc_fid_window_base_offset_mismatch);
+CASSERT((RT_SVC_FID_WINDOW_COUNT_SHIFT / 8U) ==
+	__builtin_offsetof(rt_svc_fid_window_t, fn_count),
+	assert_rt_svc_fid_window_count_offset_mismatch);
+CASSERT((RT_SVC_FID_WINDOW_OFFSET_SHIFT / 8U) ==
+	__builtin_offsetof(rt_svc_fid_window_t, offset),
+	assert_rt_svc_fid_window_offset_offset_mismatch);
+
 
 /*
  * This function combines the call type and the owning entity number
@@ -122,6 +220,17 @@ static inline uint32_t get_unique_oen_from_smc_fid(uint32_t fid)
 	return get_unique_oen(GET_SMC_OEN(fid), GET_SMC_TYPE(fid));
 }
 
+/*
+ * This function generates the index of the fast-path window of the SMC Function
+ * ID in the 'rt_svc_fid_windows' array, from its unique oen and its calling
+ * convention.
+ */
+static inline uint32_t get_rt_svc_fid_window_from_smc_fid(uint32_t fid)
+{
+	return (GET_SMC_CC(fid) << RT_SVC_FID_WINDOW_CC_SHIFT) |
+		get_unique_oen_from_smc_fid(fid);
+}
+
 /*******************************************************************************
  * Function & variable prototypes
  ******************************************************************************/
@@ -130,9 +239,13 @@ uintptr_t handle_runtime_svc(uint32_t smc_fid, void *cookie, void *handle,
 						unsigned int flags);
 IMPORT_SYM(uintptr_t, __RT_SVC_DESCS_START__,		RT_SVC_DESCS_START);
 IMPORT_SYM(uintptr_t, __RT_SVC_DESCS_END__,		RT_SVC_DESCS_END);
+IMPORT_SYM(uintptr_t, __RT_SVC_FID_DESCS_START__,	RT_SVC_FID_DESCS_START);
+IMPORT_SYM(uintptr_t, __RT_SVC_FID_DESCS_END__,	RT_SVC_FID_DESCS_END);
 void init_crash_reporting(void);
 
 extern uint8_t rt_svc_descs_indices[MAX_RT_SVCS];
+extern rt_svc_fid_window_t rt_svc_fid_windows[RT_SVC_FID_WINDOWS_NUM];
+extern uint8_t rt_svc_fid_indices[RT_SVC_FID_INDICES_NUM];
 
 #endif /*__ASSEMBLER__*/
 #endif /* RUNTIME_SVC_H */
@@ -10,7 +10,7 @@
 #include <stddef.h>
 #include <stdint.h>
 
-/* compute CRC using Arm intrinsic function */
+/* compute CRC32, with the CRC32 instructions if available */
 uint32_t tf_crc32(uint32_t crc, const unsigned char *buf, size_t size);
 
 #endif /* TF_CRC32_H */
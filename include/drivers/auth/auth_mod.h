@@ -54,6 +54,10 @@ int auth_mod_get_parent_id(unsigned int img_id, unsigned int *parent_id);
 int auth_mod_verify_img(unsigned int img_id,
 			void *img_ptr,
 			unsigned int img_len);
+#if AUTH_VERIFIED_CACHE
+struct transfer_list_header;
+int auth_mod_cache_init(struct transfer_list_header *tl);
+#endif /* AUTH_VERIFIED_CACHE */
 
 /* Macro to register a CoT defined as an array of auth_img_desc_t pointers */
 #define REGISTER_COT(_cot) \
@@ -23,6 +23,8 @@ enum crypto_ret_value {
 
 #define CRYPTO_MAX_IV_SIZE		16U
 #define CRYPTO_MAX_TAG_SIZE		16U
+/* Block size of the decryption algorithms, i.e. of AES */
+#define CRYPTO_DEC_BLOCK_SIZE		16U
 
 /* Decryption algorithm */
 enum crypto_dec_algo {
@@ -39,6 +41,36 @@ enum crypto_md_algo {
 /* Maximum size as per the known stronger hash algorithm i.e.SHA512 */
 #define CRYPTO_MD_MAX_SIZE		64U
 
+/*
+ * Hashing of data in chunks while it is loaded. The digests computed between
+ * 'start' and 'finish' are reused by 'verify_hash' and 'calc_hash' for the
+ * same data, until 'clear' is called. Return one of the
+ * 'enum crypto_ret_value' options.
+ */
+typedef struct crypto_load_hash_s {
+	int (*start)(void);
+	int (*update)(void *data_ptr, unsigned int data_len);
+	int (*finish)(void *data_ptr, unsigned int data_len);
+	void (*clear)(void);
+} crypto_load_hash_t;
+
+/*
+ * Authenticated decryption of data in chunks, in place, while it is loaded.
+ * 'update' decrypts the chunks in order between 'start' and 'finish', which
+ * checks the tag. The size of every chunk but the last one is a multiple of
+ * CRYPTO_DEC_BLOCK_SIZE. 'abort' discards an operation that will not be
+ * finished.
+ * Return one of the 'enum crypto_ret_value' options.
+ */
+typedef struct crypto_auth_decrypt_stream_s {
+	int (*start)(enum crypto_dec_algo dec_algo, const void *key,
+		     unsigned int key_len, unsigned int key_flags,
+		     const void *iv, unsigned int iv_len);
+	int (*update)(void *data_ptr, size_t len);
+	int (*finish)(const void *tag, unsigned int tag_len);
+	void (*abort)(void);
+} crypto_auth_decrypt_stream_t;
+
 /*
  * Cryptographic library descriptor
  */
@@ -79,6 +111,12 @@ typedef struct crypto_lib_desc_s {
 			    unsigned int key_flags, const void *iv,
 			    unsigned int iv_len, const void *tag,
 			    unsigned int tag_len);
+
+	/* Hash data while it is loaded (optional) */
+	const crypto_load_hash_t *load_hash;
+
+	/* Authenticated decryption in chunks (optional) */
+	const crypto_auth_decrypt_stream_t *auth_decrypt_stream;
 } crypto_lib_desc_t;
 
 /* Public functions */
@@ -106,6 +144,13 @@ int crypto_mod_auth_decrypt(enum crypto_dec_algo dec_algo, void *data_ptr,
 			    unsigned int key_flags, const void *iv,
 			    unsigned int iv_len, const void *tag,
 			    unsigned int tag_len);
+int crypto_mod_auth_decrypt_start(enum crypto_dec_algo dec_algo,
+				  const void *key, unsigned int key_len,
+				  unsigned int key_flags, const void *iv,
+				  unsigned int iv_len);
+int crypto_mod_auth_decrypt_update(void *data_ptr, size_t len);
+int crypto_mod_auth_decrypt_finish(const void *tag, unsigned int tag_len);
+void crypto_mod_auth_decrypt_abort(void);
 
 #if (CRYPTO_SUPPORT == CRYPTO_HASH_CALC_ONLY) || \
     (CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_AND_HASH_CALC)
@@ -118,17 +163,23 @@ int crypto_mod_calc_hash(enum crypto_md_algo alg, void *data_ptr,
 int crypto_mod_convert_pk(void *full_pk_ptr, unsigned int full_pk_len,
 			  void **hashed_pk_ptr, unsigned int *hashed_pk_len);
 
-/* Macro to register a cryptographic library */
-#define REGISTER_CRYPTO_LIB(_name, _init, _verify_signature, _verify_hash, \
-			    _calc_hash, _auth_decrypt, _convert_pk) \
+#if HASH_ON_LOAD
+int crypto_mod_load_hash_start(void);
+int crypto_mod_load_hash_update(void *data_ptr, unsigned int data_len);
+int crypto_mod_load_hash_finish(void *data_ptr, unsigned int data_len);
+void crypto_mod_load_hash_clear(void);
+#endif /* HASH_ON_LOAD */
+
+/*
+ * Macro to register a cryptographic library. The operations it provides are
+ * given as designated initializers of crypto_lib_desc_t, e.g.
+ * `.verify_hash = verify_hash`, and the ones left out are NULL.
+ */
+#define REGISTER_CRYPTO_LIB(_name, _init, ...) \
 	const crypto_lib_desc_t crypto_lib_desc = { \
 		.name = _name, \
 		.init = _init, \
-		.verify_signature = _verify_signature, \
-		.verify_hash = _verify_hash, \
-		.calc_hash = _calc_hash, \
-		.auth_decrypt = _auth_decrypt, \
-		.convert_pk = _convert_pk \
+		__VA_ARGS__ \
 	}
 
 extern const crypto_lib_desc_t crypto_lib_desc;
@@ -32,6 +32,7 @@
 
 #ifndef __ASSEMBLER__
 
+#include <stddef.h>
 #include <stdint.h>
 
 typedef struct console {
@@ -80,6 +81,15 @@ int console_getc(void);
 /* Flush all consoles registered for the current state. */
 void console_flush(void);
 
+#if CONSOLE_DEFERRED_LOG
+/* Write out the characters deferred by console_putc() in the runtime state. */
+void console_log_drain(void);
+/* Write out a few deferred characters if no other CPU holds the buffer. */
+void console_log_drain_idle(void);
+/* Remove up to `len` deferred characters, copy them to `buf`. Returns count. */
+size_t console_log_read(char *buf, size_t len);
+#endif
+
 #endif /* __ASSEMBLER__ */
 
 #endif /* CONSOLE_H */
@@ -21,8 +21,16 @@ typedef struct io_block_dev_spec {
 	size_t		block_size;
 } io_block_dev_spec_t;
 
+/* block cache statistics */
+typedef struct io_block_cache_stats {
+	unsigned int	hits;	/* reads served from the cache */
+	unsigned int	misses;	/* reads that had to fill a cache line */
+	unsigned int	reads;	/* calls to ops->read */
+} io_block_cache_stats_t;
+
 struct io_dev_connector;
 
 int register_io_dev_block(const struct io_dev_connector **dev_con);
+void io_block_get_cache_stats(io_block_cache_stats_t *stats);
 
 #endif /* IO_BLOCK_H */
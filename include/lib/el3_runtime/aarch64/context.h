@@ -143,6 +143,34 @@
  */
 #define CTX_EL1_SYSREGS_END		CTX_MTE_REGS_END
 
+/*
+ * Groups of EL1 system registers that can be switched independently, see
+ * cm_set_el1_sysregs_groups().
+ *  - EXCEPTION: SPSR, ELR, ESR, FAR, PAR, AFSR0, AFSR1 and SP_EL1.
+ *  - MMU: SCTLR, TCR, TTBR0, TTBR1, MAIR and AMAIR.
+ *  - SYSTEM: CPACR, CSSELR, ACTLR, TPIDR_EL1, CONTEXTIDR and VBAR.
+ *  - EL0: TPIDR_EL0 and TPIDRRO_EL0.
+ *  - AARCH32: AArch32 registers, with CTX_INCLUDE_AARCH32_REGS.
+ *  - TIMER: Non-secure timer registers, with NS_TIMER_SWITCH.
+ *  - MTE: MTE registers, with CTX_INCLUDE_MTE_REGS.
+ */
+#define CTX_EL1_REGS_EXCEPTION_SHIFT	U(0)
+#define CTX_EL1_REGS_MMU_SHIFT		U(1)
+#define CTX_EL1_REGS_SYSTEM_SHIFT	U(2)
+#define CTX_EL1_REGS_EL0_SHIFT		U(3)
+#define CTX_EL1_REGS_AARCH32_SHIFT	U(4)
+#define CTX_EL1_REGS_TIMER_SHIFT	U(5)
+#define CTX_EL1_REGS_MTE_SHIFT		U(6)
+
+#define CTX_EL1_REGS_EXCEPTION		(U(1) << CTX_EL1_REGS_EXCEPTION_SHIFT)
+#define CTX_EL1_REGS_MMU		(U(1) << CTX_EL1_REGS_MMU_SHIFT)
+#define CTX_EL1_REGS_SYSTEM		(U(1) << CTX_EL1_REGS_SYSTEM_SHIFT)
+#define CTX_EL1_REGS_EL0		(U(1) << CTX_EL1_REGS_EL0_SHIFT)
+#define CTX_EL1_REGS_AARCH32		(U(1) << CTX_EL1_REGS_AARCH32_SHIFT)
+#define CTX_EL1_REGS_TIMER		(U(1) << CTX_EL1_REGS_TIMER_SHIFT)
+#define CTX_EL1_REGS_MTE		(U(1) << CTX_EL1_REGS_MTE_SHIFT)
+#define CTX_EL1_REGS_ALL		U(0x7f)
+
 /*
  * EL2 register set
  */
@@ -513,8 +541,8 @@ CASSERT(CTX_PAUTH_REGS_OFFSET == __builtin_offsetof(cpu_context_t, pauth_ctx),
 /*******************************************************************************
  * Function prototypes
  ******************************************************************************/
-void el1_sysregs_context_save(el1_sysregs_t *regs);
-void el1_sysregs_context_restore(el1_sysregs_t *regs);
+void el1_sysregs_context_save(el1_sysregs_t *regs, unsigned int groups);
+void el1_sysregs_context_restore(el1_sysregs_t *regs, unsigned int groups);
 
 #if CTX_INCLUDE_FPREGS
 void fpregs_context_save(fp_regs_t *regs);
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef EL3_TRACE_H
+#define EL3_TRACE_H
+
+#include <lib/cassert.h>
+#include <lib/utils_def.h>
+
+/*
+ * Layout of the Non-secure trace buffer. The buffer starts with a header,
+ * followed by one ring per CPU, each made of a ring header and a power of two
+ * number of records. All offsets and sizes are in bytes.
+ */
+#define EL3_TRACE_MAGIC			U(0x52543345)	/* "E3TR" */
+#define EL3_TRACE_VERSION		U(1)
+
+#define EL3_TRACE_HDR_SIZE		U(64)
+#define EL3_TRACE_RING_HDR_SIZE		U(64)
+#define EL3_TRACE_RECORD_SIZE		U(32)
+
+/* Trace events. The upper byte identifies the component */
+#define EL3_TRACE_SMC_ENTRY		U(0x0001)	/* fid, x1 */
+#define EL3_TRACE_SMC_EXIT		U(0x0002)	/* fid, x0 */
+
+#define EL3_TRACE_PSCI_CPU_ON		U(0x0101)	/* target mpidr, rc */
+#define EL3_TRACE_PSCI_CPU_OFF		U(0x0102)	/* target level */
+#define EL3_TRACE_PSCI_CPU_SUSPEND	U(0x0103)	/* power state, pwr down */
+#define EL3_TRACE_PSCI_WARMBOOT		U(0x0104)	/* end level */
+
+#define EL3_TRACE_EHF_INTR		U(0x0201)	/* intr, priority */
+#define EL3_TRACE_EHF_ACTIVATE		U(0x0202)	/* priority */
+#define EL3_TRACE_EHF_DEACTIVATE	U(0x0203)	/* priority */
+
+#define EL3_TRACE_SDEI_DISPATCH		U(0x0301)	/* event, interrupted pc */
+#define EL3_TRACE_SDEI_COMPLETE		U(0x0302)	/* event, resume */
+
+#define EL3_TRACE_SPMD_SWITCH		U(0x0401)	/* fid, target state */
+
+#ifndef __ASSEMBLER__
+
+#include <stdint.h>
+
+/* Header at the start of the trace buffer */
+typedef struct el3_trace_hdr {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t nr_cpus;
+	uint32_t nr_records;	/* Records in each ring */
+	uint32_t record_size;
+	uint32_t ring_offset;	/* Offset of the ring of CPU 0 */
+	uint32_t ring_size;	/* Offset between the rings of two CPUs */
+	uint32_t reserved0;
+	uint64_t cntfrq;	/* Frequency of the record timestamps */
+	uint8_t reserved1[EL3_TRACE_HDR_SIZE - 40U];
+} el3_trace_hdr_t;
+
+/* Header of the ring of a CPU */
+typedef struct el3_trace_ring_hdr {
+	uint64_t head;		/* Number of records ever written */
+	uint8_t reserved[EL3_TRACE_RING_HDR_SIZE - 8U];
+} el3_trace_ring_hdr_t;
+
+/*
+ * Trace record. `seq` is odd while the record is being written; a reader
+ * should discard the record if `seq` is odd or changes while the record is
+ * being read.
+ */
+typedef struct el3_trace_record {
+	uint64_t timestamp;	/* CNTPCT_EL0 */
+	uint32_t seq;
+	uint32_t event;
+	uint64_t arg0;
+	uint64_t arg1;
+} el3_trace_record_t;
+
+CASSERT(sizeof(el3_trace_hdr_t) == EL3_TRACE_HDR_SIZE,
+	assert_el3_trace_hdr_size_mismatch);
+CASSERT(sizeof(el3_trace_ring_hdr_t) == EL3_TRACE_RING_HDR_SIZE,
+	assert_el3_trace_ring_hdr_size_mismatch);
+CASSERT(sizeof(el3_trace_record_t) == EL3_TRACE_RECORD_SIZE,
+	assert_el3_trace_record_size_mismatch);
+
+#if EL3_TRACE
+#define EL3_TRACE_EVENT(_event, _arg0, _arg1)				\
+	el3_trace_event((_event), (uint64_t)(_arg0), (uint64_t)(_arg1))
+#else
+#define EL3_TRACE_EVENT(_event, _arg0, _arg1)
+#endif
+
+void el3_trace_init(void);
+void el3_trace_event(uint32_t event, uint64_t arg0, uint64_t arg1);
+void el3_trace_smc_entry(uint32_t smc_fid, uint64_t x1);
+void el3_trace_smc_exit(uint32_t smc_fid, const void *handle);
+
+#endif /* __ASSEMBLER__ */
+
+#endif /* EL3_TRACE_H */
@@ -263,7 +263,8 @@ void gpt_disable(void);
  * transition request occurs it is routed to this function where the request is
  * validated then fulfilled if possible.
  *
- * TODO: implement support for transitioning multiple granules at once.
+ * A range of contiguous granules can be transitioned in a single call. The
+ * request is only fulfilled if every granule in the range can be transitioned.
  *
  * Parameters
  *   base: Base address of the region to transition, must be aligned to granule
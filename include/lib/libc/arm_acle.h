@@ -16,9 +16,11 @@
 #if !defined(__aarch64__) || defined(__clang__)
 #	define __crc32b __builtin_arm_crc32b
 #	define __crc32w __builtin_arm_crc32w
+#	define __crc32d __builtin_arm_crc32d
 #else
 #	define __crc32b __builtin_aarch64_crc32b
 #	define __crc32w __builtin_aarch64_crc32w
+#	define __crc32d __builtin_aarch64_crc32x
 #endif
 
 #endif	/* ARM_ACLE_H */
@@ -0,0 +1,21 @@
+/*
+ * Copyright (c) 2026, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef TF_UNLZ4_H
+#define TF_UNLZ4_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <common/image_decompress.h>
+
+int unlz4(uintptr_t *in_buf, size_t in_len, uintptr_t *out_buf,
+	  size_t out_len, uintptr_t work_buf, size_t work_len);
+
+extern const image_decompressor_t unlz4_decompressor;
+extern const image_decompressor_t unlz4_legacy_decompressor;
+
+#endif /* TF_UNLZ4_H */
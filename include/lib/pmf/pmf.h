@@ -40,7 +40,12 @@
  */
 #define PMF_SMC_GET_TIMESTAMP_32	U(0x82000010)
 #define PMF_SMC_GET_TIMESTAMP_64	U(0xC2000010)
+#define PMF_SMC_GET_LATENCY_HIST_64	U(0xC2000011)
+#if PMF_LATENCY_HIST
+#define PMF_NUM_SMC_CALLS		3
+#else
 #define PMF_NUM_SMC_CALLS		2
+#endif
 
 /*
  * The macros below are used to identify
@@ -54,6 +59,27 @@
 #define PMF_PSCI_STAT_SVC_ID	0
 #define PMF_RT_INSTR_SVC_ID	1
 
+/*
+ * Latency histograms, kept per CPU when PMF_LATENCY_HIST is enabled. Bucket 0
+ * counts latencies of 0 system counter ticks, and bucket N counts latencies in
+ * the range [2^(N-1), 2^N) ticks. The last bucket also counts all the longer
+ * latencies.
+ */
+#define PMF_HIST_BUCKETS		U(32)
+
+/* Time spent in EL3 handling an SMC, per owning entity number (OEN) */
+#define PMF_HIST_SMC_ID(_oen)		(((_oen) < U(7)) ? (_oen) : U(7))
+#define PMF_HIST_SMC_NUM		U(8)
+
+/* Time from an interrupt exception to the call of its type handler */
+#define PMF_HIST_INTR_ID(_type)		(PMF_HIST_SMC_NUM + (_type))
+#define PMF_HIST_INTR_NUM		U(3)
+
+/* Time from saving the context of a security state to restoring another */
+#define PMF_HIST_WORLD_SWITCH_ID	(PMF_HIST_SMC_NUM + PMF_HIST_INTR_NUM)
+
+#define PMF_HIST_NUM			(PMF_HIST_WORLD_SWITCH_ID + U(1))
+
 /*******************************************************************************
  * Function & variable prototypes
  ******************************************************************************/
@@ -72,4 +98,16 @@ uintptr_t pmf_smc_handler(unsigned int smc_fid,
 		void *handle,
 		u_register_t flags);
 
+#if PMF_LATENCY_HIST
+/* PMF latency histogram functions */
+void pmf_latency_hist_smc(unsigned int unique_oen, unsigned long long start);
+void pmf_latency_hist_intr(unsigned int type, unsigned long long start);
+void pmf_latency_hist_switch_start(void);
+void pmf_latency_hist_switch_end(void);
+void pmf_latency_hist_switch_cancel(void);
+int pmf_get_latency_hist_smc(unsigned int hist_id,
+		u_register_t mpidr,
+		uint32_t *buckets);
+#endif
+
 #endif /* PMF_H */
@@ -83,6 +83,11 @@ u_register_t psci_smc_handler(uint32_t smc_fid,
 			  void *cookie,
 			  void *handle,
 			  u_register_t flags);
+u_register_t psci_cpu_suspend_smc_handler(uint32_t smc_fid,
+					  u_register_t x1,
+					  u_register_t x2,
+					  u_register_t x3,
+					  u_register_t flags);
 int psci_setup(const psci_lib_args_t *lib_args);
 int psci_secondaries_brought_up(void);
 void psci_warmboot_entrypoint(void);
@@ -9,6 +9,7 @@
 
 #ifndef __ASSEMBLER__
 
+#include <stdbool.h>
 #include <stdint.h>
 
 typedef struct spinlock {
@@ -17,6 +18,7 @@ typedef struct spinlock {
 
 void spin_lock(spinlock_t *lock);
 void spin_unlock(spinlock_t *lock);
+bool spin_trylock(spinlock_t *lock);
 
 #else
 
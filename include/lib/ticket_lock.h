@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef TICKET_LOCK_H
+#define TICKET_LOCK_H
+
+#ifndef __ASSEMBLER__
+
+#include <stdint.h>
+
+/*
+ * Ticket lock. The lower half-word holds the ticket currently being served
+ * and the upper half-word holds the next ticket to hand out. Contenders are
+ * granted the lock in the order they requested it.
+ *
+ * The lock must only be used by CPUs that access it coherently, that is, with
+ * their data caches enabled or with hardware-assisted coherency.
+ */
+typedef struct ticket_lock {
+	volatile uint32_t lock;
+} ticket_lock_t;
+
+void ticket_lock_get(ticket_lock_t *lock);
+void ticket_lock_release(ticket_lock_t *lock);
+
+#endif /* __ASSEMBLER__ */
+
+#endif /* TICKET_LOCK_H */
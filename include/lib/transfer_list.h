@@ -34,6 +34,9 @@ enum transfer_list_tag_id {
 	TL_TAG_HOB_BLOCK = 2,
 	TL_TAG_HOB_LIST = 3,
 	TL_TAG_ACPI_TABLE_AGGREGATE = 4,
+
+	/* Non-standard tags (0xfff000-0xffffff), only used between TF-A stages */
+	TL_TAG_TFA_AUTH_CACHE = 0xfff000,
 };
 
 enum transfer_list_ops {
@@ -64,8 +67,7 @@ struct transfer_list_header {
 };
 
 struct transfer_list_entry {
-	uint16_t	tag_id;
-	uint8_t		reserved0;	// place holder
+	uint32_t	tag_id : 24;	// 24-bit tag, as of fw handoff spec v0.9
 	uint8_t		hdr_size;
 	uint32_t	data_size;
 	/*
@@ -95,20 +97,21 @@ bool transfer_list_set_data_size(struct transfer_list_header *tl,
 
 void *transfer_list_entry_data(struct transfer_list_entry *entry);
 bool transfer_list_rem(struct transfer_list_header *tl, struct transfer_list_entry *entry);
+bool transfer_list_compact(struct transfer_list_header *tl);
 
 struct transfer_list_entry *transfer_list_add(struct transfer_list_header *tl,
-					      uint16_t tag_id, uint32_t data_size,
+					      uint32_t tag_id, uint32_t data_size,
 					      const void *data);
 
 struct transfer_list_entry *transfer_list_add_with_align(struct transfer_list_header *tl,
-							 uint16_t tag_id, uint32_t data_size,
+							 uint32_t tag_id, uint32_t data_size,
 							 const void *data, uint8_t alignment);
 
 struct transfer_list_entry *transfer_list_next(struct transfer_list_header *tl,
 					       struct transfer_list_entry *last);
 
 struct transfer_list_entry *transfer_list_find(struct transfer_list_header *tl,
-					       uint16_t tag_id);
+					       uint32_t tag_id);
 
 #endif /*__ASSEMBLER__*/
 #endif /*__TRANSFER_LIST_H*/
@@ -68,6 +68,12 @@
 #define MT_EXECUTE		(U(0) << MT_EXECUTE_SHIFT)
 #define MT_EXECUTE_NEVER	(U(1) << MT_EXECUTE_SHIFT)
 
+/*
+ * The Contiguous hint is only used by version 2 of the library, the regions
+ * that allow it are mapped without it.
+ */
+#define MT_CONTIG		U(0)
+
 /* Compound attributes for most common usages */
 #define MT_CODE			(MT_MEMORY | MT_RO | MT_EXECUTE)
 #define MT_RO_DATA		(MT_MEMORY | MT_RO | MT_EXECUTE_NEVER)
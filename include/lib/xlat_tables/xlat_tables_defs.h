@@ -108,6 +108,16 @@
 #define XLAT_BLOCK_MASK(level)	(XLAT_BLOCK_SIZE(level) - UL(1))
 /* Mask to get the address bits common to a block of a certain table level*/
 #define XLAT_ADDR_MASK(level)	(~XLAT_BLOCK_MASK(level))
+/*
+ * Number of adjacent entries of a table that can be cached as a single TLB
+ * entry when their descriptors have the Contiguous hint set, and size of the
+ * memory they map. This assumes the system is using the 4KB translation
+ * granule.
+ */
+#define XLAT_CONTIG_ENTRIES_SHIFT	U(4)
+#define XLAT_CONTIG_ENTRIES	(U(1) << XLAT_CONTIG_ENTRIES_SHIFT)
+#define XLAT_CONTIG_SIZE(level)	(ULL(1) << (XLAT_ADDR_SHIFT(level) + \
+					    XLAT_CONTIG_ENTRIES_SHIFT))
 /*
  * Extract from the given virtual address the index into the given lookup level.
  * This macro assumes the system is using the 4KB translation granule.
@@ -76,6 +76,9 @@
 #define MT_SHAREABILITY_MASK	(U(3) << MT_SHAREABILITY_SHIFT)
 #define MT_SHAREABILITY(_attr)	((_attr) & MT_SHAREABILITY_MASK)
 
+/* Use of the Contiguous hint for the memory region */
+#define MT_CONTIG_SHIFT		U(10)
+
 /* All other bits are reserved */
 
 /*
@@ -130,6 +133,15 @@
 #define MT_SHAREABILITY_OSH	(U(2) << MT_SHAREABILITY_SHIFT)
 #define MT_SHAREABILITY_NSH	(U(3) << MT_SHAREABILITY_SHIFT)
 
+/*
+ * Allow the library to set the Contiguous hint in the descriptors of the
+ * region. The attributes of a region mapped with this attribute can't be
+ * changed with xlat_change_mem_attributes(), as that would require unmapping
+ * a whole run of 16 entries. It must not be used for the code, read-only data
+ * or stacks of the image, nor for any region that is remapped at runtime.
+ */
+#define MT_CONTIG		(U(1) << MT_CONTIG_SHIFT)
+
 /* Compound attributes for most common usages */
 #define MT_CODE			(MT_MEMORY | MT_RO | MT_EXECUTE)
 #define MT_RO_DATA		(MT_MEMORY | MT_RO | MT_EXECUTE_NEVER)
@@ -337,6 +349,28 @@ int mmap_remove_dynamic_region_ctx(xlat_ctx_t *ctx,
 				uintptr_t base_va,
 				size_t size);
 
+/*
+ * Open and commit a batch of dynamic region changes. While a batch is open,
+ * the TLB invalidations needed by mmap_remove_dynamic_region() are deferred
+ * and issued together by the commit, as a single range invalidation if
+ * FEAT_TLBIRANGE is implemented or an invalidation of the whole translation
+ * regime if there are too many of them. The VA range of removed regions must
+ * therefore not be accessed until the batch is committed, nor their PA range
+ * reused for another purpose. Batches can be nested, the invalidations are
+ * issued when the outermost one is committed.
+ */
+void xlat_begin_batch(void);
+void xlat_begin_batch_ctx(xlat_ctx_t *ctx);
+void xlat_commit_batch(void);
+void xlat_commit_batch_ctx(xlat_ctx_t *ctx);
+
+/*
+ * Returns the number of TLB invalidation instructions issued for a context by
+ * dynamic region changes.
+ */
+unsigned long long xlat_get_tlbi_count(void);
+unsigned long long xlat_get_tlbi_count_ctx(const xlat_ctx_t *ctx);
+
 #endif /* PLAT_XLAT_TABLES_DYNAMIC */
 
 /*
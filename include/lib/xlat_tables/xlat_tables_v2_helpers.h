@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2020, Arm Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2023, Arm Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -31,6 +31,13 @@
 /* Forward declaration */
 struct mmap_region;
 
+/*
+ * Number of TLB invalidations that a batch of dynamic mapping changes records
+ * individually. Past this, the whole translation regime is invalidated when
+ * the batch is committed unless a range invalidation can be used.
+ */
+#define XLAT_TLBI_BATCH_MAX	U(16)
+
 /*
  * Helper macro to define an mmap_region_t.  This macro allows to specify all
  * the fields of the structure but its parameter list is not guaranteed to
@@ -80,6 +87,21 @@ struct xlat_ctx {
 	 */
 #if PLAT_XLAT_TABLES_DYNAMIC
 	int *tables_mapped_regions;
+
+	/*
+	 * TLB invalidations deferred while a batch of dynamic mapping changes
+	 * is open: nesting depth of the batch, number of invalidations
+	 * pending, the VAs of the first XLAT_TLBI_BATCH_MAX of them and the VA
+	 * range covered by the regions removed.
+	 */
+	unsigned int batch_depth;
+	unsigned int tlbi_pending;
+	uintptr_t tlbi_pending_va[XLAT_TLBI_BATCH_MAX];
+	uintptr_t tlbi_min_va;
+	uintptr_t tlbi_max_va;
+
+	/* Number of TLB invalidation instructions issued. */
+	unsigned long long tlbi_count;
 #endif /* PLAT_XLAT_TABLES_DYNAMIC */
 
 	int next_table;
@@ -10,7 +10,15 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <common/image_decompress.h>
+
 int gunzip(uintptr_t *in_buf, size_t in_len, uintptr_t *out_buf,
 	   size_t out_len, uintptr_t work_buf, size_t work_len);
 
+extern const image_decompressor_t gunzip_decompressor;
+
+#if IMAGE_DECOMPRESS_STREAM
+extern const decompressor_stream_t gunzip_stream;
+#endif
+
 #endif /* TF_GUNZIP_H */
@@ -304,15 +304,22 @@ MEASURED_BOOT
 					ARM_SHARED_RAM_SIZE,		\
 					MT_DEVICE | MT_RW | EL3_PAS)
 
+/*
+ * The DRAM regions below that have MT_CONTIG are either normal world memory or
+ * secure memory that BL2 loads BL31, BL32 or the SPMC into. Their attributes
+ * are never changed, so they can be mapped with the Contiguous hint.
+ */
 #define ARM_MAP_NS_DRAM1	MAP_REGION_FLAT(			\
 					ARM_NS_DRAM1_BASE,		\
 					ARM_NS_DRAM1_SIZE,		\
-					MT_MEMORY | MT_RW | MT_NS)
+					MT_MEMORY | MT_RW | MT_NS |	\
+					MT_CONTIG)
 
 #define ARM_MAP_DRAM2		MAP_REGION_FLAT(			\
 					ARM_DRAM2_BASE,			\
 					ARM_DRAM2_SIZE,			\
-					MT_MEMORY | MT_RW | MT_NS)
+					MT_MEMORY | MT_RW | MT_NS |	\
+					MT_CONTIG)
 
 #define ARM_MAP_TSP_SEC_MEM	MAP_REGION_FLAT(			\
 					TSP_SEC_MEM_BASE,		\
@@ -323,7 +330,8 @@ MEASURED_BOOT
 #define ARM_MAP_BL31_SEC_DRAM	MAP_REGION_FLAT(			\
 					BL31_BASE,			\
 					PLAT_ARM_MAX_BL31_SIZE,		\
-					MT_MEMORY | MT_RW | MT_SECURE)
+					MT_MEMORY | MT_RW | MT_SECURE |	\
+					MT_CONTIG)
 #endif
 
 #define ARM_MAP_EL3_TZC_DRAM	MAP_REGION_FLAT(			\
@@ -334,7 +342,8 @@ MEASURED_BOOT
 #define ARM_MAP_TRUSTED_DRAM	MAP_REGION_FLAT(			\
 					PLAT_ARM_TRUSTED_DRAM_BASE,	\
 					PLAT_ARM_TRUSTED_DRAM_SIZE,	\
-					MT_MEMORY | MT_RW | MT_SECURE)
+					MT_MEMORY | MT_RW | MT_SECURE |	\
+					MT_CONTIG)
 
 # if (defined(SPD_tspd) || defined(SPD_opteed) || defined(SPD_spmd)) && \
 MEASURED_BOOT
@@ -374,7 +383,8 @@ MEASURED_BOOT
  * Mapping for the BL1 RW region. This mapping is needed by BL2 in order to
  * share the Mbed TLS heap. Since the heap is allocated inside BL1, it resides
  * in the BL1 RW region. Hence, BL2 needs access to the BL1 RW region in order
- * to be able to access the heap.
+ * to be able to access the heap. The same applies to the verified certificate
+ * cache when AUTH_VERIFIED_CACHE is enabled.
  */
 #define ARM_MAP_BL1_RW		MAP_REGION_FLAT(	\
 					BL1_RW_BASE,	\
@@ -542,6 +552,12 @@ MEASURED_BOOT
 #define ARM_FW_CONFIGS_SIZE		(PAGE_SIZE * 2)
 #define ARM_FW_CONFIGS_LIMIT		(ARM_BL_RAM_BASE + ARM_FW_CONFIGS_SIZE)
 
+/*
+ * Size of the transfer list in the BL1 RW data that holds the certificates
+ * verified by BL1 for BL2, when AUTH_VERIFIED_CACHE is enabled.
+ */
+#define ARM_AUTH_CACHE_SIZE		U(0x800)
+
 #if ENABLE_RME
 /*
  * Store the L0 GPT on Trusted SRAM next to firmware
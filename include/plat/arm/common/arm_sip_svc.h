@@ -25,6 +25,9 @@
 /* DEBUGFS_SMC_32			0x82000030U */
 /* DEBUGFS_SMC_64			0xC2000030U */
 
+/* Function ID for reading the deferred console output of BL31 */
+#define ARM_SIP_SVC_CONSOLE_LOG_READ	U(0xC2000040)
+
 /*
  * Arm(R) Ethos(TM)-N NPU SiP SMC function IDs
  * 0xC2000050-0xC200005F
@@ -128,6 +128,27 @@
 					/* 0x1B3 */
 #define RMM_ATTEST_GET_PLAT_TOKEN	SMC64_RMMD_EL3_FID(U(3))
 
+/*
+ * Delegate or undelegate a range of contiguous granules in a single call.
+ * The arguments to these SMCs are :
+ *    arg0 - Function ID.
+ *    arg1 - PA of the first granule of the range.
+ *    arg2 - Number of granules in the range.
+ * The return arguments are :
+ *    ret0 - Status / error.
+ *    ret1 - Number of granules transitioned.
+ * At most RMM_GTSI_RANGE_MAX_GRANULES granules are transitioned per call, the
+ * caller must issue further calls for the rest of the range. The PAS of the
+ * granules handled by a call is only changed if every one of them can be
+ * transitioned, otherwise none is and ret1 is 0.
+ */
+					/* 0x1B4 - 0x1B5 */
+#define RMM_GTSI_DELEGATE_RANGE		SMC64_RMMD_EL3_FID(U(4))
+#define RMM_GTSI_UNDELEGATE_RANGE	SMC64_RMMD_EL3_FID(U(5))
+
+/* Largest number of granules transitioned by one RMM_GTSI_*_RANGE call */
+#define RMM_GTSI_RANGE_MAX_GRANULES	U(512)
+
 /* ECC Curve types for attest key generation */
 #define ATTEST_KEY_CURVE_ECC_SECP384R1		0
 
@@ -152,7 +173,7 @@
  * Increase this when a bug is fixed, or a feature is added without
  * breaking compatibility.
  */
-#define RMM_EL3_IFC_VERSION_MINOR	(U(2))
+#define RMM_EL3_IFC_VERSION_MINOR	(U(3))
 
 #define RMM_EL3_INTERFACE_VERSION				\
 	(((RMM_EL3_IFC_VERSION_MAJOR << 16) & 0x7FFFF) |	\
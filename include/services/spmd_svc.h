@@ -20,6 +20,14 @@ uint64_t spmd_ffa_smc_handler(uint32_t smc_fid,
 			      void *cookie,
 			      void *handle,
 			      uint64_t flags);
+uint64_t spmd_ffa_direct_msg_smc_handler(uint32_t smc_fid,
+					 uint64_t x1,
+					 uint64_t x2,
+					 uint64_t x3,
+					 uint64_t x4,
+					 void *cookie,
+					 void *handle,
+					 uint64_t flags);
 uint64_t spmd_smc_handler(uint32_t smc_fid,
 			  uint64_t x1,
 			  uint64_t x2,
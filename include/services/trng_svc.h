@@ -52,4 +52,16 @@ uintptr_t trng_smc_handler(
 	u_register_t flags
 );
 
+/* Handler to be called to handle TRNG_RND smc calls only */
+uintptr_t trng_rnd_smc_handler(
+	uint32_t smc_fid,
+	u_register_t x1,
+	u_register_t x2,
+	u_register_t x3,
+	u_register_t x4,
+	void *cookie,
+	void *handle,
+	u_register_t flags
+);
+
 #endif /* TRNG_SVC_H */
@@ -20,6 +20,7 @@
 #include <context.h>
 #include <drivers/arm/gicv3.h>
 #include <lib/el3_runtime/context_mgmt.h>
+#include <lib/el3_runtime/cpu_data.h>
 #include <lib/el3_runtime/pubsub_events.h>
 #include <lib/extensions/amu.h>
 #include <lib/extensions/brbe.h>
@@ -31,6 +32,7 @@
 #include <lib/extensions/sys_reg_trace.h>
 #include <lib/extensions/trbe.h>
 #include <lib/extensions/trf.h>
+#include <lib/pmf/pmf.h>
 #include <lib/utils.h>
 
 #if ENABLE_FEAT_TWED
@@ -40,6 +42,8 @@ CASSERT(((TWED_DELAY & ~SCR_TWEDEL_MASK) == 0U), assert_twed_delay_value_check);
 
 static void manage_extensions_nonsecure(cpu_context_t *ctx);
 static void manage_extensions_secure(cpu_context_t *ctx);
+static void cm_el1_sysregs_context_restore_groups(uint32_t security_state,
+						  unsigned int groups);
 
 static void setup_el1_context(cpu_context_t *ctx, const struct entry_point_info *ep)
 {
@@ -933,7 +937,7 @@ void cm_prepare_el3_exit(uint32_t security_state)
 		}
 	}
 
-	cm_el1_sysregs_context_restore(security_state);
+	cm_el1_sysregs_context_restore_groups(security_state, CTX_EL1_REGS_ALL);
 	cm_set_next_eret_context(security_state);
 }
 
@@ -1170,6 +1174,10 @@ void cm_el2_sysregs_context_save(uint32_t security_state)
 	cpu_context_t *ctx;
 	el2_sysregs_t *el2_sysregs_ctx;
 
+#if IMAGE_BL31 && PMF_LATENCY_HIST
+	pmf_latency_hist_switch_start();
+#endif
+
 	ctx = cm_get_context(security_state);
 	assert(ctx != NULL);
 
@@ -1305,6 +1313,10 @@ void cm_el2_sysregs_context_restore(uint32_t security_state)
 		write_gcscr_el2(read_ctx_reg(el2_sysregs_ctx, CTX_GCSCR_EL2));
 		write_gcspr_el2(read_ctx_reg(el2_sysregs_ctx, CTX_GCSPR_EL2));
 	}
+
+#if IMAGE_BL31 && PMF_LATENCY_HIST
+	pmf_latency_hist_switch_end();
+#endif
 }
 #endif /* CTX_INCLUDE_EL2_REGS */
 
@@ -1329,13 +1341,56 @@ void cm_prepare_el3_exit_ns(void)
 
 	/* Restore EL2 and EL1 sysreg contexts */
 	cm_el2_sysregs_context_restore(NON_SECURE);
-	cm_el1_sysregs_context_restore(NON_SECURE);
+	cm_el1_sysregs_context_restore_groups(NON_SECURE, CTX_EL1_REGS_ALL);
 	cm_set_next_eret_context(NON_SECURE);
 #else
 	cm_prepare_el3_exit(NON_SECURE);
 #endif /* CTX_INCLUDE_EL2_REGS */
 }
 
+/*******************************************************************************
+ * Groups of EL1 system registers skipped by cm_el1_sysregs_context_save() and
+ * cm_el1_sysregs_context_restore() for each security state. None of them are
+ * skipped unless the runtime service that owns a security state declares
+ * otherwise with cm_set_el1_sysregs_groups().
+ ******************************************************************************/
+static unsigned int el1_sysregs_skipped[CPU_CONTEXT_NUM];
+
+static inline unsigned int el1_sysregs_groups(uint32_t security_state)
+{
+	return CTX_EL1_REGS_ALL & ~el1_sysregs_skipped[security_state];
+}
+
+/*******************************************************************************
+ * This function declares the groups of EL1 system registers (CTX_EL1_REGS_*)
+ * that the software running in the given security state, other than the
+ * Non-secure one, modifies or relies on. On a world switch, only those groups
+ * are saved and restored for that security state, and the registers in the
+ * other groups keep the values of the Non-secure world. The Non-secure world
+ * switches the union of the groups declared for the other security states.
+ *
+ * The registers outside of these groups are not kept up to date in the saved
+ * contexts of either world. This must be called during the initialisation of
+ * the runtime service, before any world switch.
+ ******************************************************************************/
+void cm_set_el1_sysregs_groups(uint32_t security_state, unsigned int groups)
+{
+	unsigned int ns_groups = 0U;
+
+	assert(security_state < CPU_CONTEXT_NUM);
+	assert(security_state != NON_SECURE);
+	assert((groups & ~CTX_EL1_REGS_ALL) == 0U);
+
+	el1_sysregs_skipped[security_state] = CTX_EL1_REGS_ALL & ~groups;
+
+	for (uint32_t i = 0U; i < CPU_CONTEXT_NUM; i++) {
+		if (i != NON_SECURE) {
+			ns_groups |= el1_sysregs_groups(i);
+		}
+	}
+	el1_sysregs_skipped[NON_SECURE] = CTX_EL1_REGS_ALL & ~ns_groups;
+}
+
 /*******************************************************************************
  * The next four functions are used by runtime services to save and restore
  * EL1 context on the 'cpu_context' structure for the specified security
@@ -1345,10 +1400,15 @@ void cm_el1_sysregs_context_save(uint32_t security_state)
 {
 	cpu_context_t *ctx;
 
+#if IMAGE_BL31 && PMF_LATENCY_HIST
+	pmf_latency_hist_switch_start();
+#endif
+
 	ctx = cm_get_context(security_state);
 	assert(ctx != NULL);
 
-	el1_sysregs_context_save(get_el1_sysregs_ctx(ctx));
+	el1_sysregs_context_save(get_el1_sysregs_ctx(ctx),
+				 el1_sysregs_groups(security_state));
 
 #if IMAGE_BL31
 	if (security_state == SECURE)
@@ -1358,14 +1418,19 @@ void cm_el1_sysregs_context_save(uint32_t security_state)
 #endif
 }
 
-void cm_el1_sysregs_context_restore(uint32_t security_state)
+/*
+ * Restore the given groups of EL1 system registers. The first entry into a
+ * world after its context has been initialised restores all of them.
+ */
+static void cm_el1_sysregs_context_restore_groups(uint32_t security_state,
+						  unsigned int groups)
 {
 	cpu_context_t *ctx;
 
 	ctx = cm_get_context(security_state);
 	assert(ctx != NULL);
 
-	el1_sysregs_context_restore(get_el1_sysregs_ctx(ctx));
+	el1_sysregs_context_restore(get_el1_sysregs_ctx(ctx), groups);
 
 #if IMAGE_BL31
 	if (security_state == SECURE)
@@ -1373,6 +1438,16 @@ void cm_el1_sysregs_context_restore(uint32_t security_state)
 	else
 		PUBLISH_EVENT(cm_entering_normal_world);
 #endif
+
+#if IMAGE_BL31 && PMF_LATENCY_HIST
+	pmf_latency_hist_switch_end();
+#endif
+}
+
+void cm_el1_sysregs_context_restore(uint32_t security_state)
+{
+	cm_el1_sysregs_context_restore_groups(security_state,
+					      el1_sysregs_groups(security_state));
 }
 
 /*******************************************************************************
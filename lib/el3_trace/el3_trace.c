@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <arch_helpers.h>
+#include <common/debug.h>
+#include <context.h>
+#include <lib/el3_trace.h>
+#include <lib/utils.h>
+#include <plat/common/platform.h>
+#include <platform_def.h>
+
+/*
+ * Number of records written to the ring of each CPU. This is kept in Secure
+ * memory so that the Non-secure world, which can write the trace buffer,
+ * cannot redirect the writes of EL3 outside of the rings.
+ */
+typedef struct el3_trace_cpu {
+	uint64_t count;
+} __aligned(CACHE_WRITEBACK_GRANULE) el3_trace_cpu_t;
+
+static el3_trace_cpu_t el3_trace_cpus[PLATFORM_CORE_COUNT];
+
+/* Trace buffer geometry, 0 until the trace buffer is initialised */
+static uintptr_t el3_trace_base;
+static size_t el3_trace_ring_size;
+static unsigned int el3_trace_nr_records;
+
+static el3_trace_ring_hdr_t *el3_trace_ring(unsigned int cpu)
+{
+	return (el3_trace_ring_hdr_t *)(el3_trace_base + EL3_TRACE_HDR_SIZE +
+					(cpu * el3_trace_ring_size));
+}
+
+/*
+ * This function lays out the trace buffer provided by the platform at
+ * PLAT_EL3_TRACE_BASE. The buffer must be mapped as Non-secure read-write
+ * memory in BL31. Tracing stays disabled if the buffer is too small.
+ */
+void __init el3_trace_init(void)
+{
+	el3_trace_hdr_t *hdr = (el3_trace_hdr_t *)PLAT_EL3_TRACE_BASE;
+	size_t ring_size;
+	unsigned int nr_records;
+
+	assert((PLAT_EL3_TRACE_BASE % CACHE_WRITEBACK_GRANULE) == 0U);
+
+	if (PLAT_EL3_TRACE_SIZE <= EL3_TRACE_HDR_SIZE) {
+		WARN("EL3 trace buffer too small\n");
+		return;
+	}
+
+	ring_size = (PLAT_EL3_TRACE_SIZE - EL3_TRACE_HDR_SIZE) /
+		    PLATFORM_CORE_COUNT;
+	if (ring_size < (EL3_TRACE_RING_HDR_SIZE + EL3_TRACE_RECORD_SIZE)) {
+		WARN("EL3 trace buffer too small\n");
+		return;
+	}
+
+	/* Round the number of records down to a power of two */
+	nr_records = (unsigned int)((ring_size - EL3_TRACE_RING_HDR_SIZE) /
+				    EL3_TRACE_RECORD_SIZE);
+	nr_records = 1U << (31U - (unsigned int)__builtin_clz(nr_records));
+	ring_size = EL3_TRACE_RING_HDR_SIZE +
+		    ((size_t)nr_records * EL3_TRACE_RECORD_SIZE);
+
+	zeromem(hdr, EL3_TRACE_HDR_SIZE + (PLATFORM_CORE_COUNT * ring_size));
+
+	hdr->version = EL3_TRACE_VERSION;
+	hdr->nr_cpus = PLATFORM_CORE_COUNT;
+	hdr->nr_records = nr_records;
+	hdr->record_size = EL3_TRACE_RECORD_SIZE;
+	hdr->ring_offset = EL3_TRACE_HDR_SIZE;
+	hdr->ring_size = (uint32_t)ring_size;
+	hdr->cntfrq = read_cntfrq_el0();
+
+	/* Publish the header only once it is complete */
+	dmbishst();
+	hdr->magic = EL3_TRACE_MAGIC;
+
+	el3_trace_base = PLAT_EL3_TRACE_BASE;
+	el3_trace_ring_size = ring_size;
+	el3_trace_nr_records = nr_records;
+
+	INFO("EL3 trace: %u records per CPU at 0x%lx\n", nr_records,
+	     el3_trace_base);
+}
+
+/*
+ * This function appends a record to the ring of the current CPU. Each CPU
+ * only writes its own ring, with interrupts masked, so no locking is needed.
+ * It must be called with the data cache enabled.
+ */
+void el3_trace_event(uint32_t event, uint64_t arg0, uint64_t arg1)
+{
+	el3_trace_cpu_t *trace_cpu;
+	el3_trace_ring_hdr_t *ring;
+	el3_trace_record_t *rec;
+	unsigned int cpu;
+	uint64_t count;
+
+	if (el3_trace_nr_records == 0U) {
+		return;
+	}
+
+	cpu = plat_my_core_pos();
+	trace_cpu = &el3_trace_cpus[cpu];
+	count = trace_cpu->count;
+
+	ring = el3_trace_ring(cpu);
+	rec = (el3_trace_record_t *)(ring + 1) +
+	      (count & (el3_trace_nr_records - 1U));
+
+	/* Mark the record as being written */
+	rec->seq = (rec->seq + 1U) | 1U;
+	dmbishst();
+
+	rec->timestamp = read_cntpct_el0();
+	rec->event = event;
+	rec->arg0 = arg0;
+	rec->arg1 = arg1;
+
+	/* Mark the record as complete, then make it visible through the head */
+	dmbishst();
+	rec->seq++;
+	dmbishst();
+
+	trace_cpu->count = count + 1U;
+	ring->head = count + 1U;
+}
+
+/*
+ * These functions are called from the SMC exception path, before and after
+ * the SMC handler. On exit, `handle` is the context of the security state the
+ * SMC returns to.
+ */
+void el3_trace_smc_entry(uint32_t smc_fid, uint64_t x1)
+{
+	el3_trace_event(EL3_TRACE_SMC_ENTRY, smc_fid, x1);
+}
+
+void el3_trace_smc_exit(uint32_t smc_fid, const void *handle)
+{
+	const cpu_context_t *ctx = handle;
+
+	el3_trace_event(EL3_TRACE_SMC_EXIT, smc_fid,
+			read_ctx_reg(get_gpregs_ctx(ctx), CTX_GPREG_X0));
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2022-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -10,10 +10,13 @@
 #include <limits.h>
 #include <stdint.h>
 
+#include <platform_def.h>
+
 #include <arch.h>
 #include <arch_helpers.h>
 #include <common/debug.h>
 #include "gpt_rme_private.h"
+#include <lib/cassert.h>
 #include <lib/gpt_rme/gpt_rme.h>
 #include <lib/smccc.h>
 #include <lib/spinlock.h>
@@ -525,6 +528,130 @@ static void gpt_fill_l1_tbl(uint64_t gpi, uint64_t *l1, uintptr_t first,
 	}
 }
 
+/*
+ * Helper function to get the granules descriptor equivalent to an L1
+ * descriptor, so that contiguous descriptors can be compared against and
+ * masked like granules descriptors.
+ *
+ * Parameters
+ *   desc		L1 descriptor.
+ *
+ * Return
+ *   Granules descriptor giving every granule the GPI described by desc.
+ */
+static uint64_t gpt_l1_desc_expand(uint64_t desc)
+{
+	if (GPT_L1_IS_CONT_DESC(desc)) {
+		return GPT_BUILD_L1_DESC(GPT_L1_CONTD_GPI(desc));
+	}
+	return desc;
+}
+
+/*
+ * Helper function to replace the L1 descriptors of naturally aligned blocks
+ * that have the same GPI for every granule by contiguous descriptors, so that
+ * the GPC can cache the whole block in a single TLB entry. Blocks are merged
+ * from the smallest to the largest size allowed by RME_GPT_MAX_BLOCK, every
+ * block that intersects the range is considered. The GPI of the granules is
+ * unchanged so no TLB maintenance is needed beyond what the caller does.
+ *
+ * Parameters
+ *   l1			Pointer to the L1 table describing the range.
+ *   first		Address of first granule in range.
+ *   last		Address of last granule in range (inclusive).
+ *   gpi		GPI of the granules in the range.
+ */
+static void gpt_l1_fuse(uint64_t *l1, uint64_t first, uint64_t last,
+			unsigned int gpi)
+{
+	uint64_t block_size;
+	uint64_t block_pa;
+	uint64_t expected;
+	uint64_t desc;
+	unsigned int contig;
+	unsigned int count;
+	unsigned int stride;
+	unsigned int idx;
+	unsigned int i;
+
+	assert(GPT_L0_IDX(first) == GPT_L0_IDX(last));
+
+	for (contig = GPT_L1_CONTIG_2MB; contig <= GPT_L1_CONTIG_MAX;
+	     contig++) {
+		block_size = GPT_L1_CONTIG_SIZE(contig);
+		count = (unsigned int)(block_size >>
+				       GPT_L1_IDX_SHIFT(gpt_config.p));
+
+		/*
+		 * A block can only be merged once all the smaller blocks it
+		 * contains have been, so only the first descriptor of each of
+		 * them needs to be checked.
+		 */
+		if (contig == GPT_L1_CONTIG_2MB) {
+			stride = 1U;
+			expected = GPT_BUILD_L1_DESC(gpi);
+		} else {
+			stride = (unsigned int)(GPT_L1_CONTIG_SIZE(contig - 1U) >>
+						GPT_L1_IDX_SHIFT(gpt_config.p));
+			expected = GPT_L1_CONT_DESC(gpi, contig - 1U);
+		}
+		desc = GPT_L1_CONT_DESC(gpi, contig);
+
+		for (block_pa = first & ~(block_size - 1UL); block_pa <= last;
+		     block_pa += block_size) {
+			idx = GPT_L1_IDX(gpt_config.p, block_pa);
+
+			/* Skip blocks already part of a block this large. */
+			if (GPT_L1_IS_CONT_DESC(l1[idx]) &&
+			    (GPT_L1_CONTD_CONTIG(l1[idx]) >= contig)) {
+				continue;
+			}
+
+			for (i = 0U; i < count; i += stride) {
+				if (l1[idx + i] != expected) {
+					break;
+				}
+			}
+			if (i < count) {
+				continue;
+			}
+
+			for (i = 0U; i < count; i++) {
+				l1[idx + i] = desc;
+			}
+		}
+	}
+}
+
+/*
+ * Helper function to turn the contiguous descriptors of the block containing
+ * an L1 descriptor back into granules descriptors, so that the GPI of single
+ * granules within it can be changed.
+ *
+ * Parameters
+ *   l1			Pointer to the L1 table.
+ *   idx		Index of the L1 descriptor.
+ */
+static void gpt_l1_shatter(uint64_t *l1, unsigned int idx)
+{
+	uint64_t gpi_field;
+	unsigned int count;
+	unsigned int i;
+
+	if (!GPT_L1_IS_CONT_DESC(l1[idx])) {
+		return;
+	}
+
+	gpi_field = gpt_l1_desc_expand(l1[idx]);
+	count = (unsigned int)(GPT_L1_CONTIG_SIZE(GPT_L1_CONTD_CONTIG(l1[idx])) >>
+			       GPT_L1_IDX_SHIFT(gpt_config.p));
+	idx &= ~(count - 1U);
+
+	for (i = 0U; i < count; i++) {
+		l1[idx + i] = gpi_field;
+	}
+}
+
 /*
  * This function finds the next available unused L1 table and initializes all
  * granules descriptor entries to GPI_ANY. This ensures that there are no chunks
@@ -624,6 +751,16 @@ static void gpt_generate_l0_tbl_desc(pas_region_t *pas)
 		gpt_fill_l1_tbl(GPT_PAS_ATTR_GPI(pas->attrs), l1_gpt_arr,
 				cur_pa, last_gran_pa);
 
+		/*
+		 * Describe the blocks that now have a single GPI with
+		 * contiguous descriptors. Memory left as GPI_ANY is not merged
+		 * so that later PAS regions can still be carved out of it.
+		 */
+		if (GPT_PAS_ATTR_GPI(pas->attrs) != GPT_GPI_ANY) {
+			gpt_l1_fuse(l1_gpt_arr, cur_pa, last_gran_pa,
+				    GPT_PAS_ATTR_GPI(pas->attrs));
+		}
+
 		/* Advance cur_pa to first granule in next L0 region. */
 		cur_pa = gpt_get_l1_end_pa(cur_pa, end_pa);
 	}
@@ -954,49 +1091,470 @@ int gpt_runtime_init(void)
 }
 
 /*
- * The L1 descriptors are protected by a spinlock to ensure that multiple
- * CPUs do not attempt to change the descriptors at once. In the future it
- * would be better to have separate spinlocks for each L1 descriptor.
+ * The L1 descriptors are protected by spinlocks to ensure that multiple
+ * CPUs do not attempt to change the same descriptors at once. Rather than a
+ * single global lock, each L1 table is protected by one of GPT_LOCK_COUNT
+ * locks selected from the L0 index of the region it describes, so that
+ * transitions of granules in different L0 regions can proceed in parallel.
+ * Each lock sits in its own cache line to avoid false sharing between CPUs
+ * contending on different locks.
+ */
+typedef struct {
+	spinlock_t lock;
+} __aligned(CACHE_WRITEBACK_GRANULE) gpt_lock_t;
+
+static gpt_lock_t gpt_locks[GPT_LOCK_COUNT];
+
+/* The set of locks held for a transition is tracked in a 64-bit mask. */
+CASSERT(GPT_LOCK_COUNT <= 64U, assert_gpt_lock_count_fits_mask);
+
+/*
+ * Helper to acquire the locks protecting the L1 tables of all the L0 regions
+ * covered by a range. The locks are taken in ascending order of lock index,
+ * so that CPUs transitioning overlapping ranges cannot deadlock, and a lock
+ * shared by several L0 regions is only taken once.
+ *
+ * Parameters
+ *   base		Base address of the range.
+ *   size		Size of the range.
+ *
+ * Return
+ *   Mask of the acquired locks, to be passed to gpt_unlock_range().
+ */
+static uint64_t gpt_lock_range(uint64_t base, size_t size)
+{
+	uint64_t first_idx = GPT_L0_IDX(base);
+	uint64_t last_idx = GPT_L0_IDX(base + size - 1UL);
+	uint64_t lock_mask = 0ULL;
+	uint64_t idx;
+	unsigned int i;
+
+	if ((last_idx - first_idx) >= (GPT_LOCK_COUNT - 1U)) {
+		lock_mask = UINT64_MAX >> (64U - GPT_LOCK_COUNT);
+	} else {
+		for (idx = first_idx; idx <= last_idx; idx++) {
+			lock_mask |= 1ULL << (idx & (GPT_LOCK_COUNT - 1U));
+		}
+	}
+
+	for (i = 0U; i < GPT_LOCK_COUNT; i++) {
+		if ((lock_mask & (1ULL << i)) != 0ULL) {
+			spin_lock(&gpt_locks[i].lock);
+		}
+	}
+
+	return lock_mask;
+}
+
+/*
+ * Helper to release the locks acquired by gpt_lock_range().
+ *
+ * Parameters
+ *   lock_mask		Mask of the locks to release.
+ */
+static void gpt_unlock_range(uint64_t lock_mask)
+{
+	unsigned int i;
+
+	for (i = GPT_LOCK_COUNT; i > 0U; i--) {
+		if ((lock_mask & (1ULL << (i - 1U))) != 0ULL) {
+			spin_unlock(&gpt_locks[i - 1U].lock);
+		}
+	}
+}
+
+/*
+ * L1 tables whose granules all end up with the same GPI are folded back into
+ * an L0 block descriptor, which saves the GPC a level of walk. The L1 table is
+ * then released to this pool, tagged with the L0 region it was folded from.
+ * Only regions found in the pool may be transitioned while described by a
+ * block descriptor, so memory mapped as blocks at boot stays fixed, and the
+ * table is given back to its region as soon as one of its granules must be
+ * transitioned again. The pool is shared by all L0 regions so it is protected
+ * by its own lock, taken while holding the lock of the region concerned.
+ */
+typedef struct {
+	uint64_t *l1;
+	uint64_t l0_idx;
+} gpt_l1_pool_entry_t;
+
+static gpt_l1_pool_entry_t gpt_l1_pool[GPT_L1_POOL_SIZE];
+static spinlock_t gpt_l1_pool_lock;
+
+/*
+ * Helper to find the pool entry holding the L1 table folded from an L0
+ * region. The caller must hold gpt_l1_pool_lock.
+ *
+ * Parameters
+ *   l0_idx		Index of the L0 region.
+ *
+ * Return
+ *   Pointer to the pool entry, NULL if the region has not been folded.
+ */
+static gpt_l1_pool_entry_t *gpt_l1_pool_find(uint64_t l0_idx)
+{
+	unsigned int i;
+
+	for (i = 0U; i < GPT_L1_POOL_SIZE; i++) {
+		if ((gpt_l1_pool[i].l1 != NULL) &&
+		    (gpt_l1_pool[i].l0_idx == l0_idx)) {
+			return &gpt_l1_pool[i];
+		}
+	}
+
+	return NULL;
+}
+
+/*
+ * Helper to check if an L0 region described by a block descriptor has been
+ * folded from an L1 table, and can therefore be transitioned.
+ *
+ * Parameters
+ *   l0_idx		Index of the L0 region.
+ *
+ * Return
+ *   True if the region has been folded, false if not.
+ */
+static bool gpt_l0_is_folded(uint64_t l0_idx)
+{
+	bool folded;
+
+	spin_lock(&gpt_l1_pool_lock);
+	folded = (gpt_l1_pool_find(l0_idx) != NULL);
+	spin_unlock(&gpt_l1_pool_lock);
+
+	return folded;
+}
+
+/*
+ * Helper to replace the table descriptor of an L0 region by a block
+ * descriptor if every granule of its L1 table has the same GPI. Since
+ * gpt_l1_fuse() merges uniform blocks, this is the case when the whole table
+ * is made of identical contiguous descriptors of the largest size, so only
+ * the first descriptor of each of those blocks has to be read. Nothing is done
+ * if the pool is full. The caller must hold the lock of the region.
+ *
+ * Parameters
+ *   l0_idx		Index of the L0 region.
+ */
+static void gpt_l0_fold(uint64_t l0_idx)
+{
+	uint64_t *l0_gpt_base = (uint64_t *)gpt_config.plat_gpt_l0_base;
+	gpt_l1_pool_entry_t *entry = NULL;
+	uint64_t *l1;
+	uint64_t desc;
+	unsigned int stride;
+	unsigned int i;
+
+	if (GPT_L1_CONTIG_MAX == 0U) {
+		return;
+	}
+
+	l1 = GPT_L0_TBLD_ADDR(l0_gpt_base[l0_idx]);
+	desc = l1[0];
+	if (!GPT_L1_IS_CONT_DESC(desc) ||
+	    (GPT_L1_CONTD_CONTIG(desc) != GPT_L1_CONTIG_MAX)) {
+		return;
+	}
+
+	stride = (unsigned int)(GPT_L1_CONTIG_SIZE(GPT_L1_CONTIG_MAX) >>
+				GPT_L1_IDX_SHIFT(gpt_config.p));
+	for (i = stride; i < GPT_L1_ENTRY_COUNT(gpt_config.p); i += stride) {
+		if (l1[i] != desc) {
+			return;
+		}
+	}
+
+	spin_lock(&gpt_l1_pool_lock);
+	for (i = 0U; i < GPT_L1_POOL_SIZE; i++) {
+		if (gpt_l1_pool[i].l1 == NULL) {
+			entry = &gpt_l1_pool[i];
+			entry->l1 = l1;
+			entry->l0_idx = l0_idx;
+			break;
+		}
+	}
+	spin_unlock(&gpt_l1_pool_lock);
+
+	if (entry == NULL) {
+		return;
+	}
+
+	/*
+	 * The L1 table is left untouched, it still describes the region
+	 * correctly and is reinstated as is by gpt_l0_unfold().
+	 */
+	l0_gpt_base[l0_idx] = GPT_L0_BLK_DESC(GPT_L1_CONTD_GPI(desc));
+
+	VERBOSE("[GPT] L0 entry index %" PRIu64 " folded to BLOCK, GPI 0x%" PRIx64 "\n",
+		l0_idx, GPT_L1_CONTD_GPI(desc));
+}
+
+/*
+ * Helper to take back the L1 table of an L0 region folded by gpt_l0_fold()
+ * and describe the region with a table descriptor again. The caller must hold
+ * the lock of the region, which must have been folded.
+ *
+ * Parameters
+ *   l0_idx		Index of the L0 region.
+ */
+static void gpt_l0_unfold(uint64_t l0_idx)
+{
+	uint64_t *l0_gpt_base = (uint64_t *)gpt_config.plat_gpt_l0_base;
+	gpt_l1_pool_entry_t *entry;
+	uint64_t *l1;
+
+	spin_lock(&gpt_l1_pool_lock);
+	entry = gpt_l1_pool_find(l0_idx);
+	assert(entry != NULL);
+	l1 = entry->l1;
+	entry->l1 = NULL;
+	spin_unlock(&gpt_l1_pool_lock);
+
+	l0_gpt_base[l0_idx] = GPT_L0_TBL_DESC(l1);
+
+	VERBOSE("[GPT] L0 entry index %" PRIu64 " unfolded to TABLE\n", l0_idx);
+}
+
+/*
+ * Helper to compute the mask of the GPI fields in an L1 descriptor that
+ * belong to a range of granules within a single L0 region.
+ *
+ * Parameters
+ *   idx		Index of the L1 descriptor.
+ *   first		Address of first granule in range.
+ *   last		Address of last granule in range (inclusive).
+ *
+ * Return
+ *   Mask of the GPI fields of the descriptor covered by the range.
+ */
+static uint64_t gpt_l1_desc_mask(unsigned int idx, uint64_t first,
+				 uint64_t last)
+{
+	uint64_t gpi_mask = UINT64_MAX;
+
+	/* Account for starting in the middle of an L1 entry. */
+	if (idx == GPT_L1_IDX(gpt_config.p, first)) {
+		gpi_mask <<= GPT_L1_GPI_IDX(gpt_config.p, first) << 2;
+	}
+
+	/* Account for stopping in the middle of an L1 entry. */
+	if (idx == GPT_L1_IDX(gpt_config.p, last)) {
+		gpi_mask &= UINT64_MAX >>
+			    ((15U - GPT_L1_GPI_IDX(gpt_config.p, last)) << 2);
+	}
+
+	return gpi_mask;
+}
+
+/*
+ * Helper to check that every granule in a range is described by an L1 table,
+ * or an L0 block folded from one, and currently has the given GPI. The caller
+ * must hold the locks of the L1 tables covering the range.
+ *
+ * Parameters
+ *   base		Base address of the range, aligned to granule size.
+ *   size		Size of the range, aligned to granule size.
+ *   gpi		Expected GPI.
+ *
+ * Return
+ *   -EINVAL if part of the range is not covered by an L1 table, -EPERM if a
+ *   granule has another GPI, 0 for success.
+ */
+static int gpt_check_range_gpi(uint64_t base, size_t size, unsigned int gpi)
+{
+	uint64_t *l0_gpt_base = (uint64_t *)gpt_config.plat_gpt_l0_base;
+	uint64_t gpi_field = GPT_BUILD_L1_DESC(gpi);
+	uint64_t end_pa = base + size;
+	uint64_t cur_pa = base;
+	uint64_t last_gran_pa;
+	uint64_t gpi_mask;
+	uint64_t l0_desc;
+	uint64_t *l1;
+	unsigned int i;
+
+	while (cur_pa < end_pa) {
+		l0_desc = l0_gpt_base[GPT_L0_IDX(cur_pa)];
+		if ((GPT_L0_TYPE(l0_desc) == GPT_L0_TYPE_BLK_DESC) &&
+		    gpt_l0_is_folded(GPT_L0_IDX(cur_pa))) {
+			if (GPT_L0_BLKD_GPI(l0_desc) != gpi) {
+				VERBOSE("[GPT] L0 entry index %" PRIu64 " (0x%" PRIx64 ") does not have GPI 0x%x\n",
+					GPT_L0_IDX(cur_pa), l0_desc, gpi);
+				return -EPERM;
+			}
+			cur_pa = gpt_get_l1_end_pa(cur_pa, end_pa);
+			continue;
+		}
+
+		if (GPT_L0_TYPE(l0_desc) != GPT_L0_TYPE_TBL_DESC) {
+			VERBOSE("[GPT] Granule is not covered by a table descriptor!\n");
+			VERBOSE("      Base=0x%" PRIx64 "\n", cur_pa);
+			return -EINVAL;
+		}
+
+		l1 = GPT_L0_TBLD_ADDR(l0_desc);
+		last_gran_pa = gpt_get_l1_end_pa(cur_pa, end_pa) -
+			       GPT_PGS_ACTUAL_SIZE(gpt_config.p);
+
+		for (i = GPT_L1_IDX(gpt_config.p, cur_pa);
+		     i <= GPT_L1_IDX(gpt_config.p, last_gran_pa); i++) {
+			gpi_mask = gpt_l1_desc_mask(i, cur_pa, last_gran_pa);
+			if ((gpt_l1_desc_expand(l1[i]) & gpi_mask) !=
+			    (gpi_field & gpi_mask)) {
+				VERBOSE("[GPT] L1 entry index %u [%p] (0x%" PRIx64 ") does not have GPI 0x%x\n",
+					i, &l1[i], l1[i], gpi);
+				return -EPERM;
+			}
+		}
+
+		cur_pa = gpt_get_l1_end_pa(cur_pa, end_pa);
+	}
+
+	return 0;
+}
+
+/*
+ * Helper to set the GPI of every granule in a range. The range must have been
+ * checked with gpt_check_range_gpi() while holding the locks of the L1 tables
+ * covering it. Folded L0 regions get their L1 table back and the contiguous
+ * blocks only partly covered by the range are split into granules first.
+ *
+ * Parameters
+ *   base		Base address of the range, aligned to granule size.
+ *   size		Size of the range, aligned to granule size.
+ *   gpi		GPI to set the range to.
  */
-static spinlock_t gpt_lock;
+static void gpt_write_range_gpi(uint64_t base, size_t size, unsigned int gpi)
+{
+	uint64_t *l0_gpt_base = (uint64_t *)gpt_config.plat_gpt_l0_base;
+	uint64_t gpi_field = GPT_BUILD_L1_DESC(gpi);
+	uint64_t end_pa = base + size;
+	uint64_t cur_pa = base;
+	uint64_t last_gran_pa;
+	uint64_t gpi_mask;
+	uint64_t l0_idx;
+	uint64_t *l1;
+	unsigned int i;
+
+	while (cur_pa < end_pa) {
+		l0_idx = GPT_L0_IDX(cur_pa);
+		if (GPT_L0_TYPE(l0_gpt_base[l0_idx]) == GPT_L0_TYPE_BLK_DESC) {
+			gpt_l0_unfold(l0_idx);
+		}
+
+		l1 = GPT_L0_TBLD_ADDR(l0_gpt_base[l0_idx]);
+		last_gran_pa = gpt_get_l1_end_pa(cur_pa, end_pa) -
+			       GPT_PGS_ACTUAL_SIZE(gpt_config.p);
+
+		/*
+		 * Contiguous blocks fully inside the range are overwritten
+		 * below, only the ones at either end can be partly covered.
+		 */
+		gpt_l1_shatter(l1, GPT_L1_IDX(gpt_config.p, cur_pa));
+		gpt_l1_shatter(l1, GPT_L1_IDX(gpt_config.p, last_gran_pa));
+
+		for (i = GPT_L1_IDX(gpt_config.p, cur_pa);
+		     i <= GPT_L1_IDX(gpt_config.p, last_gran_pa); i++) {
+			gpi_mask = gpt_l1_desc_mask(i, cur_pa, last_gran_pa);
+			l1[i] = (l1[i] & ~gpi_mask) | (gpi_field & gpi_mask);
+		}
+
+		cur_pa = gpt_get_l1_end_pa(cur_pa, end_pa);
+	}
+}
 
 /*
- * A helper to write the value (target_pas << gpi_shift) to the index of
- * the gpt_l1_addr
+ * Helper to merge the descriptors around a range that has just been set to a
+ * single GPI into contiguous descriptors, and to fold the L1 tables that end
+ * up describing a single GPI into L0 block descriptors. The caller must hold
+ * the locks of the L1 tables covering the range, and invalidate the TLBs for
+ * the range afterwards.
+ *
+ * Parameters
+ *   base		Base address of the range, aligned to granule size.
+ *   size		Size of the range, aligned to granule size.
+ *   gpi		GPI of the granules in the range.
  */
-static inline void write_gpt(uint64_t *gpt_l1_desc, uint64_t *gpt_l1_addr,
-			     unsigned int gpi_shift, unsigned int idx,
-			     unsigned int target_pas)
+static void gpt_fuse_range(uint64_t base, size_t size, unsigned int gpi)
 {
-	*gpt_l1_desc &= ~(GPT_L1_GRAN_DESC_GPI_MASK << gpi_shift);
-	*gpt_l1_desc |= ((uint64_t)target_pas << gpi_shift);
-	gpt_l1_addr[idx] = *gpt_l1_desc;
+	uint64_t *l0_gpt_base = (uint64_t *)gpt_config.plat_gpt_l0_base;
+	uint64_t end_pa = base + size;
+	uint64_t cur_pa = base;
+	uint64_t last_gran_pa;
+	uint64_t l0_idx;
+
+	if (GPT_L1_CONTIG_MAX == 0U) {
+		return;
+	}
+
+	while (cur_pa < end_pa) {
+		l0_idx = GPT_L0_IDX(cur_pa);
+		last_gran_pa = gpt_get_l1_end_pa(cur_pa, end_pa) -
+			       GPT_PGS_ACTUAL_SIZE(gpt_config.p);
+
+		gpt_l1_fuse(GPT_L0_TBLD_ADDR(l0_gpt_base[l0_idx]), cur_pa,
+			    last_gran_pa, gpi);
+		gpt_l0_fold(l0_idx);
+
+		cur_pa = gpt_get_l1_end_pa(cur_pa, end_pa);
+	}
 }
 
 /*
- * Helper to retrieve the gpt_l1_* information from the base address
- * returned in gpi_info
+ * Helper to invalidate the TLB entries holding GPT information for a range.
+ * Ranges of more than GPT_TLBI_MAX_GRANULES granules are invalidated with a
+ * single TLBI PAALLOS, which is cheaper than invalidating them one by one.
+ *
+ * Parameters
+ *   base		Base address of the range, aligned to granule size.
+ *   size		Size of the range, aligned to granule size.
  */
-static int get_gpi_params(uint64_t base, gpi_info_t *gpi_info)
+static void gpt_tlbi_range(uint64_t base, size_t size)
 {
-	uint64_t gpt_l0_desc, *gpt_l0_base;
+	size_t gran_size = GPT_PGS_ACTUAL_SIZE(gpt_config.p);
+	uint64_t pa;
+
+	if (size > (GPT_TLBI_MAX_GRANULES * gran_size)) {
+		tlbipaallos();
+		return;
+	}
+
+	for (pa = base; pa < (base + size); pa += gran_size) {
+		gpt_tlbi_by_pa_ll(pa, gran_size);
+	}
+}
 
-	gpt_l0_base = (uint64_t *)gpt_config.plat_gpt_l0_base;
-	gpt_l0_desc = gpt_l0_base[GPT_L0_IDX(base)];
-	if (GPT_L0_TYPE(gpt_l0_desc) != GPT_L0_TYPE_TBL_DESC) {
-		VERBOSE("[GPT] Granule is not covered by a table descriptor!\n");
+/*
+ * Helper to validate the address range of a granule transition request.
+ *
+ * Parameters
+ *   base		Base address of the region to transition.
+ *   size		Size of region to transition.
+ *
+ * Return
+ *   Negative Linux error code in the event of a failure, 0 for success.
+ */
+static int gpt_validate_transition(uint64_t base, size_t size)
+{
+	/* Check that base and size are valid */
+	if ((ULONG_MAX - base) < size) {
+		VERBOSE("[GPT] Transition request address overflow!\n");
 		VERBOSE("      Base=0x%" PRIx64 "\n", base);
+		VERBOSE("      Size=0x%lx\n", size);
 		return -EINVAL;
 	}
 
-	/* Get the table index and GPI shift from PA. */
-	gpi_info->gpt_l1_addr = GPT_L0_TBLD_ADDR(gpt_l0_desc);
-	gpi_info->idx = GPT_L1_IDX(gpt_config.p, base);
-	gpi_info->gpi_shift = GPT_L1_GPI_IDX(gpt_config.p, base) << 2;
+	/* Make sure base and size are valid. */
+	if (((base & (GPT_PGS_ACTUAL_SIZE(gpt_config.p) - 1)) != 0UL) ||
+	    ((size & (GPT_PGS_ACTUAL_SIZE(gpt_config.p) - 1)) != 0UL) ||
+	    (size == 0UL) ||
+	    ((base + size) >= GPT_PPS_ACTUAL_SIZE(gpt_config.t))) {
+		VERBOSE("[GPT] Invalid granule transition address range!\n");
+		VERBOSE("      Base=0x%" PRIx64 "\n", base);
+		VERBOSE("      Size=0x%lx\n", size);
+		return -EINVAL;
+	}
 
-	gpi_info->gpt_l1_desc = (gpi_info->gpt_l1_addr)[gpi_info->idx];
-	gpi_info->gpi = (gpi_info->gpt_l1_desc >> gpi_info->gpi_shift) &
-		GPT_L1_GRAN_DESC_GPI_MASK;
 	return 0;
 }
 
@@ -1005,7 +1563,9 @@ static int get_gpi_params(uint64_t base, gpi_info_t *gpi_info)
  * transition request occurs it is routed to this function to have the request,
  * if valid, fulfilled following A1.1.1 Delegate of RME supplement
  *
- * TODO: implement support for transitioning multiple granules at once.
+ * A range of contiguous granules can be transitioned at once. The request is
+ * only fulfilled if every granule in the range can be delegated, and the cache
+ * maintenance and TLB invalidation are then done once for the whole range.
  *
  * Parameters
  *   base		Base address of the region to transition, must be
@@ -1019,7 +1579,7 @@ static int get_gpi_params(uint64_t base, gpi_info_t *gpi_info)
  */
 int gpt_delegate_pas(uint64_t base, size_t size, unsigned int src_sec_state)
 {
-	gpi_info_t gpi_info;
+	uint64_t lock_mask;
 	uint64_t nse;
 	int res;
 	unsigned int target_pas;
@@ -1034,28 +1594,9 @@ int gpt_delegate_pas(uint64_t base, size_t size, unsigned int src_sec_state)
 	assert(src_sec_state == SMC_FROM_REALM ||
 	       src_sec_state == SMC_FROM_SECURE);
 
-	/* See if this is a single or a range of granule transition. */
-	if (size != GPT_PGS_ACTUAL_SIZE(gpt_config.p)) {
-		return -EINVAL;
-	}
-
-	/* Check that base and size are valid */
-	if ((ULONG_MAX - base) < size) {
-		VERBOSE("[GPT] Transition request address overflow!\n");
-		VERBOSE("      Base=0x%" PRIx64 "\n", base);
-		VERBOSE("      Size=0x%lx\n", size);
-		return -EINVAL;
-	}
-
-	/* Make sure base and size are valid. */
-	if (((base & (GPT_PGS_ACTUAL_SIZE(gpt_config.p) - 1)) != 0UL) ||
-	    ((size & (GPT_PGS_ACTUAL_SIZE(gpt_config.p) - 1)) != 0UL) ||
-	    (size == 0UL) ||
-	    ((base + size) >= GPT_PPS_ACTUAL_SIZE(gpt_config.t))) {
-		VERBOSE("[GPT] Invalid granule transition address range!\n");
-		VERBOSE("      Base=0x%" PRIx64 "\n", base);
-		VERBOSE("      Size=0x%lx\n", size);
-		return -EINVAL;
+	res = gpt_validate_transition(base, size);
+	if (res != 0) {
+		return res;
 	}
 
 	target_pas = GPT_GPI_REALM;
@@ -1064,26 +1605,24 @@ int gpt_delegate_pas(uint64_t base, size_t size, unsigned int src_sec_state)
 	}
 
 	/*
-	 * Access to L1 tables is controlled by a global lock to ensure
-	 * that no more than one CPU is allowed to make changes at any
+	 * Access to each L1 table is controlled by a lock to ensure that
+	 * no more than one CPU is allowed to make changes to it at any
 	 * given time.
 	 */
-	spin_lock(&gpt_lock);
-	res = get_gpi_params(base, &gpi_info);
+	lock_mask = gpt_lock_range(base, size);
+
+	/* Check that the whole range is in NS state */
+	res = gpt_check_range_gpi(base, size, GPT_GPI_NS);
 	if (res != 0) {
-		spin_unlock(&gpt_lock);
+		if (res == -EPERM) {
+			VERBOSE("[GPT] Only Granule in NS state can be delegated.\n");
+			VERBOSE("      Caller: %u, Base=0x%" PRIx64 ", Size=0x%lx\n",
+				src_sec_state, base, size);
+		}
+		gpt_unlock_range(lock_mask);
 		return res;
 	}
 
-	/* Check that the current address is in NS state */
-	if (gpi_info.gpi != GPT_GPI_NS) {
-		VERBOSE("[GPT] Only Granule in NS state can be delegated.\n");
-		VERBOSE("      Caller: %u, Current GPI: %u\n", src_sec_state,
-			gpi_info.gpi);
-		spin_unlock(&gpt_lock);
-		return -EPERM;
-	}
-
 	if (src_sec_state == SMC_FROM_SECURE) {
 		nse = (uint64_t)GPT_NSE_SECURE << GPT_NSE_SHIFT;
 	} else {
@@ -1095,30 +1634,28 @@ int gpt_delegate_pas(uint64_t base, size_t size, unsigned int src_sec_state)
 	 * states, remove any data speculatively fetched into the target
 	 * physical address space. Issue DC CIPAPA over address range
 	 */
-	flush_dcache_to_popa_range(nse | base,
-				   GPT_PGS_ACTUAL_SIZE(gpt_config.p));
+	flush_dcache_to_popa_range(nse | base, size);
 
-	write_gpt(&gpi_info.gpt_l1_desc, gpi_info.gpt_l1_addr,
-		  gpi_info.gpi_shift, gpi_info.idx, target_pas);
+	gpt_write_range_gpi(base, size, target_pas);
+	gpt_fuse_range(base, size, target_pas);
 	dsboshst();
 
-	gpt_tlbi_by_pa_ll(base, GPT_PGS_ACTUAL_SIZE(gpt_config.p));
+	gpt_tlbi_range(base, size);
 	dsbosh();
 
 	nse = (uint64_t)GPT_NSE_NS << GPT_NSE_SHIFT;
 
-	flush_dcache_to_popa_range(nse | base,
-				   GPT_PGS_ACTUAL_SIZE(gpt_config.p));
+	flush_dcache_to_popa_range(nse | base, size);
 
 	/* Unlock access to the L1 tables. */
-	spin_unlock(&gpt_lock);
+	gpt_unlock_range(lock_mask);
 
 	/*
 	 * The isb() will be done as part of context
 	 * synchronization when returning to lower EL
 	 */
-	VERBOSE("[GPT] Granule 0x%" PRIx64 ", GPI 0x%x->0x%x\n",
-		base, gpi_info.gpi, target_pas);
+	VERBOSE("[GPT] Granules 0x%" PRIx64 "-0x%" PRIx64 ", GPI 0x%x->0x%x\n",
+		base, base + size - 1UL, GPT_GPI_NS, target_pas);
 
 	return 0;
 }
@@ -1128,7 +1665,10 @@ int gpt_delegate_pas(uint64_t base, size_t size, unsigned int src_sec_state)
  * transition request occurs it is routed to this function where the request is
  * validated then fulfilled if possible.
  *
- * TODO: implement support for transitioning multiple granules at once.
+ * A range of contiguous granules can be transitioned at once. The request is
+ * only fulfilled if every granule in the range can be undelegated, and the
+ * cache maintenance and TLB invalidation are then done once for the whole
+ * range.
  *
  * Parameters
  *   base		Base address of the region to transition, must be
@@ -1142,9 +1682,10 @@ int gpt_delegate_pas(uint64_t base, size_t size, unsigned int src_sec_state)
  */
 int gpt_undelegate_pas(uint64_t base, size_t size, unsigned int src_sec_state)
 {
-	gpi_info_t gpi_info;
+	uint64_t lock_mask;
 	uint64_t nse;
 	int res;
+	unsigned int current_pas;
 
 	/* Ensure that the tables have been set up before taking requests. */
 	assert(gpt_config.plat_gpt_l0_base != 0UL);
@@ -1156,66 +1697,44 @@ int gpt_undelegate_pas(uint64_t base, size_t size, unsigned int src_sec_state)
 	assert(src_sec_state == SMC_FROM_REALM ||
 	       src_sec_state == SMC_FROM_SECURE);
 
-	/* See if this is a single or a range of granule transition. */
-	if (size != GPT_PGS_ACTUAL_SIZE(gpt_config.p)) {
-		return -EINVAL;
-	}
-
-	/* Check that base and size are valid */
-	if ((ULONG_MAX - base) < size) {
-		VERBOSE("[GPT] Transition request address overflow!\n");
-		VERBOSE("      Base=0x%" PRIx64 "\n", base);
-		VERBOSE("      Size=0x%lx\n", size);
-		return -EINVAL;
+	res = gpt_validate_transition(base, size);
+	if (res != 0) {
+		return res;
 	}
 
-	/* Make sure base and size are valid. */
-	if (((base & (GPT_PGS_ACTUAL_SIZE(gpt_config.p) - 1)) != 0UL) ||
-	    ((size & (GPT_PGS_ACTUAL_SIZE(gpt_config.p) - 1)) != 0UL) ||
-	    (size == 0UL) ||
-	    ((base + size) >= GPT_PPS_ACTUAL_SIZE(gpt_config.t))) {
-		VERBOSE("[GPT] Invalid granule transition address range!\n");
-		VERBOSE("      Base=0x%" PRIx64 "\n", base);
-		VERBOSE("      Size=0x%lx\n", size);
-		return -EINVAL;
+	current_pas = GPT_GPI_REALM;
+	if (src_sec_state == SMC_FROM_SECURE) {
+		current_pas = GPT_GPI_SECURE;
 	}
 
 	/*
-	 * Access to L1 tables is controlled by a global lock to ensure
-	 * that no more than one CPU is allowed to make changes at any
+	 * Access to each L1 table is controlled by a lock to ensure that
+	 * no more than one CPU is allowed to make changes to it at any
 	 * given time.
 	 */
-	spin_lock(&gpt_lock);
+	lock_mask = gpt_lock_range(base, size);
 
-	res = get_gpi_params(base, &gpi_info);
+	/* Check that the whole range is in the delegated state */
+	res = gpt_check_range_gpi(base, size, current_pas);
 	if (res != 0) {
-		spin_unlock(&gpt_lock);
+		if (res == -EPERM) {
+			VERBOSE("[GPT] Only Granule in REALM or SECURE state can be undelegated.\n");
+			VERBOSE("      Caller: %u, Base=0x%" PRIx64 ", Size=0x%lx\n",
+				src_sec_state, base, size);
+		}
+		gpt_unlock_range(lock_mask);
 		return res;
 	}
 
-	/* Check that the current address is in the delegated state */
-	if ((src_sec_state == SMC_FROM_REALM  &&
-	     gpi_info.gpi != GPT_GPI_REALM) ||
-	    (src_sec_state == SMC_FROM_SECURE &&
-	     gpi_info.gpi != GPT_GPI_SECURE)) {
-		VERBOSE("[GPT] Only Granule in REALM or SECURE state can be undelegated.\n");
-		VERBOSE("      Caller: %u, Current GPI: %u\n", src_sec_state,
-			gpi_info.gpi);
-		spin_unlock(&gpt_lock);
-		return -EPERM;
-	}
-
-
 	/* In order to maintain mutual distrust between Realm and Secure
 	 * states, remove access now, in order to guarantee that writes
 	 * to the currently-accessible physical address space will not
 	 * later become observable.
 	 */
-	write_gpt(&gpi_info.gpt_l1_desc, gpi_info.gpt_l1_addr,
-		  gpi_info.gpi_shift, gpi_info.idx, GPT_GPI_NO_ACCESS);
+	gpt_write_range_gpi(base, size, GPT_GPI_NO_ACCESS);
 	dsboshst();
 
-	gpt_tlbi_by_pa_ll(base, GPT_PGS_ACTUAL_SIZE(gpt_config.p));
+	gpt_tlbi_range(base, size);
 	dsbosh();
 
 	if (src_sec_state == SMC_FROM_SECURE) {
@@ -1225,8 +1744,7 @@ int gpt_undelegate_pas(uint64_t base, size_t size, unsigned int src_sec_state)
 	}
 
 	/* Ensure that the scrubbed data has made it past the PoPA */
-	flush_dcache_to_popa_range(nse | base,
-				   GPT_PGS_ACTUAL_SIZE(gpt_config.p));
+	flush_dcache_to_popa_range(nse | base, size);
 
 	/*
 	 * Remove any data loaded speculatively
@@ -1234,27 +1752,26 @@ int gpt_undelegate_pas(uint64_t base, size_t size, unsigned int src_sec_state)
 	 */
 	nse = (uint64_t)GPT_NSE_NS << GPT_NSE_SHIFT;
 
-	flush_dcache_to_popa_range(nse | base,
-				   GPT_PGS_ACTUAL_SIZE(gpt_config.p));
+	flush_dcache_to_popa_range(nse | base, size);
 
-	/* Clear existing GPI encoding and transition granule. */
-	write_gpt(&gpi_info.gpt_l1_desc, gpi_info.gpt_l1_addr,
-		  gpi_info.gpi_shift, gpi_info.idx, GPT_GPI_NS);
+	/* Clear existing GPI encoding and transition granules. */
+	gpt_write_range_gpi(base, size, GPT_GPI_NS);
+	gpt_fuse_range(base, size, GPT_GPI_NS);
 	dsboshst();
 
 	/* Ensure that all agents observe the new NS configuration */
-	gpt_tlbi_by_pa_ll(base, GPT_PGS_ACTUAL_SIZE(gpt_config.p));
+	gpt_tlbi_range(base, size);
 	dsbosh();
 
 	/* Unlock access to the L1 tables. */
-	spin_unlock(&gpt_lock);
+	gpt_unlock_range(lock_mask);
 
 	/*
 	 * The isb() will be done as part of context
 	 * synchronization when returning to lower EL
 	 */
-	VERBOSE("[GPT] Granule 0x%" PRIx64 ", GPI 0x%x->0x%x\n",
-		base, gpi_info.gpi, GPT_GPI_NS);
+	VERBOSE("[GPT] Granules 0x%" PRIx64 "-0x%" PRIx64 ", GPI 0x%x->0x%x\n",
+		base, base + size - 1UL, current_pas, GPT_GPI_NS);
 
 	return 0;
 }
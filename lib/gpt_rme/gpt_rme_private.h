@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2022-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -19,7 +19,7 @@
 #define GPT_L0_TYPE_MASK		UL(0xF)
 #define GPT_L0_TYPE_SHIFT		U(0)
 
-/* For now, we don't support contiguous descriptors, only table and block. */
+/* L0 contiguous descriptors are not used, only table and block. */
 #define GPT_L0_TYPE_TBL_DESC		UL(0x3)
 #define GPT_L0_TYPE_BLK_DESC		UL(0x1)
 
@@ -32,6 +32,24 @@
 /* GPT level 1 descriptor bit definitions */
 #define GPT_L1_GRAN_DESC_GPI_MASK	UL(0xF)
 
+#define GPT_L1_TYPE_MASK		UL(0xF)
+#define GPT_L1_TYPE_CONT_DESC		UL(0x1)
+
+#define GPT_L1_CONT_DESC_GPI_MASK	UL(0xF)
+#define GPT_L1_CONT_DESC_GPI_SHIFT	U(4)
+
+#define GPT_L1_CONT_DESC_CONTIG_MASK	UL(0x3)
+#define GPT_L1_CONT_DESC_CONTIG_SHIFT	U(8)
+
+/*
+ * Encodings of the Contig field of an L1 contiguous descriptor, giving the
+ * size of the naturally aligned block described by a set of identical
+ * contiguous descriptors.
+ */
+#define GPT_L1_CONTIG_2MB		U(1)
+#define GPT_L1_CONTIG_32MB		U(2)
+#define GPT_L1_CONTIG_512MB		U(3)
+
 /*
  * This macro fills out every GPI entry in a granules descriptor to the same
  * value.
@@ -106,23 +124,34 @@ typedef enum {
 	PGS_64KB_P =	16U
 } gpt_p_val_e;
 
-/*
- * Internal structure to retrieve the values from get_gpi_info();
- */
-typedef struct gpi_info {
-	uint64_t gpt_l1_desc;
-	uint64_t *gpt_l1_addr;
-	unsigned int idx;
-	unsigned int gpi_shift;
-	unsigned int gpi;
-} gpi_info_t;
-
 /* Max valid value for PGS. */
 #define GPT_PGS_MAX			(2U)
 
 /* Max valid value for PPS. */
 #define GPT_PPS_MAX			(6U)
 
+/* Largest Contig value used in L1 contiguous descriptors, from build option. */
+#if RME_GPT_MAX_BLOCK == 0
+#define GPT_L1_CONTIG_MAX		U(0)
+#elif RME_GPT_MAX_BLOCK == 2
+#define GPT_L1_CONTIG_MAX		GPT_L1_CONTIG_2MB
+#elif RME_GPT_MAX_BLOCK == 32
+#define GPT_L1_CONTIG_MAX		GPT_L1_CONTIG_32MB
+#elif RME_GPT_MAX_BLOCK == 512
+#define GPT_L1_CONTIG_MAX		GPT_L1_CONTIG_512MB
+#else
+#error "Invalid value for RME_GPT_MAX_BLOCK"
+#endif
+
+/* Number of L1 tables that can be folded into L0 block descriptors. */
+#define GPT_L1_POOL_SIZE		(16U)
+
+/* Number of locks protecting the L1 tables, must be a power of 2 */
+#define GPT_LOCK_COUNT			(64U)
+
+/* Largest number of granules invalidated one by one from the GPT TLBs */
+#define GPT_TLBI_MAX_GRANULES		(16U)
+
 /******************************************************************************/
 /* L0 address attribute macros                                                */
 /******************************************************************************/
@@ -241,6 +270,34 @@ typedef struct gpi_info {
 #define GPT_L0_BLKD_GPI(_desc)	(((_desc) >> GPT_L0_BLK_DESC_GPI_SHIFT) & \
 				GPT_L0_BLK_DESC_GPI_MASK)
 
+/* Create an L1 contiguous descriptor. */
+#define GPT_L1_CONT_DESC(_gpi, _contig)					\
+				(GPT_L1_TYPE_CONT_DESC |		\
+				(((uint64_t)(_gpi) & GPT_L1_CONT_DESC_GPI_MASK) \
+				<< GPT_L1_CONT_DESC_GPI_SHIFT) |	\
+				(((uint64_t)(_contig) &			\
+				GPT_L1_CONT_DESC_CONTIG_MASK) <<	\
+				GPT_L1_CONT_DESC_CONTIG_SHIFT))
+
+/*
+ * Determine if an L1 descriptor is a contiguous descriptor. A granules
+ * descriptor can not match since 0b0001 is a reserved GPI encoding.
+ */
+#define GPT_L1_IS_CONT_DESC(_desc)	(((_desc) & GPT_L1_TYPE_MASK) == \
+					GPT_L1_TYPE_CONT_DESC)
+
+/* Get the GPI from an L1 contiguous descriptor. */
+#define GPT_L1_CONTD_GPI(_desc)	(((_desc) >> GPT_L1_CONT_DESC_GPI_SHIFT) & \
+				GPT_L1_CONT_DESC_GPI_MASK)
+
+/* Get the Contig field from an L1 contiguous descriptor. */
+#define GPT_L1_CONTD_CONTIG(_desc)	(((_desc) >>			\
+					GPT_L1_CONT_DESC_CONTIG_SHIFT) & \
+					GPT_L1_CONT_DESC_CONTIG_MASK)
+
+/* Size in bytes of the block described by a given Contig value. */
+#define GPT_L1_CONTIG_SIZE(_contig)	(1UL << (17U + (4U * (_contig))))
+
 /* Get the L1 address from an L0 table descriptor. */
 #define GPT_L0_TBLD_ADDR(_desc)	((uint64_t *)(((_desc) & \
 				(GPT_L0_TBL_DESC_L1ADDR_MASK << \
@@ -0,0 +1,12 @@
+#
+# Copyright (c) 2026, Arm Limited and Contributors. All rights reserved.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+
+LZ4_PATH	:=	lib/lz4
+
+LZ4_SOURCES	:=	$(addprefix $(LZ4_PATH)/,	\
+					tf_unlz4.c)
+
+INCLUDES	+=	-Iinclude/lib/lz4
@@ -0,0 +1,477 @@
+/*
+ * Copyright (c) 2026, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <common/debug.h>
+#include <lib/utils_def.h>
+#include <tf_unlz4.h>
+
+/*
+ * Decoder for the LZ4 frame format (as produced by the lz4 command line tool)
+ * and for the legacy LZ4 format (lz4 -l, as used for Linux kernel images).
+ * See https://github.com/lz4/lz4/blob/dev/doc/lz4_Frame_format.md and
+ * https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md
+ */
+#define LZ4_FRAME_MAGIC			U(0x184D2204)
+#define LZ4_LEGACY_MAGIC		U(0x184C2102)
+#define LZ4_SKIPPABLE_MAGIC		U(0x184D2A50)
+#define LZ4_SKIPPABLE_MAGIC_MASK	U(0xFFFFFFF0)
+
+/* Frame descriptor */
+#define LZ4_FLG_VERSION_MASK		U(0xC0)
+#define LZ4_FLG_VERSION			U(0x40)
+#define LZ4_FLG_BLOCK_INDEP		BIT_32(5)
+#define LZ4_FLG_BLOCK_CHECKSUM		BIT_32(4)
+#define LZ4_FLG_CONTENT_SIZE		BIT_32(3)
+#define LZ4_FLG_CONTENT_CHECKSUM	BIT_32(2)
+#define LZ4_FLG_RESERVED		BIT_32(1)
+#define LZ4_FLG_DICT_ID			BIT_32(0)
+#define LZ4_BD_BLOCK_MAX_SHIFT		U(4)
+#define LZ4_BD_BLOCK_MAX_MASK		U(0x7)
+#define LZ4_BD_RESERVED			U(0x8F)
+
+#define LZ4_BLOCK_UNCOMPRESSED		BIT_32(31)
+#define LZ4_LEGACY_BLOCK_MAX		U(0x808090)	/* Bound of 8MB compressed */
+
+#define LZ4_MIN_MATCH			U(4)
+#define LZ4_RUN_MASK			U(0xF)
+
+/* xxHash32, used by the frame format for its checksums */
+#define XXH_PRIME32_1			U(0x9E3779B1)
+#define XXH_PRIME32_2			U(0x85EBCA77)
+#define XXH_PRIME32_3			U(0xC2B2AE3D)
+#define XXH_PRIME32_4			U(0x27D4EB2F)
+#define XXH_PRIME32_5			U(0x165667B1)
+
+static inline uint32_t get_le32(const uint8_t *p)
+{
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+	       ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline uint32_t rotl32(uint32_t x, unsigned int r)
+{
+	return (x << r) | (x >> (32U - r));
+}
+
+static inline uint32_t xxh32_round(uint32_t acc, uint32_t input)
+{
+	acc += input * XXH_PRIME32_2;
+	acc = rotl32(acc, 13U);
+	return acc * XXH_PRIME32_1;
+}
+
+static uint32_t xxh32(const uint8_t *p, size_t len)
+{
+	const uint8_t *end = p + len;
+	uint32_t v1, v2, v3, v4, h;
+
+	/* The seed is always 0 in the LZ4 frame format */
+	if (len >= 16U) {
+		v1 = XXH_PRIME32_1 + XXH_PRIME32_2;
+		v2 = XXH_PRIME32_2;
+		v3 = 0U;
+		v4 = 0U - XXH_PRIME32_1;
+
+		do {
+			v1 = xxh32_round(v1, get_le32(p));
+			v2 = xxh32_round(v2, get_le32(p + 4));
+			v3 = xxh32_round(v3, get_le32(p + 8));
+			v4 = xxh32_round(v4, get_le32(p + 12));
+			p += 16;
+		} while ((size_t)(end - p) >= 16U);
+
+		h = rotl32(v1, 1U) + rotl32(v2, 7U) + rotl32(v3, 12U) +
+		    rotl32(v4, 18U);
+	} else {
+		h = XXH_PRIME32_5;
+	}
+
+	h += (uint32_t)len;
+
+	for (; (size_t)(end - p) >= 4U; p += 4) {
+		h += get_le32(p) * XXH_PRIME32_3;
+		h = rotl32(h, 17U) * XXH_PRIME32_4;
+	}
+
+	for (; p < end; p++) {
+		h += (uint32_t)*p * XXH_PRIME32_5;
+		h = rotl32(h, 11U) * XXH_PRIME32_1;
+	}
+
+	h ^= h >> 15;
+	h *= XXH_PRIME32_2;
+	h ^= h >> 13;
+	h *= XXH_PRIME32_3;
+	h ^= h >> 16;
+
+	return h;
+}
+
+/*
+ * Copy len bytes 8 bytes at a time, which may read and write up to 7 bytes
+ * past the end of src and dst. The caller checks that there is enough room.
+ */
+static inline void lz4_wild_copy(uint8_t *dst, const uint8_t *src, size_t len)
+{
+	uint8_t *end = dst + len;
+
+	do {
+		__builtin_memcpy(dst, src, 8);
+		dst += 8;
+		src += 8;
+	} while (dst < end);
+}
+
+/* Add the extra bytes of a literal or match length */
+static int lz4_read_len(const uint8_t **in, const uint8_t *in_end, size_t *len)
+{
+	uint8_t b;
+
+	do {
+		if (*in == in_end) {
+			return -EIO;
+		}
+		b = *(*in)++;
+		*len += b;
+	} while (b == 255U);
+
+	return 0;
+}
+
+/*
+ * Decode an LZ4 block to *out, and update *out to the end of the output.
+ * Matches may refer to the output back to ref_start.
+ */
+static int lz4_decode_block(const uint8_t *in, size_t in_len,
+			    const uint8_t *ref_start, uint8_t **out,
+			    const uint8_t *out_end)
+{
+	const uint8_t *in_end = in + in_len;
+	const uint8_t *match;
+	uint8_t *op = *out;
+	unsigned int token;
+	size_t len, offset;
+
+	while (in < in_end) {
+		token = *in++;
+
+		/* Literals */
+		len = token >> 4;
+		if ((len == LZ4_RUN_MASK) &&
+		    (lz4_read_len(&in, in_end, &len) != 0)) {
+			return -EIO;
+		}
+
+		if (len > (size_t)(in_end - in)) {
+			return -EIO;
+		}
+		if (len > (size_t)(out_end - op)) {
+			return -ENOMEM;
+		}
+
+		if (((size_t)(out_end - op) >= (len + 8U)) &&
+		    ((size_t)(in_end - in) >= (len + 8U))) {
+			lz4_wild_copy(op, in, len);
+		} else {
+			(void)memcpy(op, in, len);
+		}
+		op += len;
+		in += len;
+
+		/* The last sequence of the block only has literals */
+		if (in == in_end) {
+			break;
+		}
+
+		/* Match */
+		if ((in_end - in) < 2) {
+			return -EIO;
+		}
+		offset = (size_t)in[0] | ((size_t)in[1] << 8);
+		in += 2;
+
+		if ((offset == 0U) || (offset > (size_t)(op - ref_start))) {
+			return -EIO;
+		}
+
+		len = token & LZ4_RUN_MASK;
+		if ((len == LZ4_RUN_MASK) &&
+		    (lz4_read_len(&in, in_end, &len) != 0)) {
+			return -EIO;
+		}
+		len += LZ4_MIN_MATCH;
+
+		if (len > (size_t)(out_end - op)) {
+			return -ENOMEM;
+		}
+
+		match = op - offset;
+		if ((offset >= 8U) && ((size_t)(out_end - op) >= (len + 8U))) {
+			lz4_wild_copy(op, match, len);
+			op += len;
+		} else if (offset >= len) {
+			(void)memcpy(op, match, len);
+			op += len;
+		} else {
+			/* Overlapping match, repeating the last offset bytes */
+			while (len-- > 0U) {
+				*op++ = *match++;
+			}
+		}
+	}
+
+	*out = op;
+
+	return 0;
+}
+
+/* Decode an LZ4 frame, starting after its magic number */
+static int lz4_decode_frame(const uint8_t **inp, const uint8_t *in_end,
+			    uint8_t **out, const uint8_t *out_end)
+{
+	const uint8_t *in = *inp;
+	const uint8_t *desc = in;
+	uint8_t *frame_start = *out;
+	uint8_t *op = *out;
+	uint8_t *block_start;
+	uint64_t content_size = 0U;
+	size_t desc_len = 2U, block_max, csum_len, len;
+	uint32_t flg, bd, bsize;
+	int ret;
+
+	if ((in_end - in) < 3) {
+		return -EIO;
+	}
+
+	flg = in[0];
+	bd = in[1];
+	if (((flg & LZ4_FLG_VERSION_MASK) != LZ4_FLG_VERSION) ||
+	    ((flg & LZ4_FLG_RESERVED) != 0U) ||
+	    ((bd & LZ4_BD_RESERVED) != 0U)) {
+		ERROR("lz4: unsupported frame descriptor\n");
+		return -EIO;
+	}
+
+	if ((flg & LZ4_FLG_DICT_ID) != 0U) {
+		ERROR("lz4: dictionaries are not supported\n");
+		return -EIO;
+	}
+
+	block_max = (size_t)1U <<
+		    (8U + (2U * ((bd >> LZ4_BD_BLOCK_MAX_SHIFT) &
+				 LZ4_BD_BLOCK_MAX_MASK)));
+	if (block_max < 0x10000U) {
+		ERROR("lz4: unsupported frame descriptor\n");
+		return -EIO;
+	}
+
+	if ((flg & LZ4_FLG_CONTENT_SIZE) != 0U) {
+		desc_len += 8U;
+	}
+
+	if ((size_t)(in_end - in) < (desc_len + 1U)) {
+		return -EIO;
+	}
+
+	if ((flg & LZ4_FLG_CONTENT_SIZE) != 0U) {
+		content_size = (uint64_t)get_le32(in + 2) |
+			       ((uint64_t)get_le32(in + 6) << 32);
+	}
+
+	if (in[desc_len] != ((xxh32(desc, desc_len) >> 8) & 0xFFU)) {
+		ERROR("lz4: bad frame descriptor checksum\n");
+		return -EIO;
+	}
+	in += desc_len + 1U;
+
+	csum_len = ((flg & LZ4_FLG_BLOCK_CHECKSUM) != 0U) ? 4U : 0U;
+
+	for (;;) {
+		if ((in_end - in) < 4) {
+			return -EIO;
+		}
+		bsize = get_le32(in);
+		in += 4;
+
+		/* End mark */
+		if (bsize == 0U) {
+			break;
+		}
+
+		block_start = op;
+		len = bsize & ~LZ4_BLOCK_UNCOMPRESSED;
+
+		if ((len > block_max) ||
+		    ((size_t)(in_end - in) < (len + csum_len))) {
+			return -EIO;
+		}
+
+		if ((csum_len != 0U) &&
+		    (xxh32(in, len) != get_le32(in + len))) {
+			ERROR("lz4: bad block checksum\n");
+			return -EIO;
+		}
+
+		if ((bsize & LZ4_BLOCK_UNCOMPRESSED) != 0U) {
+			if (len > (size_t)(out_end - op)) {
+				return -ENOMEM;
+			}
+			(void)memcpy(op, in, len);
+			op += len;
+		} else {
+			ret = lz4_decode_block(in, len,
+				((flg & LZ4_FLG_BLOCK_INDEP) != 0U) ?
+				block_start : frame_start, &op, out_end);
+			if (ret != 0) {
+				return ret;
+			}
+		}
+
+		in += len + csum_len;
+	}
+
+	if ((flg & LZ4_FLG_CONTENT_CHECKSUM) != 0U) {
+		if ((in_end - in) < 4) {
+			return -EIO;
+		}
+		if (xxh32(frame_start, (size_t)(op - frame_start)) !=
+		    get_le32(in)) {
+			ERROR("lz4: bad content checksum\n");
+			return -EIO;
+		}
+		in += 4;
+	}
+
+	if (((flg & LZ4_FLG_CONTENT_SIZE) != 0U) &&
+	    (content_size != (uint64_t)(op - frame_start))) {
+		ERROR("lz4: bad content size\n");
+		return -EIO;
+	}
+
+	*inp = in;
+	*out = op;
+
+	return 0;
+}
+
+/*
+ * Decode a legacy LZ4 frame, starting after its magic number. The frame ends
+ * at the end of the input, at the magic number of the next frame, or at data
+ * which is not a block, such as the size appended by the Linux build.
+ */
+static int lz4_decode_legacy(const uint8_t **inp, const uint8_t *in_end,
+			     uint8_t **out, const uint8_t *out_end)
+{
+	const uint8_t *in = *inp;
+	uint8_t *op = *out;
+	uint32_t bsize;
+	int ret;
+
+	while ((in_end - in) >= 4) {
+		bsize = get_le32(in);
+		if ((bsize == LZ4_LEGACY_MAGIC) ||
+		    (bsize > LZ4_LEGACY_BLOCK_MAX) ||
+		    (bsize > (size_t)(in_end - in - 4))) {
+			break;
+		}
+		in += 4;
+
+		/* Legacy blocks are independent */
+		ret = lz4_decode_block(in, bsize, op, &op, out_end);
+		if (ret != 0) {
+			return ret;
+		}
+		in += bsize;
+	}
+
+	*inp = in;
+	*out = op;
+
+	return 0;
+}
+
+/*
+ * unlz4 - decompress LZ4 data
+ * @in_buf: source of compressed input. Upon exit, the end of input.
+ * @in_len: length of in_buf
+ * @out_buf: destination of decompressed output. Upon exit, the end of output.
+ * @out_len: length of out_buf
+ * @work_buf: workspace (not used, LZ4 decodes directly to the output)
+ * @work_len: length of workspace
+ *
+ * The input may be made of several frames. Any data after the last frame is
+ * ignored.
+ */
+int unlz4(uintptr_t *in_buf, size_t in_len, uintptr_t *out_buf,
+	  size_t out_len, uintptr_t work_buf, size_t work_len)
+{
+	const uint8_t *in_start = (const uint8_t *)*in_buf;
+	const uint8_t *in = in_start;
+	const uint8_t *in_end = in + in_len;
+	uint8_t *out_start = (uint8_t *)*out_buf;
+	uint8_t *op = out_start;
+	const uint8_t *out_end = out_start + out_len;
+	bool frame = false;
+	uint32_t magic;
+	int ret = 0;
+
+	while ((ret == 0) && ((in_end - in) >= 4)) {
+		magic = get_le32(in);
+		if (magic == LZ4_FRAME_MAGIC) {
+			in += 4;
+			ret = lz4_decode_frame(&in, in_end, &op, out_end);
+		} else if (magic == LZ4_LEGACY_MAGIC) {
+			in += 4;
+			ret = lz4_decode_legacy(&in, in_end, &op, out_end);
+		} else if ((magic & LZ4_SKIPPABLE_MAGIC_MASK) ==
+			   LZ4_SKIPPABLE_MAGIC) {
+			if (((in_end - in) < 8) ||
+			    (get_le32(in + 4) > (size_t)(in_end - in - 8))) {
+				ret = -EIO;
+			} else {
+				in += 8U + get_le32(in + 4);
+			}
+		} else {
+			break;
+		}
+
+		frame = true;
+	}
+
+	if ((ret == 0) && !frame) {
+		ERROR("lz4: bad magic number\n");
+		ret = -EIO;
+	} else if (ret != 0) {
+		ERROR("lz4: decompression failed (ret = %d)\n", ret);
+	}
+
+	VERBOSE("lz4: %lu byte input\n", (unsigned long)(in - in_start));
+	VERBOSE("lz4: %lu byte output\n", (unsigned long)(op - out_start));
+
+	*in_buf = (uintptr_t)in;
+	*out_buf = (uintptr_t)op;
+
+	return ret;
+}
+
+const image_decompressor_t unlz4_decompressor = {
+	.name = "lz4",
+	.magic = { 0x04, 0x22, 0x4d, 0x18 },
+	.magic_len = 4U,
+	.decompress = unlz4,
+};
+
+const image_decompressor_t unlz4_legacy_decompressor = {
+	.name = "lz4 (legacy)",
+	.magic = { 0x02, 0x21, 0x4c, 0x18 },
+	.magic_len = 4U,
+	.decompress = unlz4,
+};
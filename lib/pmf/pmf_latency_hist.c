@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <stdint.h>
+
+#include <arch_helpers.h>
+#include <bl31/interrupt_mgmt.h>
+#include <lib/pmf/pmf.h>
+#include <lib/utils_def.h>
+#include <plat/common/platform.h>
+#include <smccc_helpers.h>
+
+/*
+ * Latency histograms of a CPU. Each CPU only ever updates its own histograms,
+ * with interrupts masked, so no locking is needed. The histograms of another
+ * CPU may be read while they are being updated, in which case the returned
+ * counts may be off by one sample.
+ */
+typedef struct pmf_latency_hist {
+	uint32_t buckets[PMF_HIST_NUM][PMF_HIST_BUCKETS];
+
+	/* Start of the world switch in progress, or 0 if none */
+	unsigned long long switch_start;
+} pmf_latency_hist_t;
+
+static pmf_latency_hist_t pmf_latency_hists[PLATFORM_CORE_COUNT]
+	__aligned(CACHE_WRITEBACK_GRANULE);
+
+/*
+ * This function adds the time elapsed since `start` to the histogram
+ * identified by `hist_id` for the current CPU. The counters wrap around on
+ * overflow. A start of 0 means that no start time was taken, and the sample
+ * is skipped.
+ */
+static void pmf_latency_hist_record(unsigned int hist_id,
+		unsigned long long start)
+{
+	unsigned long long delta;
+	unsigned int bucket = 0U;
+
+	assert(hist_id < PMF_HIST_NUM);
+
+	if (start == 0ULL) {
+		return;
+	}
+
+	delta = read_cntpct_el0() - start;
+
+	if (delta != 0ULL) {
+		bucket = 64U - (unsigned int)__builtin_clzll(delta);
+		if (bucket >= PMF_HIST_BUCKETS) {
+			bucket = PMF_HIST_BUCKETS - 1U;
+		}
+	}
+
+	pmf_latency_hists[plat_my_core_pos()].buckets[hist_id][bucket]++;
+}
+
+/*
+ * This function is called on exit from an SMC handler, with the unique owning
+ * entity number of the SMC and the time of the exception entry.
+ */
+void pmf_latency_hist_smc(unsigned int unique_oen, unsigned long long start)
+{
+	pmf_latency_hist_record(PMF_HIST_SMC_ID(unique_oen & FUNCID_OEN_MASK),
+				start);
+}
+
+/*
+ * This function is called before an interrupt type handler, with the type of
+ * the interrupt and the time of the exception entry.
+ */
+void pmf_latency_hist_intr(unsigned int type, unsigned long long start)
+{
+	assert(type < PMF_HIST_INTR_NUM);
+
+	pmf_latency_hist_record(PMF_HIST_INTR_ID(type), start);
+}
+
+/*
+ * These functions bracket a world switch: the start is the first save of the
+ * context of the security state being left, the end is the next restore of
+ * the context of a security state. A restore without a prior save, such as the
+ * first entry into a security state, is not counted. A save that is not
+ * followed by a restore before BL31 exits, or before the CPU is powered down,
+ * is dropped by pmf_latency_hist_switch_cancel().
+ */
+void pmf_latency_hist_switch_start(void)
+{
+	pmf_latency_hist_t *hist = &pmf_latency_hists[plat_my_core_pos()];
+
+	if (hist->switch_start == 0ULL) {
+		hist->switch_start = read_cntpct_el0();
+	}
+}
+
+void pmf_latency_hist_switch_end(void)
+{
+	pmf_latency_hist_t *hist = &pmf_latency_hists[plat_my_core_pos()];
+
+	if (hist->switch_start != 0ULL) {
+		pmf_latency_hist_record(PMF_HIST_WORLD_SWITCH_ID,
+					hist->switch_start);
+		hist->switch_start = 0ULL;
+	}
+}
+
+void pmf_latency_hist_switch_cancel(void)
+{
+	pmf_latency_hists[plat_my_core_pos()].switch_start = 0ULL;
+}
+
+/*
+ * This function copies the histogram identified by `hist_id` for the CPU
+ * identified by `mpidr` to `buckets`, which must be able to hold
+ * PMF_HIST_BUCKETS counters.
+ */
+int pmf_get_latency_hist_smc(unsigned int hist_id,
+		u_register_t mpidr,
+		uint32_t *buckets)
+{
+	int cpuid = plat_core_pos_by_mpidr(mpidr);
+	unsigned int i;
+
+	assert(buckets != NULL);
+
+	if ((hist_id >= PMF_HIST_NUM) || (cpuid < 0)) {
+		return -EINVAL;
+	}
+
+	for (i = 0U; i < PMF_HIST_BUCKETS; i++) {
+		buckets[i] = pmf_latency_hists[cpuid].buckets[hist_id][i];
+	}
+
+	return 0;
+}
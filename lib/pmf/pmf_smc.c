@@ -11,6 +11,14 @@
 #include <plat/common/platform.h>
 #include <smccc_helpers.h>
 
+#if PMF_LATENCY_HIST
+/* Two histogram buckets are returned in each of the registers x1 to x16 */
+CASSERT(PMF_HIST_BUCKETS == 32U, assert_pmf_hist_buckets_mismatch);
+
+#define PMF_HIST_PAIR(_b, _i)						\
+	(((u_register_t)(_b)[(2U * (_i)) + 1U] << 32) | (_b)[2U * (_i)])
+#endif
+
 /*
  * This function is responsible for handling all PMF SMC calls.
  */
@@ -56,6 +64,30 @@ uintptr_t pmf_smc_handler(unsigned int smc_fid,
 					(unsigned int)x3, &ts_value);
 			SMC_RET2(handle, rc, ts_value);
 		}
+
+#if PMF_LATENCY_HIST
+		if (smc_fid == PMF_SMC_GET_LATENCY_HIST_64) {
+			uint32_t b[PMF_HIST_BUCKETS] = { 0U };
+
+			/*
+			 * Return error code and the histogram to the caller.
+			 * x0 --> error code.
+			 * x1 - x16 --> histogram buckets, two per register,
+			 *              the even-numbered one in bits [31:0].
+			 */
+			rc = pmf_get_latency_hist_smc((unsigned int)x1, x2, b);
+			SMC_RET18(handle, rc,
+				PMF_HIST_PAIR(b, 0U), PMF_HIST_PAIR(b, 1U),
+				PMF_HIST_PAIR(b, 2U), PMF_HIST_PAIR(b, 3U),
+				PMF_HIST_PAIR(b, 4U), PMF_HIST_PAIR(b, 5U),
+				PMF_HIST_PAIR(b, 6U), PMF_HIST_PAIR(b, 7U),
+				PMF_HIST_PAIR(b, 8U), PMF_HIST_PAIR(b, 9U),
+				PMF_HIST_PAIR(b, 10U), PMF_HIST_PAIR(b, 11U),
+				PMF_HIST_PAIR(b, 12U), PMF_HIST_PAIR(b, 13U),
+				PMF_HIST_PAIR(b, 14U), PMF_HIST_PAIR(b, 15U),
+				0U);
+		}
+#endif
 	}
 
 	WARN("Unimplemented PMF Call: 0x%x \n", smc_fid);
@@ -14,6 +14,8 @@
 #include <context.h>
 #include <drivers/delay_timer.h>
 #include <lib/el3_runtime/context_mgmt.h>
+#include <lib/el3_trace.h>
+#include <lib/pmf/pmf.h>
 #include <lib/utils.h>
 #include <plat/common/platform.h>
 
@@ -64,6 +66,11 @@ DEFINE_PSCI_LOCK(psci_locks[PSCI_NUM_NON_CPU_PWR_DOMAINS]);
 
 cpu_pd_node_t psci_cpu_pd_nodes[PLATFORM_CORE_COUNT];
 
+#if HW_ASSISTED_COHERENCY
+/* Number of CPUs whose affinity info state is not OFF */
+static volatile uint32_t psci_cpus_on;
+#endif
+
 /*******************************************************************************
  * Pointer to functions exported by the platform to complete power mgmt. ops
  ******************************************************************************/
@@ -161,6 +168,47 @@ void psci_query_sys_suspend_pwrstate(psci_power_state_t *state_info)
 	psci_plat_pm_ops->get_sys_suspend_power_state(state_info);
 }
 
+#if HW_ASSISTED_COHERENCY
+/*******************************************************************************
+ * These functions keep the CPU counters up to date when the affinity info
+ * state or the local state of a CPU changes. The affinity info state of a CPU
+ * is only changed by the CPU itself or under its cpu_lock, and its local
+ * state only by the CPU itself, so the previous states are stable.
+ ******************************************************************************/
+void psci_count_aff_info_state(aff_info_state_t prev, aff_info_state_t next)
+{
+	if ((prev == AFF_STATE_OFF) && (next != AFF_STATE_OFF)) {
+		(void)psci_atomic_add(&psci_cpus_on, 1);
+	} else if ((prev != AFF_STATE_OFF) && (next == AFF_STATE_OFF)) {
+		(void)psci_atomic_add(&psci_cpus_on, -1);
+	} else {
+		/* No change in the number of CPUs that are not OFF */
+	}
+}
+#endif /* HW_ASSISTED_COHERENCY */
+
+#if PSCI_COUNT_RUNNING_CPUS
+void psci_count_cpu_local_state(plat_local_state_t prev,
+				plat_local_state_t next)
+{
+	unsigned int parent_idx;
+	int32_t delta;
+
+	if (is_local_state_run(prev) == is_local_state_run(next)) {
+		return;
+	}
+
+	delta = (is_local_state_run(next) != 0) ? 1 : -1;
+
+	parent_idx = psci_cpu_pd_nodes[plat_my_core_pos()].parent_node;
+	while (parent_idx != PSCI_PARENT_NODE_INVALID) {
+		(void)psci_atomic_add(
+			&psci_non_cpu_pd_nodes[parent_idx].cpus_running, delta);
+		parent_idx = psci_non_cpu_pd_nodes[parent_idx].parent_node;
+	}
+}
+#endif /* PSCI_COUNT_RUNNING_CPUS */
+
 #if PSCI_OS_INIT_MODE
 /*******************************************************************************
  * This function verifies that all the other cores at the 'end_pwrlvl' have been
@@ -171,8 +219,10 @@ void psci_query_sys_suspend_pwrstate(psci_power_state_t *state_info)
 static bool psci_is_last_cpu_to_idle_at_pwrlvl(unsigned int end_pwrlvl)
 {
 	unsigned int my_idx, lvl, parent_idx;
+#if !PSCI_COUNT_RUNNING_CPUS
 	unsigned int cpu_start_idx, ncpus, cpu_idx;
 	plat_local_state_t local_state;
+#endif
 
 	if (end_pwrlvl == PSCI_CPU_PWR_LVL) {
 		return true;
@@ -180,6 +230,17 @@ static bool psci_is_last_cpu_to_idle_at_pwrlvl(unsigned int end_pwrlvl)
 
 	my_idx = plat_my_core_pos();
 
+#if PSCI_COUNT_RUNNING_CPUS
+	/* Find the power domain node at 'end_pwrlvl' */
+	parent_idx = psci_cpu_pd_nodes[my_idx].parent_node;
+	for (lvl = PSCI_CPU_PWR_LVL + 1U; lvl < end_pwrlvl; lvl++) {
+		parent_idx = psci_non_cpu_pd_nodes[parent_idx].parent_node;
+	}
+
+	assert(is_local_state_run(psci_get_cpu_local_state()) != 0);
+
+	return psci_non_cpu_pd_nodes[parent_idx].cpus_running == 1U;
+#else
 	for (lvl = PSCI_CPU_PWR_LVL; lvl <= end_pwrlvl; lvl++) {
 		parent_idx = psci_cpu_pd_nodes[my_idx].parent_node;
 	}
@@ -201,6 +262,7 @@ static bool psci_is_last_cpu_to_idle_at_pwrlvl(unsigned int end_pwrlvl)
 	}
 
 	return true;
+#endif /* PSCI_COUNT_RUNNING_CPUS */
 }
 #endif
 
@@ -211,6 +273,18 @@ static bool psci_is_last_cpu_to_idle_at_pwrlvl(unsigned int end_pwrlvl)
  ******************************************************************************/
 bool psci_is_last_on_cpu(void)
 {
+#if HW_ASSISTED_COHERENCY
+	assert(psci_get_aff_info_state() == AFF_STATE_ON);
+
+	if (psci_cpus_on != 1U) {
+		VERBOSE("%u cores other than current core=%u %s\n",
+			psci_cpus_on - 1U, plat_my_core_pos(),
+			"running in the system");
+		return false;
+	}
+
+	return true;
+#else
 	unsigned int cpu_idx, my_idx = plat_my_core_pos();
 
 	for (cpu_idx = 0; cpu_idx < psci_plat_core_count; cpu_idx++) {
@@ -227,6 +301,7 @@ bool psci_is_last_on_cpu(void)
 	}
 
 	return true;
+#endif /* HW_ASSISTED_COHERENCY */
 }
 
 /*******************************************************************************
@@ -235,6 +310,9 @@ bool psci_is_last_on_cpu(void)
  ******************************************************************************/
 static bool psci_are_all_cpus_on(void)
 {
+#if HW_ASSISTED_COHERENCY
+	return psci_cpus_on == psci_plat_core_count;
+#else
 	unsigned int cpu_idx;
 
 	for (cpu_idx = 0; cpu_idx < psci_plat_core_count; cpu_idx++) {
@@ -244,6 +322,7 @@ static bool psci_are_all_cpus_on(void)
 	}
 
 	return true;
+#endif /* HW_ASSISTED_COHERENCY */
 }
 
 /*******************************************************************************
@@ -988,6 +1067,11 @@ void psci_warmboot_entrypoint(void)
 	/* Init registers that never change for the lifetime of TF-A */
 	cm_manage_extensions_el3();
 
+#if IMAGE_BL31 && PMF_LATENCY_HIST
+	/* A world switch started before the power down did not complete */
+	pmf_latency_hist_switch_cancel();
+#endif
+
 	/*
 	 * Verify that we have been explicitly turned ON or resumed from
 	 * suspend.
@@ -1064,6 +1148,8 @@ void psci_warmboot_entrypoint(void)
 	 * in the reverse order to which they were acquired.
 	 */
 	psci_release_pwr_domain_locks(end_pwrlvl, parent_nodes);
+
+	EL3_TRACE_EVENT(EL3_TRACE_PSCI_WARMBOOT, end_pwrlvl, 0);
 }
 
 /*******************************************************************************
@@ -10,8 +10,7 @@
 #include <arch.h>
 #include <arch_helpers.h>
 #include <common/debug.h>
-#include <lib/pmf/pmf.h>
-#include <lib/runtime_instr.h>
+#include <lib/el3_trace.h>
 #include <lib/smccc.h>
 #include <plat/common/platform.h>
 #include <services/arm_arch_svc.h>
@@ -43,7 +42,11 @@ int psci_cpu_on(u_register_t target_cpu,
 	 * To turn this cpu on, specify which power
 	 * levels need to be turned on
 	 */
-	return psci_cpu_on_start(target_cpu, &ep);
+	rc = psci_cpu_on_start(target_cpu, &ep);
+
+	EL3_TRACE_EVENT(EL3_TRACE_PSCI_CPU_ON, target_cpu, rc);
+
+	return rc;
 }
 
 unsigned int psci_version(void)
@@ -59,11 +62,6 @@ int psci_cpu_suspend(unsigned int power_state,
 	unsigned int target_pwrlvl, is_power_down_state;
 	entry_point_info_t ep;
 	psci_power_state_t state_info = { {PSCI_LOCAL_STATE_RUN} };
-	plat_local_state_t cpu_pd_state;
-#if PSCI_OS_INIT_MODE
-	unsigned int cpu_idx = plat_my_core_pos();
-	plat_local_state_t prev[PLAT_MAX_PWR_LVL];
-#endif
 
 	/* Validate the power_state parameter */
 	rc = psci_validate_power_state(power_state, &state_info);
@@ -87,67 +85,23 @@ int psci_cpu_suspend(unsigned int power_state,
 		panic();
 	}
 
+	EL3_TRACE_EVENT(EL3_TRACE_PSCI_CPU_SUSPEND, power_state,
+			is_power_down_state);
+
+#if CONSOLE_DEFERRED_LOG
+	/*
+	 * Write out some of the deferred console output while this CPU is
+	 * idle. This never waits for another CPU.
+	 */
+	console_log_drain_idle();
+#endif
+
 	/* Fast path for CPU standby.*/
 	if (is_cpu_standby_req(is_power_down_state, target_pwrlvl)) {
 		if  (psci_plat_pm_ops->cpu_standby == NULL)
 			return PSCI_E_INVALID_PARAMS;
 
-		/*
-		 * Set the state of the CPU power domain to the platform
-		 * specific retention state and enter the standby state.
-		 */
-		cpu_pd_state = state_info.pwr_domain_state[PSCI_CPU_PWR_LVL];
-		psci_set_cpu_local_state(cpu_pd_state);
-
-#if PSCI_OS_INIT_MODE
-		/*
-		 * If in OS-initiated mode, save a copy of the previous
-		 * requested local power states and update the new requested
-		 * local power states for this CPU.
-		 */
-		if (psci_suspend_mode == OS_INIT) {
-			psci_update_req_local_pwr_states(target_pwrlvl, cpu_idx,
-							 &state_info, prev);
-		}
-#endif
-
-#if ENABLE_PSCI_STAT
-		plat_psci_stat_accounting_start(&state_info);
-#endif
-
-#if ENABLE_RUNTIME_INSTRUMENTATION
-		PMF_CAPTURE_TIMESTAMP(rt_instr_svc,
-		    RT_INSTR_ENTER_HW_LOW_PWR,
-		    PMF_NO_CACHE_MAINT);
-#endif
-
-		psci_plat_pm_ops->cpu_standby(cpu_pd_state);
-
-		/* Upon exit from standby, set the state back to RUN. */
-		psci_set_cpu_local_state(PSCI_LOCAL_STATE_RUN);
-
-#if PSCI_OS_INIT_MODE
-		/*
-		 * If in OS-initiated mode, restore the previous requested
-		 * local power states for this CPU.
-		 */
-		if (psci_suspend_mode == OS_INIT) {
-			psci_restore_req_local_pwr_states(cpu_idx, prev);
-		}
-#endif
-
-#if ENABLE_RUNTIME_INSTRUMENTATION
-		PMF_CAPTURE_TIMESTAMP(rt_instr_svc,
-		    RT_INSTR_EXIT_HW_LOW_PWR,
-		    PMF_NO_CACHE_MAINT);
-#endif
-
-#if ENABLE_PSCI_STAT
-		plat_psci_stat_accounting_stop(&state_info);
-
-		/* Update PSCI stats */
-		psci_stats_update_pwr_up(PSCI_CPU_PWR_LVL, &state_info);
-#endif
+		psci_cpu_suspend_standby(&state_info);
 
 		return PSCI_E_SUCCESS;
 	}
@@ -226,6 +180,8 @@ int psci_cpu_off(void)
 	int rc;
 	unsigned int target_pwrlvl = PLAT_MAX_PWR_LVL;
 
+	EL3_TRACE_EVENT(EL3_TRACE_PSCI_CPU_OFF, target_pwrlvl, 0);
+
 	/*
 	 * Do what is needed to power off this CPU and possible higher power
 	 * levels if it able to do so. Upon success, enter the final wfi
@@ -604,3 +560,31 @@ u_register_t psci_smc_handler(uint32_t smc_fid,
 
 	return ret;
 }
+
+/*******************************************************************************
+ * PSCI handler for CPU_SUSPEND SMCs, for use on the SMC fast path. It performs
+ * the same checks as psci_smc_handler() without decoding the function id again.
+ ******************************************************************************/
+u_register_t psci_cpu_suspend_smc_handler(uint32_t smc_fid,
+					  u_register_t x1,
+					  u_register_t x2,
+					  u_register_t x3,
+					  u_register_t flags)
+{
+	assert((smc_fid == PSCI_CPU_SUSPEND_AARCH32) ||
+	       (smc_fid == PSCI_CPU_SUSPEND_AARCH64));
+
+	if (is_caller_secure(flags))
+		return (u_register_t)SMC_UNK;
+
+	if ((psci_caps & define_psci_cap(smc_fid)) == 0U)
+		return (u_register_t)SMC_UNK;
+
+	if (((smc_fid >> FUNCID_CC_SHIFT) & FUNCID_CC_MASK) == SMC_32) {
+		return (u_register_t)psci_cpu_suspend((uint32_t)x1,
+						      (uint32_t)x2,
+						      (uint32_t)x3);
+	}
+
+	return (u_register_t)psci_cpu_suspend((unsigned int)x1, x2, x3);
+}
@@ -16,6 +16,7 @@
 #include <lib/el3_runtime/cpu_data.h>
 #include <lib/psci/psci.h>
 #include <lib/spinlock.h>
+#include <lib/ticket_lock.h>
 
 /*
  * The PSCI capability which are provided by the generic code but does not
@@ -50,11 +51,30 @@
 /* Invalid parent */
 #define PSCI_PARENT_NODE_INVALID	0xFFFFFFFFU
 
+/*
+ * When PSCI participants are cache-coherent, the number of CPUs that are not
+ * OFF in the system is kept up to date as the per-cpu states below change, and
+ * so is the number of running CPUs in each non-CPU power domain when
+ * PSCI_COUNT_RUNNING_CPUS is enabled. This makes looking for the last running
+ * CPU a constant time operation.
+ */
+#if HW_ASSISTED_COHERENCY
+void psci_count_aff_info_state(aff_info_state_t prev, aff_info_state_t next);
+#endif
+#if PSCI_COUNT_RUNNING_CPUS
+void psci_count_cpu_local_state(plat_local_state_t prev,
+				plat_local_state_t next);
+#endif
+
 /*
  * Helper functions to get/set the fields of PSCI per-cpu data.
  */
 static inline void psci_set_aff_info_state(aff_info_state_t aff_state)
 {
+#if HW_ASSISTED_COHERENCY
+	psci_count_aff_info_state(
+		get_cpu_data(psci_svc_cpu_data.aff_info_state), aff_state);
+#endif
 	set_cpu_data(psci_svc_cpu_data.aff_info_state, aff_state);
 }
 
@@ -72,6 +92,10 @@ static inline aff_info_state_t psci_get_aff_info_state_by_idx(unsigned int idx)
 static inline void psci_set_aff_info_state_by_idx(unsigned int idx,
 						  aff_info_state_t aff_state)
 {
+#if HW_ASSISTED_COHERENCY
+	psci_count_aff_info_state(psci_get_aff_info_state_by_idx(idx),
+				  aff_state);
+#endif
 	set_cpu_data_by_index(idx,
 			      psci_svc_cpu_data.aff_info_state, aff_state);
 }
@@ -88,6 +112,10 @@ static inline void psci_set_suspend_pwrlvl(unsigned int target_lvl)
 
 static inline void psci_set_cpu_local_state(plat_local_state_t state)
 {
+#if PSCI_COUNT_RUNNING_CPUS
+	psci_count_cpu_local_state(
+		get_cpu_data(psci_svc_cpu_data.local_state), state);
+#endif
 	set_cpu_data(psci_svc_cpu_data.local_state, state);
 }
 
@@ -143,6 +171,11 @@ typedef struct non_cpu_pwr_domain_node {
 
 	/* For indexing the psci_lock array*/
 	uint16_t lock_index;
+
+#if PSCI_COUNT_RUNNING_CPUS
+	/* Number of CPUs in this power domain whose local state is RUN */
+	volatile uint32_t cpus_running;
+#endif
 } non_cpu_pd_node_t;
 
 typedef struct cpu_pwr_domain_node {
@@ -177,11 +210,24 @@ typedef enum suspend_mode {
  * The following are helpers and declarations of locks.
  ******************************************************************************/
 #if HW_ASSISTED_COHERENCY
+#if PSCI_USE_TICKET_LOCK
+/*
+ * Ticket locks serve contenders in order and only need a single atomic
+ * operation to be acquired, which scales better than spinlocks when many
+ * CPUs contend for the same power domain.
+ */
+#define DEFINE_PSCI_LOCK(_name)		ticket_lock_t _name
+#define psci_lock_acquire(_lock)	ticket_lock_get(_lock)
+#define psci_lock_drop(_lock)		ticket_lock_release(_lock)
+#else
 /*
  * On systems where participant CPUs are cache-coherent, we can use spinlocks
  * instead of bakery locks.
  */
 #define DEFINE_PSCI_LOCK(_name)		spinlock_t _name
+#define psci_lock_acquire(_lock)	spin_lock(_lock)
+#define psci_lock_drop(_lock)		spin_unlock(_lock)
+#endif /* PSCI_USE_TICKET_LOCK */
 #define DECLARE_PSCI_LOCK(_name)	extern DEFINE_PSCI_LOCK(_name)
 
 /* One lock is required per non-CPU power domain node */
@@ -208,12 +254,12 @@ static inline void psci_dsbish(void)
 
 static inline void psci_lock_get(non_cpu_pd_node_t *non_cpu_pd_node)
 {
-	spin_lock(&psci_locks[non_cpu_pd_node->lock_index]);
+	psci_lock_acquire(&psci_locks[non_cpu_pd_node->lock_index]);
 }
 
 static inline void psci_lock_release(non_cpu_pd_node_t *non_cpu_pd_node)
 {
-	spin_unlock(&psci_locks[non_cpu_pd_node->lock_index]);
+	psci_lock_drop(&psci_locks[non_cpu_pd_node->lock_index]);
 }
 
 #else /* if HW_ASSISTED_COHERENCY == 0 */
@@ -344,6 +390,7 @@ void psci_cpu_on_finish(unsigned int cpu_idx, const psci_power_state_t *state_in
 int psci_do_cpu_off(unsigned int end_pwrlvl);
 
 /* Private exported functions from psci_suspend.c */
+void psci_cpu_suspend_standby(psci_power_state_t *state_info);
 int psci_cpu_suspend_start(const entry_point_info_t *ep,
 			   unsigned int end_pwrlvl,
 			   psci_power_state_t *state_info,
@@ -354,6 +401,7 @@ void psci_cpu_suspend_finish(unsigned int cpu_idx, const psci_power_state_t *sta
 /* Private exported functions from psci_helpers.S */
 void psci_do_pwrdown_cache_maintenance(unsigned int pwr_level);
 void psci_do_pwrup_cache_maintenance(void);
+uint32_t psci_atomic_add(volatile uint32_t *addr, int32_t val);
 
 /* Private exported functions from psci_system_off.c */
 void __dead2 psci_system_off(void);
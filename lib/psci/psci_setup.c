@@ -52,6 +52,9 @@ static void __init psci_init_pwr_domain_node(uint16_t node_idx,
 		psci_non_cpu_pd_nodes[node_idx].parent_node = parent_idx;
 		psci_non_cpu_pd_nodes[node_idx].local_state =
 							 PLAT_MAX_OFF_STATE;
+#if PSCI_COUNT_RUNNING_CPUS
+		psci_non_cpu_pd_nodes[node_idx].cpus_running = 0U;
+#endif
 	} else {
 		psci_cpu_data_t *svc_cpu_data;
 
@@ -141,6 +141,81 @@ static void psci_suspend_to_pwrdown_start(unsigned int end_pwrlvl,
 #endif
 }
 
+/*******************************************************************************
+ * Fast path for a CPU_SUSPEND request to a retention state at the CPU power
+ * level only. The state of the parent power domains is not changed, so none of
+ * their locks are taken and no state coordination is done. The SPD is not
+ * notified either, as the CPU context is retained. The platform cpu_standby
+ * hook is entered directly and returns on wake-up.
+ ******************************************************************************/
+void psci_cpu_suspend_standby(psci_power_state_t *state_info)
+{
+	plat_local_state_t cpu_pd_state =
+		state_info->pwr_domain_state[PSCI_CPU_PWR_LVL];
+#if PSCI_OS_INIT_MODE
+	unsigned int cpu_idx = plat_my_core_pos();
+	plat_local_state_t prev[PLAT_MAX_PWR_LVL];
+#endif
+
+	assert(psci_plat_pm_ops->cpu_standby != NULL);
+
+	/*
+	 * Set the state of the CPU power domain to the platform specific
+	 * retention state and enter the standby state.
+	 */
+	psci_set_cpu_local_state(cpu_pd_state);
+
+#if PSCI_OS_INIT_MODE
+	/*
+	 * If in OS-initiated mode, save a copy of the previous requested local
+	 * power states and update the new requested local power states for
+	 * this CPU.
+	 */
+	if (psci_suspend_mode == OS_INIT) {
+		psci_update_req_local_pwr_states(PSCI_CPU_PWR_LVL, cpu_idx,
+						 state_info, prev);
+	}
+#endif
+
+#if ENABLE_PSCI_STAT
+	plat_psci_stat_accounting_start(state_info);
+#endif
+
+#if ENABLE_RUNTIME_INSTRUMENTATION
+	PMF_CAPTURE_TIMESTAMP(rt_instr_svc,
+	    RT_INSTR_ENTER_HW_LOW_PWR,
+	    PMF_NO_CACHE_MAINT);
+#endif
+
+	psci_plat_pm_ops->cpu_standby(cpu_pd_state);
+
+	/* Upon exit from standby, set the state back to RUN. */
+	psci_set_cpu_local_state(PSCI_LOCAL_STATE_RUN);
+
+#if PSCI_OS_INIT_MODE
+	/*
+	 * If in OS-initiated mode, restore the previous requested local power
+	 * states for this CPU.
+	 */
+	if (psci_suspend_mode == OS_INIT) {
+		psci_restore_req_local_pwr_states(cpu_idx, prev);
+	}
+#endif
+
+#if ENABLE_RUNTIME_INSTRUMENTATION
+	PMF_CAPTURE_TIMESTAMP(rt_instr_svc,
+	    RT_INSTR_EXIT_HW_LOW_PWR,
+	    PMF_NO_CACHE_MAINT);
+#endif
+
+#if ENABLE_PSCI_STAT
+	plat_psci_stat_accounting_stop(state_info);
+
+	/* Update PSCI stats */
+	psci_stats_update_pwr_up(PSCI_CPU_PWR_LVL, state_info);
+#endif
+}
+
 /*******************************************************************************
  * Top level handler which is called when a cpu wants to suspend its execution.
  * It is assumed that along with suspending the cpu power domain, power domains
@@ -6,12 +6,132 @@
 
 #include <assert.h>
 #include <inttypes.h>
+#include <stddef.h>
 #include <string.h>
 
 #include <common/debug.h>
+#include <lib/cassert.h>
 #include <lib/transfer_list.h>
 #include <lib/utils_def.h>
 
+// the 24-bit tag id and the header size share the first word of a TE header
+CASSERT(sizeof(struct transfer_list_entry) == 8U, assert_tl_entry_size);
+CASSERT(offsetof(struct transfer_list_entry, hdr_size) == 3U,
+	assert_tl_entry_hdr_size_offset);
+
+#if TRANSFER_LIST_INDEX
+// maximum number of tags held by the index
+#define TL_INDEX_MAX_TAGS	U(16)
+
+/*
+ * Index of the first transfer entry of each tag of the last searched transfer
+ * list, built on the first search and kept up to date by the functions of
+ * this file editing the list. It is only used while the list has the size it
+ * was indexed with, and each entry found is checked, so the index is rebuilt
+ * if one of its entries is edited by other means.
+ */
+static struct {
+	const struct transfer_list_header *tl;
+	uint32_t size;		// size of the list when last updated
+	bool complete;		// all tags of the list are in the index
+	unsigned int count;
+	uint32_t tag_id[TL_INDEX_MAX_TAGS];
+	uint32_t offset[TL_INDEX_MAX_TAGS];
+} tl_index;
+
+static bool tl_index_valid(const struct transfer_list_header *tl,
+			   uint32_t size)
+{
+	return tl && tl_index.tl == tl && tl_index.size == size;
+}
+
+static void tl_index_invalidate(void)
+{
+	tl_index.tl = NULL;
+}
+
+/*******************************************************************************
+ * Record the first transfer entry of a tag in the index
+ ******************************************************************************/
+static void tl_index_record(const struct transfer_list_header *tl,
+			    const struct transfer_list_entry *te)
+{
+	unsigned int i;
+
+	if (te->tag_id == TL_TAG_EMPTY) {
+		return;
+	}
+
+	for (i = 0; i < tl_index.count; i++) {
+		if (tl_index.tag_id[i] == te->tag_id) {
+			return;
+		}
+	}
+
+	if (tl_index.count == TL_INDEX_MAX_TAGS) {
+		tl_index.complete = false;
+		return;
+	}
+
+	tl_index.tag_id[tl_index.count] = te->tag_id;
+	tl_index.offset[tl_index.count] = (uintptr_t)te - (uintptr_t)tl;
+	tl_index.count++;
+}
+
+static void tl_index_build(struct transfer_list_header *tl)
+{
+	struct transfer_list_entry *te = NULL;
+
+	tl_index.tl = tl;
+	tl_index.size = tl->size;
+	tl_index.complete = true;
+	tl_index.count = 0;
+
+	while ((te = transfer_list_next(tl, te)) != NULL) {
+		tl_index_record(tl, te);
+	}
+}
+
+/*******************************************************************************
+ * Search for the first transfer entry of a tag in the index
+ * Return true if the index holds the answer, stored in @te, or false if the
+ * list must be walked
+ ******************************************************************************/
+static bool tl_index_find(struct transfer_list_header *tl, uint32_t tag_id,
+			  struct transfer_list_entry **te)
+{
+	unsigned int i;
+
+	if (!tl || tag_id == TL_TAG_EMPTY) {
+		return false;
+	}
+
+	if (!tl_index_valid(tl, tl->size)) {
+		tl_index_build(tl);
+	}
+
+	for (i = 0; i < tl_index.count; i++) {
+		if (tl_index.tag_id[i] != tag_id) {
+			continue;
+		}
+
+		*te = (struct transfer_list_entry *)((uintptr_t)tl +
+						     tl_index.offset[i]);
+		if ((*te)->tag_id != tag_id) {
+			// the list was edited behind our back
+			tl_index_invalidate();
+			return false;
+		}
+
+		return true;
+	}
+
+	*te = NULL;
+
+	return tl_index.complete;
+}
+#endif /* TRANSFER_LIST_INDEX */
+
 void transfer_list_dump(struct transfer_list_header *tl)
 {
 	struct transfer_list_entry *te = NULL;
@@ -61,6 +181,12 @@ struct transfer_list_header *transfer_list_init(void *addr, size_t max_size)
 		return NULL;
 	}
 
+#if TRANSFER_LIST_INDEX
+	if (tl_index.tl == tl) {
+		tl_index_invalidate();
+	}
+#endif
+
 	memset(tl, 0, max_size);
 	tl->signature = TRANSFER_LIST_SIGNATURE;
 	tl->version = TRANSFER_LIST_VERSION;
@@ -110,6 +236,15 @@ struct transfer_list_header *transfer_list_relocate(
 	memmove(new_tl, tl, tl->size);
 	new_tl->max_size = new_max_size;
 
+#if TRANSFER_LIST_INDEX
+	// the offsets of the entries are unchanged
+	if (tl_index_valid(tl, new_tl->size)) {
+		tl_index.tl = new_tl;
+	} else if (tl_index.tl == new_tl) {
+		tl_index_invalidate();
+	}
+#endif
+
 	transfer_list_update_checksum(new_tl);
 
 	return new_tl;
@@ -278,6 +413,10 @@ bool transfer_list_set_data_size(struct transfer_list_header *tl,
 	size_t gap = 0;
 	size_t mov_dis = 0;
 	size_t sz = 0;
+#if TRANSFER_LIST_INDEX
+	bool indexed;
+	unsigned int i;
+#endif
 
 	if (!tl || !te) {
 		return false;
@@ -297,6 +436,10 @@ bool transfer_list_set_data_size(struct transfer_list_header *tl,
 		return false;
 	}
 
+#if TRANSFER_LIST_INDEX
+	indexed = tl_index_valid(tl, tl->size);
+#endif
+
 	if (new_ev > old_ev) {
 		// move distance should be roundup
 		// to meet the requirement of TE data max alignment
@@ -311,6 +454,19 @@ bool transfer_list_set_data_size(struct transfer_list_header *tl,
 		memmove((void *)ru_new_ev, (void *)old_ev, tl_old_ev - old_ev);
 		tl->size += mov_dis;
 		gap = ru_new_ev - new_ev;
+
+#if TRANSFER_LIST_INDEX
+		// the entries following the updated one moved up
+		if (indexed) {
+			for (i = 0; i < tl_index.count; i++) {
+				if ((uintptr_t)tl + tl_index.offset[i] >=
+				    old_ev) {
+					tl_index.offset[i] += mov_dis;
+				}
+			}
+			tl_index.size = tl->size;
+		}
+#endif
 	} else {
 		gap = old_ev - new_ev;
 	}
@@ -319,7 +475,6 @@ bool transfer_list_set_data_size(struct transfer_list_header *tl,
 		// create a dummy TE to fill up the gap
 		dummy_te = (struct transfer_list_entry *)new_ev;
 		dummy_te->tag_id = TL_TAG_EMPTY;
-		dummy_te->reserved0 = 0;
 		dummy_te->hdr_size = sizeof(*dummy_te);
 		dummy_te->data_size = gap - sizeof(*dummy_te);
 	}
@@ -340,8 +495,101 @@ bool transfer_list_rem(struct transfer_list_header *tl,
 	if (!tl || !te || (uintptr_t)te > (uintptr_t)tl + tl->size) {
 		return false;
 	}
+#if TRANSFER_LIST_INDEX
+	// another entry with the same tag may follow the removed one
+	if (tl_index.tl == tl) {
+		tl_index_invalidate();
+	}
+#endif
 	te->tag_id = TL_TAG_EMPTY;
-	te->reserved0 = 0;
+	transfer_list_update_checksum(tl);
+	return true;
+}
+
+/*******************************************************************************
+ * Reclaim the space of the void transfer entries of a transfer list in place,
+ * by moving the following entries down. An entry is only moved by a multiple
+ * of the maximum alignment of the list, to keep the alignment of its data, and
+ * an empty TE fills up the gap left before it, if any.
+ * The pointers to the entries of the list are invalid afterwards.
+ * Return true on success or false on error
+ ******************************************************************************/
+bool transfer_list_compact(struct transfer_list_header *tl)
+{
+	struct transfer_list_entry *te = NULL, *next = NULL;
+	uintptr_t tl_ev, align_mask, ev = 0, wp, dst;
+	bool has_void = false;
+	size_t sz = 0;
+
+	if (!tl) {
+		return false;
+	}
+
+	tl_ev = (uintptr_t)tl + tl->size;
+	wp = (uintptr_t)tl + tl->hdr_size;
+
+	// check that the entries cover the whole list before moving any
+	while ((te = transfer_list_next(tl, te)) != NULL) {
+		if (te->tag_id == TL_TAG_EMPTY) {
+			has_void = true;
+		}
+		if (add_overflow(te->hdr_size, te->data_size, &sz) ||
+			add_with_round_up_overflow((uintptr_t)te, sz,
+			TRANSFER_LIST_GRANULE, &ev)) {
+			return false;
+		}
+	}
+
+	if ((ev != 0 && ev != tl_ev) || (ev == 0 && wp != tl_ev)) {
+		return false;
+	}
+
+	if (!has_void) {
+		return true;
+	}
+
+	align_mask = (1 << tl->alignment) - 1;
+	te = transfer_list_next(tl, NULL);
+
+	while (te) {
+		// find the next entry before this one is overwritten
+		next = transfer_list_next(tl, te);
+		if (te->tag_id == TL_TAG_EMPTY) {
+			te = next;
+			continue;
+		}
+
+		sz = round_up(te->hdr_size + te->data_size,
+			      TRANSFER_LIST_GRANULE);
+		dst = wp + (((uintptr_t)te - wp) & align_mask);
+
+		if (dst != wp) {
+			// fill the gap with an empty TE
+			struct transfer_list_entry *dummy_te =
+				(struct transfer_list_entry *)wp;
+
+			dummy_te->tag_id = TL_TAG_EMPTY;
+			dummy_te->hdr_size = sizeof(*dummy_te);
+			dummy_te->data_size = dst - wp - sizeof(*dummy_te);
+		}
+
+		if (dst != (uintptr_t)te) {
+			memmove((void *)dst, te, sz);
+		}
+
+		wp = dst + sz;
+		te = next;
+	}
+
+	memset((void *)wp, 0, tl_ev - wp);
+	tl->size = wp - (uintptr_t)tl;
+
+#if TRANSFER_LIST_INDEX
+	if (tl_index.tl == tl) {
+		tl_index_invalidate();
+	}
+#endif
+
 	transfer_list_update_checksum(tl);
 	return true;
 }
@@ -352,7 +600,7 @@ bool transfer_list_rem(struct transfer_list_header *tl,
  * Return pointer to the added transfer entry or NULL on error
  ******************************************************************************/
 struct transfer_list_entry *transfer_list_add(struct transfer_list_header *tl,
-					      uint16_t tag_id,
+					      uint32_t tag_id,
 					      uint32_t data_size,
 					      const void *data)
 {
@@ -379,9 +627,15 @@ struct transfer_list_entry *transfer_list_add(struct transfer_list_header *tl,
 
 	te = (struct transfer_list_entry *)tl_ev;
 	te->tag_id = tag_id;
-	te->reserved0 = 0;
 	te->hdr_size = sizeof(*te);
 	te->data_size = data_size;
+
+#if TRANSFER_LIST_INDEX
+	if (tl_index_valid(tl, tl->size)) {
+		tl_index_record(tl, te);
+		tl_index.size = tl->size + (ev - tl_ev);
+	}
+#endif
 	tl->size += ev - tl_ev;
 
 	if (data) {
@@ -406,7 +660,7 @@ struct transfer_list_entry *transfer_list_add(struct transfer_list_header *tl,
  ******************************************************************************/
 struct transfer_list_entry *transfer_list_add_with_align(
 					struct transfer_list_header *tl,
-					uint16_t tag_id, uint32_t data_size,
+					uint32_t tag_id, uint32_t data_size,
 					const void *data, uint8_t alignment)
 {
 	struct transfer_list_entry *te = NULL;
@@ -450,13 +704,20 @@ struct transfer_list_entry *transfer_list_add_with_align(
  * Return pointer to the found transfer entry or NULL on error
  ******************************************************************************/
 struct transfer_list_entry *transfer_list_find(struct transfer_list_header *tl,
-					       uint16_t tag_id)
+					       uint32_t tag_id)
 {
 	struct transfer_list_entry *te = NULL;
 
+#if TRANSFER_LIST_INDEX
+	if (tl_index_find(tl, tag_id, &te)) {
+		return te;
+	}
+	te = NULL;
+#endif
+
 	do {
 		te = transfer_list_next(tl, te);
-	} while (te && (te->tag_id != tag_id || te->reserved0 != 0));
+	} while (te && (te->tag_id != tag_id));
 
 	return te;
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2021, Arm Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2023, Arm Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -119,6 +119,24 @@ void xlat_arch_tlbi_va(uintptr_t va, int xlat_regime)
 	}
 }
 
+bool xlat_arch_tlbi_va_range(uintptr_t va, size_t size, int xlat_regime)
+{
+	/* There are no range invalidation instructions in AArch32. */
+	return false;
+}
+
+void xlat_arch_tlbi_all(int xlat_regime)
+{
+	dsbishst();
+
+	if (xlat_regime == EL1_EL0_REGIME) {
+		tlbiallis();
+	} else {
+		assert(xlat_regime == EL2_REGIME);
+		tlbiallhis();
+	}
+}
+
 void xlat_arch_tlbi_va_sync(void)
 {
 	/* Invalidate all entries from branch predictors. */
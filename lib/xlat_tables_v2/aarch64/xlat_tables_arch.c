@@ -211,6 +211,79 @@ void xlat_arch_tlbi_va(uintptr_t va, int xlat_regime)
 	}
 }
 
+/* The range invalidations below assume the 4KB granule used by the tables. */
+CASSERT(PAGE_SIZE == PAGE_SIZE_4KB, assert_tlbi_range_granule_is_4kb);
+
+bool xlat_arch_tlbi_va_range(uintptr_t va, size_t size, int xlat_regime)
+{
+	unsigned long long pages, unit = 0ULL;
+	unsigned int scale;
+	uint64_t op;
+
+	if (!is_armv8_4_tlbirange_present()) {
+		return false;
+	}
+
+	/*
+	 * A range instruction invalidates (NUM + 1) * 2^(5 * SCALE + 1) pages,
+	 * find the smallest scale that covers the whole range.
+	 */
+	pages = ((va & PAGE_SIZE_MASK) + size + PAGE_SIZE_MASK) >>
+		PAGE_SIZE_SHIFT;
+	for (scale = 0U; scale <= TLBI_RANGE_SCALE_MAX; scale++) {
+		unit = 1ULL << ((5U * scale) + 1U);
+		if (pages <= ((TLBI_RANGE_NUM_MAX + 1ULL) * unit)) {
+			break;
+		}
+	}
+
+	if (scale > TLBI_RANGE_SCALE_MAX) {
+		return false;
+	}
+
+	op = (TLBI_RANGE_TG_4KB << TLBI_RANGE_TG_SHIFT) |
+	     ((uint64_t)scale << TLBI_RANGE_SCALE_SHIFT) |
+	     ((((pages + unit - 1ULL) / unit) - 1ULL) << TLBI_RANGE_NUM_SHIFT) |
+	     ((va >> PAGE_SIZE_SHIFT) & TLBI_RANGE_BADDR_MASK);
+
+	/*
+	 * Ensure the translation table writes have drained into memory before
+	 * invalidating the TLB entries.
+	 */
+	dsbishst();
+
+	if (xlat_regime == EL1_EL0_REGIME) {
+		assert(xlat_arch_current_el() >= 1U);
+		tlbirvaae1is(op);
+	} else if (xlat_regime == EL2_REGIME) {
+		assert(xlat_arch_current_el() >= 2U);
+		tlbirvae2is(op);
+	} else {
+		assert(xlat_regime == EL3_REGIME);
+		assert(xlat_arch_current_el() >= 3U);
+		tlbirvae3is(op);
+	}
+
+	return true;
+}
+
+void xlat_arch_tlbi_all(int xlat_regime)
+{
+	dsbishst();
+
+	if (xlat_regime == EL1_EL0_REGIME) {
+		assert(xlat_arch_current_el() >= 1U);
+		tlbivmalle1is();
+	} else if (xlat_regime == EL2_REGIME) {
+		assert(xlat_arch_current_el() >= 2U);
+		tlbialle2is();
+	} else {
+		assert(xlat_regime == EL3_REGIME);
+		assert(xlat_arch_current_el() >= 3U);
+		tlbialle3is();
+	}
+}
+
 void xlat_arch_tlbi_va_sync(void)
 {
 	/*
@@ -90,6 +90,21 @@ int mmap_remove_dynamic_region(uintptr_t base_va, size_t size)
 					base_va, size);
 }
 
+void xlat_begin_batch(void)
+{
+	xlat_begin_batch_ctx(&tf_xlat_ctx);
+}
+
+void xlat_commit_batch(void)
+{
+	xlat_commit_batch_ctx(&tf_xlat_ctx);
+}
+
+unsigned long long xlat_get_tlbi_count(void)
+{
+	return xlat_get_tlbi_count_ctx(&tf_xlat_ctx);
+}
+
 #endif /* PLAT_XLAT_TABLES_DYNAMIC */
 
 void __init init_xlat_tables(void)
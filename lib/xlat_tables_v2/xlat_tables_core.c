@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2021, Arm Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2023, Arm Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -55,9 +55,72 @@ static int xlat_table_get_index(const xlat_ctx_t *ctx, const uint64_t *table)
 	return -1;
 }
 
-/* Returns a pointer to an empty translation table. */
-static uint64_t *xlat_table_get_empty(const xlat_ctx_t *ctx)
+/*
+ * Issues the TLB invalidations deferred by an open batch, see
+ * xlat_begin_batch_ctx().
+ */
+static void xlat_tlbi_flush_ctx(xlat_ctx_t *ctx)
+{
+	if (ctx->tlbi_pending == 0U)
+		return;
+
+	if ((ctx->tlbi_pending > 1U) &&
+	    xlat_arch_tlbi_va_range(ctx->tlbi_min_va,
+				    ctx->tlbi_max_va - ctx->tlbi_min_va + 1U,
+				    ctx->xlat_regime)) {
+		ctx->tlbi_count++;
+	} else if (ctx->tlbi_pending <= XLAT_TLBI_BATCH_MAX) {
+		for (unsigned int i = 0U; i < ctx->tlbi_pending; i++) {
+			xlat_arch_tlbi_va(ctx->tlbi_pending_va[i],
+					  ctx->xlat_regime);
+		}
+		ctx->tlbi_count += ctx->tlbi_pending;
+	} else {
+		xlat_arch_tlbi_all(ctx->xlat_regime);
+		ctx->tlbi_count++;
+	}
+
+	xlat_arch_tlbi_va_sync();
+
+	ctx->tlbi_pending = 0U;
+}
+
+/*
+ * Invalidates the TLB entries for the VA of a descriptor of the given level
+ * that has been modified, or records it to be invalidated when the open batch
+ * is committed, along with the VA range the descriptor covered.
+ */
+static void xlat_tlbi_va_ctx(xlat_ctx_t *ctx, uintptr_t va,
+			     unsigned int level)
+{
+	uintptr_t end_va = va + XLAT_BLOCK_SIZE(level) - 1U;
+
+	if (ctx->batch_depth == 0U) {
+		xlat_arch_tlbi_va(va, ctx->xlat_regime);
+		ctx->tlbi_count++;
+		return;
+	}
+
+	if ((ctx->tlbi_pending == 0U) || (va < ctx->tlbi_min_va))
+		ctx->tlbi_min_va = va;
+	if ((ctx->tlbi_pending == 0U) || (end_va > ctx->tlbi_max_va))
+		ctx->tlbi_max_va = end_va;
+
+	if (ctx->tlbi_pending < XLAT_TLBI_BATCH_MAX)
+		ctx->tlbi_pending_va[ctx->tlbi_pending] = va;
+
+	ctx->tlbi_pending++;
+}
+
+/*
+ * Returns a pointer to an empty translation table. A table freed earlier in an
+ * open batch may still be referenced by TLB walk cache entries, so pending
+ * invalidations are issued before any table is reused.
+ */
+static uint64_t *xlat_table_get_empty(xlat_ctx_t *ctx)
 {
+	xlat_tlbi_flush_ctx(ctx);
+
 	for (int i = 0; i < ctx->tables_num; i++)
 		if (ctx->tables_mapped_regions[i] == 0)
 			return ctx->tables[i];
@@ -389,7 +452,7 @@ static void xlat_tables_unmap_region(xlat_ctx_t *ctx, mmap_region_t *mm,
 		if (action == ACTION_WRITE_BLOCK_ENTRY) {
 
 			table_base[table_idx] = INVALID_DESC;
-			xlat_arch_tlbi_va(table_idx_va, ctx->xlat_regime);
+			xlat_tlbi_va_ctx(ctx, table_idx_va, level);
 
 		} else if (action == ACTION_RECURSE_INTO_TABLE) {
 
@@ -408,8 +471,7 @@ static void xlat_tables_unmap_region(xlat_ctx_t *ctx, mmap_region_t *mm,
 			 */
 			if (xlat_table_is_empty(ctx, subtable)) {
 				table_base[table_idx] = INVALID_DESC;
-				xlat_arch_tlbi_va(table_idx_va,
-						  ctx->xlat_regime);
+				xlat_tlbi_va_ctx(ctx, table_idx_va, level);
 			}
 
 		} else {
@@ -561,6 +623,58 @@ static action_t xlat_tables_map_region_action(const mmap_region_t *mm,
 	}
 }
 
+/*
+ * Returns true if the group of XLAT_CONTIG_ENTRIES entries of the given table
+ * that starts at table_idx can be mapped with the Contiguous hint set. This
+ * is the case when all the entries of the group are going to be written as
+ * block (or page) descriptors of the same region, with the same attributes,
+ * pointing to a physical range that is aligned to the size of the group.
+ *
+ * The entries of the group must all be invalid so that the hint is only ever
+ * set when the descriptors are first written. Setting it on live descriptors
+ * would require a break-before-make sequence.
+ *
+ * The region must also have been mapped with MT_CONTIG, as the attributes of
+ * a group can't be changed later without unmapping all of its entries.
+ */
+static bool xlat_tables_contig_allowed(const mmap_region_t *mm,
+				       const uint64_t *table_base,
+				       unsigned int table_entries,
+				       unsigned int table_idx,
+				       uintptr_t table_idx_va,
+				       unsigned int level)
+{
+	unsigned long long group_size = XLAT_CONTIG_SIZE(level);
+	unsigned long long group_end_va, group_pa;
+
+	if ((mm->attr & MT_CONTIG) == 0U)
+		return false;
+
+	if (((table_idx & (XLAT_CONTIG_ENTRIES - 1U)) != 0U) ||
+	    ((table_idx + XLAT_CONTIG_ENTRIES) > table_entries))
+		return false;
+
+	if ((level < MIN_LVL_BLOCK_DESC) ||
+	    (mm->granularity < XLAT_BLOCK_SIZE(level)))
+		return false;
+
+	group_end_va = (unsigned long long)table_idx_va + group_size - 1ULL;
+	if ((table_idx_va < mm->base_va) ||
+	    (group_end_va > ((unsigned long long)mm->base_va + mm->size - 1ULL)))
+		return false;
+
+	group_pa = mm->base_pa + table_idx_va - mm->base_va;
+	if ((group_pa & (group_size - 1ULL)) != 0ULL)
+		return false;
+
+	for (unsigned int i = 0U; i < XLAT_CONTIG_ENTRIES; i++) {
+		if ((table_base[table_idx + i] & DESC_MASK) != INVALID_DESC)
+			return false;
+	}
+
+	return true;
+}
+
 /*
  * Recursive function that writes to the translation tables and maps the
  * specified region. On success, it returns the VA of the last byte that was
@@ -585,6 +699,12 @@ static uintptr_t xlat_tables_map_region(xlat_ctx_t *ctx, mmap_region_t *mm,
 
 	unsigned int table_idx;
 
+	/*
+	 * Contiguous hint applied to the entries of the group being written,
+	 * if any. See xlat_tables_contig_allowed().
+	 */
+	uint64_t contig_hint = 0ULL;
+
 	table_idx_va = xlat_tables_find_start_va(mm, table_base_va, level);
 	table_idx = xlat_tables_va_to_index(table_base_va, table_idx_va, level);
 
@@ -597,6 +717,13 @@ static uintptr_t xlat_tables_map_region(xlat_ctx_t *ctx, mmap_region_t *mm,
 
 		desc = table_base[table_idx];
 
+		if ((table_idx & (XLAT_CONTIG_ENTRIES - 1U)) == 0U) {
+			contig_hint = xlat_tables_contig_allowed(mm, table_base,
+						table_entries, table_idx,
+						table_idx_va, level) ?
+				UPPER_ATTRS(CONT_HINT) : 0ULL;
+		}
+
 		table_idx_pa = mm->base_pa + table_idx_va - mm->base_va;
 
 		action_t action = xlat_tables_map_region_action(mm,
@@ -607,7 +734,7 @@ static uintptr_t xlat_tables_map_region(xlat_ctx_t *ctx, mmap_region_t *mm,
 
 			table_base[table_idx] =
 				xlat_desc(ctx, (uint32_t)mm->attr, table_idx_pa,
-					  level);
+					  level) | contig_hint;
 
 		} else if (action == ACTION_CREATE_NEW_TABLE) {
 			uintptr_t end_va;
@@ -1001,6 +1128,16 @@ int mmap_add_dynamic_region_ctx(xlat_ctx_t *ctx, mmap_region_t *mm)
 	 * not, this region will be mapped when they are initialized.
 	 */
 	if (ctx->initialized) {
+		/*
+		 * The new region must not be reached through TLB entries of
+		 * regions removed in the open batch.
+		 */
+		if ((ctx->tlbi_pending != 0U) &&
+		    (mm->base_va <= ctx->tlbi_max_va) &&
+		    (end_va >= ctx->tlbi_min_va)) {
+			xlat_tlbi_flush_ctx(ctx);
+		}
+
 		end_va = xlat_tables_map_region(ctx, mm_cursor,
 				0U, ctx->base_table, ctx->base_table_entries,
 				ctx->base_level);
@@ -1123,7 +1260,8 @@ int mmap_remove_dynamic_region_ctx(xlat_ctx_t *ctx, uintptr_t base_va,
 		xlat_clean_dcache_range((uintptr_t)ctx->base_table,
 			ctx->base_table_entries * sizeof(uint64_t));
 #endif
-		xlat_arch_tlbi_va_sync();
+		if (ctx->batch_depth == 0U)
+			xlat_arch_tlbi_va_sync();
 	}
 
 	/* Remove this region by moving the rest down by one place. */
@@ -1153,6 +1291,30 @@ int mmap_remove_dynamic_region_ctx(xlat_ctx_t *ctx, uintptr_t base_va,
 	return 0;
 }
 
+void xlat_begin_batch_ctx(xlat_ctx_t *ctx)
+{
+	assert(ctx != NULL);
+
+	ctx->batch_depth++;
+}
+
+void xlat_commit_batch_ctx(xlat_ctx_t *ctx)
+{
+	assert(ctx != NULL);
+	assert(ctx->batch_depth > 0U);
+
+	ctx->batch_depth--;
+	if (ctx->batch_depth == 0U)
+		xlat_tlbi_flush_ctx(ctx);
+}
+
+unsigned long long xlat_get_tlbi_count_ctx(const xlat_ctx_t *ctx)
+{
+	assert(ctx != NULL);
+
+	return ctx->tlbi_count;
+}
+
 void xlat_setup_dynamic_ctx(xlat_ctx_t *ctx, unsigned long long pa_max,
 			    uintptr_t va_max, struct mmap_region *mmap,
 			    unsigned int mmap_num, uint64_t **tables,
@@ -1178,6 +1340,10 @@ void xlat_setup_dynamic_ctx(xlat_ctx_t *ctx, unsigned long long pa_max,
 
 	ctx->tables_mapped_regions = mapped_regions;
 
+	ctx->batch_depth = 0U;
+	ctx->tlbi_pending = 0U;
+	ctx->tlbi_count = 0ULL;
+
 	ctx->max_pa = 0;
 	ctx->max_va = 0;
 	ctx->initialized = 0;
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2021, Arm Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2023, Arm Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -63,8 +63,19 @@ uint64_t xlat_arch_regime_get_xn_desc(int xlat_regime);
 void xlat_arch_tlbi_va(uintptr_t va, int xlat_regime);
 
 /*
- * This function has to be called at the end of any code that uses the function
- * xlat_arch_tlbi_va().
+ * Invalidate all TLB entries for a range of virtual addresses with a single
+ * range invalidation. Returns false, without doing anything, if FEAT_TLBIRANGE
+ * is not implemented or the range is too large for one instruction.
+ */
+bool xlat_arch_tlbi_va_range(uintptr_t va, size_t size, int xlat_regime);
+
+/* Invalidate all TLB entries of the given translation regime. */
+void xlat_arch_tlbi_all(int xlat_regime);
+
+/*
+ * This function has to be called at the end of any code that uses the
+ * functions xlat_arch_tlbi_va(), xlat_arch_tlbi_va_range() or
+ * xlat_arch_tlbi_all().
  */
 void xlat_arch_tlbi_va_sync(void);
 
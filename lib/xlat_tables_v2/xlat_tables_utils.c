@@ -205,6 +205,8 @@ static void xlat_tables_print_internal(xlat_ctx_t *ctx, uintptr_t table_base_va,
 				       (uint64_t)(desc & TABLE_ADDR_MASK),
 				       level_size);
 				xlat_desc_print(ctx, desc);
+				if ((desc & UPPER_ATTRS(CONT_HINT)) != 0ULL)
+					printf("-CONT");
 				printf("\n");
 			}
 		}
@@ -443,7 +445,6 @@ int xlat_get_mem_attributes_ctx(const xlat_ctx_t *ctx, uintptr_t base_va,
 				NULL, NULL, NULL);
 }
 
-
 int xlat_change_mem_attributes_ctx(const xlat_ctx_t *ctx, uintptr_t base_va,
 				   size_t size, uint32_t attr)
 {
@@ -519,6 +520,16 @@ int xlat_change_mem_attributes_ctx(const xlat_ctx_t *ctx, uintptr_t base_va,
 			return -EINVAL;
 		}
 
+		/*
+		 * Pages that are part of a contiguous group can't be changed
+		 * individually without unmapping the rest of the group.
+		 */
+		if ((desc & UPPER_ATTRS(CONT_HINT)) != 0ULL) {
+			WARN("Address 0x%lx is mapped with the Contiguous hint.\n",
+			     base_va);
+			return -EINVAL;
+		}
+
 		/*
 		 * If the region type is device, it shouldn't be executable.
 		 */
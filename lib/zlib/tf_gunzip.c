@@ -9,6 +9,7 @@
 #include <string.h>
 
 #include <common/debug.h>
+#include <common/image_decompress.h>
 #include <common/tf_crc32.h>
 #include <lib/utils.h>
 #include <tf_gunzip.h>
@@ -102,6 +103,107 @@ int gunzip(uintptr_t *in_buf, size_t in_len, uintptr_t *out_buf,
 	return ret;
 }
 
+const image_decompressor_t gunzip_decompressor = {
+	.name = "gzip",
+	.magic = { 0x1f, 0x8b },
+	.magic_len = 2U,
+	.decompress = gunzip,
+};
+
+#if IMAGE_DECOMPRESS_STREAM
+static z_stream gunzip_strm;
+
+/*
+ * gunzip_stream_init - start decompressing gzip data fed in chunks
+ * @out_buf: destination of decompressed output
+ * @out_len: length of out_buf
+ * @work_buf: workspace, which must be kept until the end of the stream
+ * @work_len: length of workspace
+ */
+static int gunzip_stream_init(uintptr_t out_buf, size_t out_len,
+			      uintptr_t work_buf, size_t work_len)
+{
+	int zret;
+
+	zalloc_start = work_buf;
+	zalloc_end = work_buf + work_len;
+	zalloc_current = zalloc_start;
+
+	memset(&gunzip_strm, 0, sizeof(gunzip_strm));
+	gunzip_strm.next_out = (typeof(gunzip_strm.next_out))out_buf;
+	gunzip_strm.avail_out = out_len;
+	gunzip_strm.zalloc = zcalloc;
+	gunzip_strm.zfree = zfree;
+	gunzip_strm.opaque = (voidpf)0;
+
+	zret = inflateInit(&gunzip_strm);
+	if (zret != Z_OK) {
+		ERROR("zlib: inflate init failed (ret = %d)\n", zret);
+		return (zret == Z_MEM_ERROR) ? -ENOMEM : -EIO;
+	}
+
+	return 0;
+}
+
+/*
+ * gunzip_stream_update - decompress the next chunk of gzip data
+ * @in_buf: chunk of compressed input
+ * @in_len: length of in_buf
+ *
+ * Return 1 at the end of the stream, 0 if more input is needed, or a negative
+ * error code. Unlike gunzip(), the decompressor keeps a window of the output
+ * in its workspace, to resolve back-references across chunks.
+ */
+static int gunzip_stream_update(uintptr_t in_buf, size_t in_len)
+{
+	int zret;
+
+	gunzip_strm.next_in = (typeof(gunzip_strm.next_in))in_buf;
+	gunzip_strm.avail_in = in_len;
+
+	zret = inflate(&gunzip_strm, Z_NO_FLUSH);
+	if (zret == Z_STREAM_END) {
+		return 1;
+	}
+
+	/* Input left over means that the output buffer is full */
+	if (((zret == Z_OK) || (zret == Z_BUF_ERROR)) &&
+	    (gunzip_strm.avail_in == 0U)) {
+		return 0;
+	}
+
+	if (gunzip_strm.msg)
+		VERBOSE("%s\n", gunzip_strm.msg);
+	VERBOSE("zlib: inflate failed (ret = %d)\n", zret);
+	inflateEnd(&gunzip_strm);
+
+	return (zret == Z_MEM_ERROR) ? -ENOMEM : -EIO;
+}
+
+/*
+ * gunzip_stream_finish - end the decompression of gzip data
+ * @out_buf: Upon exit, the end of output.
+ */
+static int gunzip_stream_finish(uintptr_t *out_buf)
+{
+	VERBOSE("zlib: %lu byte input\n", gunzip_strm.total_in);
+	VERBOSE("zlib: %lu byte output\n", gunzip_strm.total_out);
+
+	*out_buf = (uintptr_t)gunzip_strm.next_out;
+
+	inflateEnd(&gunzip_strm);
+
+	return 0;
+}
+
+const decompressor_stream_t gunzip_stream = {
+	.format = &gunzip_decompressor,
+	.init = gunzip_stream_init,
+	.update = gunzip_stream_update,
+	.finish = gunzip_stream_finish,
+};
+#endif /* IMAGE_DECOMPRESS_STREAM */
+
 /* Wrapper function to calculate CRC
  * @crc: previous accumulated CRC
  * @buf: buffer base address
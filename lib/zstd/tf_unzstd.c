@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2026, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <errno.h>
+
+#include <common/debug.h>
+#include <lib/utils_def.h>
+#include <tf_unzstd.h>
+
+#define ZSTD_STATIC_LINKING_ONLY
+#include "zstd.h"
+
+/* The decompression context must be aligned on 8 bytes */
+#define ZSTD_DCTX_ALIGNMENT	8U
+
+/*
+ * unzstd - decompress zstd data
+ * @in_buf: source of compressed input. Upon exit, the end of input.
+ * @in_len: length of in_buf
+ * @out_buf: destination of decompressed output. Upon exit, the end of output.
+ * @out_len: length of out_buf
+ * @work_buf: workspace, holding the decompression context
+ * @work_len: length of workspace
+ *
+ * The whole input must be made of zstd frames, which are decompressed in a
+ * single pass, using the output buffer as the window.
+ */
+int unzstd(uintptr_t *in_buf, size_t in_len, uintptr_t *out_buf,
+	   size_t out_len, uintptr_t work_buf, size_t work_len)
+{
+	uintptr_t work_base = round_up(work_buf, ZSTD_DCTX_ALIGNMENT);
+	ZSTD_DCtx *dctx;
+	size_t zret;
+
+	if ((work_base - work_buf) >= work_len) {
+		return -ENOMEM;
+	}
+
+	dctx = ZSTD_initStaticDCtx((void *)work_base,
+				   work_len - (work_base - work_buf));
+	if (dctx == NULL) {
+		ERROR("zstd: workspace too small (%zu bytes needed)\n",
+		      ZSTD_estimateDCtxSize());
+		return -ENOMEM;
+	}
+
+	zret = ZSTD_decompressDCtx(dctx, (void *)*out_buf, out_len,
+				   (const void *)*in_buf, in_len);
+	if (ZSTD_isError(zret) != 0U) {
+		ERROR("zstd: decompression failed (%s)\n",
+		      ZSTD_getErrorName(zret));
+		return (ZSTD_getErrorCode(zret) ==
+			ZSTD_error_dstSize_tooSmall) ? -ENOMEM : -EIO;
+	}
+
+	VERBOSE("zstd: %zu byte input\n", in_len);
+	VERBOSE("zstd: %zu byte output\n", zret);
+
+	*in_buf += in_len;
+	*out_buf += zret;
+
+	return 0;
+}
+
+const image_decompressor_t unzstd_decompressor = {
+	.name = "zstd",
+	.magic = { 0x28, 0xb5, 0x2f, 0xfd },
+	.magic_len = 4U,
+	.decompress = unzstd,
+};
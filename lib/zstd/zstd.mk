@@ -0,0 +1,32 @@
+#
+# Copyright (c) 2026, Arm Limited and Contributors. All rights reserved.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+
+ZSTD_PATH	:=	lib/zstd
+
+# Imported from zstd 1.5.7, decompression only (do not modify them, except
+# common/zstd_deps.h which does not use malloc() in TF)
+ZSTD_SOURCES	:=	$(addprefix $(ZSTD_PATH)/,			\
+					common/debug.c			\
+					common/entropy_common.c		\
+					common/error_private.c		\
+					common/fse_decompress.c		\
+					common/xxhash.c			\
+					common/zstd_common.c		\
+					decompress/huf_decompress.c	\
+					decompress/zstd_ddict.c		\
+					decompress/zstd_decompress.c	\
+					decompress/zstd_decompress_block.c)
+
+# Implemented for TF
+ZSTD_SOURCES	+=	$(addprefix $(ZSTD_PATH)/,	\
+					tf_unzstd.c)
+
+INCLUDES	+=	-Iinclude/lib/zstd
+
+# REVISIT: the following flags need not be given globally
+TF_CFLAGS	+=	-DZSTD_LEGACY_SUPPORT=0 -DZSTD_TRACE=0			\
+			-DZSTD_DISABLE_ASM -DDYNAMIC_BMI2=0 -DZSTD_NO_INTRINSICS	\
+			-DXXH_NO_STDLIB
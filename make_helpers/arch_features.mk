@@ -22,6 +22,10 @@
 # 8.1
 #----
 
+# Flag to enable the CRC32 instructions. They are optional in 8.0, so they are
+# used if they are detected at runtime.
+ENABLE_FEAT_CRC32		:=	2
+
 # Flag to enable access to Privileged Access Never bit of PSTATE.
 ENABLE_FEAT_PAN			:=	0
 
@@ -110,6 +114,7 @@ ENABLE_FEAT_TCR2		:=	0
 
 # Enable the features which are mandatory from ARCH version 8.1 and upwards.
 ifeq "8.1" "$(word 1, $(sort 8.1 $(ARM_ARCH_MAJOR).$(ARM_ARCH_MINOR)))"
+ENABLE_FEAT_CRC32			:=	1
 ENABLE_FEAT_PAN				:=	1
 ENABLE_FEAT_VHE				:=	1
 endif
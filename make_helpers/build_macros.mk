@@ -284,6 +284,24 @@ endef
 
 GZIP_SUFFIX := .gz
 
+# LZ4
+define LZ4_RULE
+$(1): $(2)
+	$(ECHO) "  LZ4     $$@"
+	$(Q)lz4 -9 -f -q $$< $$@
+endef
+
+LZ4_SUFFIX := .lz4
+
+# ZSTD
+define ZSTD_RULE
+$(1): $(2)
+	$(ECHO) "  ZSTD    $$@"
+	$(Q)zstd -19 -f -q $$< -o $$@
+endef
+
+ZSTD_SUFFIX := .zst
+
 ################################################################################
 # Auxiliary macros to build TF images from sources
 ################################################################################
@@ -26,6 +26,9 @@ ARM_ARCH_FEATURE		:= none
 ARM_ARCH_MAJOR			:= 8
 ARM_ARCH_MINOR			:= 0
 
+# Cache the certificates verified by a boot stage for the next boot stages
+AUTH_VERIFIED_CACHE		:= 0
+
 # Base commit to perform code check on
 BASE_COMMIT			:= origin/master
 
@@ -49,6 +52,9 @@ BRANCH_PROTECTION		:= 0
 # The platform Makefile is free to override this value.
 COLD_BOOT_SINGLE_CPU		:= 0
 
+# Buffer the runtime console output of BL31 and write it out later
+CONSOLE_DEFERRED_LOG		:= 0
+
 # Flag to compile in coreboot support code. Exclude by default. The coreboot
 # Makefile system will set this when compiling TF as part of a coreboot image.
 COREBOOT			:= 0
@@ -97,12 +103,18 @@ ENABLE_PSCI_STAT		:= 0
 # Flag to enable runtime instrumentation using PMF
 ENABLE_RUNTIME_INSTRUMENTATION	:= 0
 
+# Keep per-CPU latency histograms of SMCs, interrupts and world switches in PMF
+PMF_LATENCY_HIST		:= 0
+
 # Flag to enable stack corruption protection
 ENABLE_STACK_PROTECTOR		:= 0
 
 # Flag to enable exception handling in EL3
 EL3_EXCEPTION_HANDLING		:= 0
 
+# Record EL3 events in per-CPU trace rings shared with the normal world
+EL3_TRACE			:= 0
+
 # By default BL31 encryption disabled
 ENCRYPT_BL31			:= 0
 
@@ -150,14 +162,23 @@ HANDLE_EA_EL3_FIRST_NS		:= 0
 # Enable Handoff protocol using transfer lists
 TRANSFER_LIST			:= 0
 
+# Index the entries of transfer lists by tag to speed up their lookups
+TRANSFER_LIST_INDEX		:= 0
+
 # Secure hash algorithm flag, accepts 3 values: sha256, sha384 and sha512.
 # The default value is sha256.
 HASH_ALG			:= sha256
 
+# Hash images while they are loaded, for their authentication and measurement
+HASH_ON_LOAD			:= 0
+
 # Whether system coherency is managed in hardware, without explicit software
 # operations.
 HW_ASSISTED_COHERENCY		:= 0
 
+# Whether compressed images are inflated while they are loaded
+IMAGE_DECOMPRESS_STREAM		:= 0
+
 # Flag to enable trapping of implementation defined sytem registers
 IMPDEF_SYSREG_TRAP		:= 0
 
@@ -191,6 +212,12 @@ PSCI_EXTENDED_STATE_ID		:= 0
 # Enable PSCI OS-initiated mode support
 PSCI_OS_INIT_MODE		:= 0
 
+# Count the running CPUs of each PSCI power domain
+PSCI_COUNT_RUNNING_CPUS		:= 0
+
+# Use ticket locks instead of spinlocks for PSCI power domain locks
+PSCI_USE_TICKET_LOCK		:= 0
+
 # Enable RAS Firmware First Handling Support
 RAS_FFH_SUPPORT			:= 0
 
@@ -215,6 +242,9 @@ ERRATA_NON_ARM_INTERCONNECT	:= 0
 # SMCCC PCI support
 SMC_PCI_SUPPORT			:= 0
 
+# Dispatch the SMCs that have a fast-path handler directly to it
+SMC_FAST_PATH			:= 0
+
 # Whether code and read-only data should be put on separate memory pages. The
 # platform Makefile is free to override this value.
 SEPARATE_CODE_AND_RODATA	:= 0
@@ -320,6 +350,11 @@ ERRATA_SPECULATIVE_AT		:= 0
 # Trap RAS error record access from Non secure
 RAS_TRAP_NS_ERR_REC_ACCESS	:= 0
 
+# Largest contiguous block, in MB, described by a single GPT L1 descriptor.
+# Can be 0 (contiguous descriptors disabled), 2, 32 or 512. Platforms opt into
+# larger blocks.
+RME_GPT_MAX_BLOCK		:= 2
+
 # Build option to create cot descriptors using fconf
 COT_DESC_IN_DTB			:= 0
 
@@ -9,8 +9,10 @@
 #include <common/debug.h>
 #include <common/desc_image_load.h>
 #include <drivers/arm/sp804_delay_timer.h>
+#include <drivers/auth/auth_mod.h>
 #include <lib/fconf/fconf.h>
 #include <lib/fconf/fconf_dyn_cfg_getter.h>
+#include <lib/transfer_list.h>
 
 #include <plat/arm/common/plat_arm.h>
 #include <plat/common/platform.h>
@@ -22,6 +24,13 @@ void bl2_early_platform_setup2(u_register_t arg0, u_register_t arg1, u_register_
 {
 	arm_bl2_early_platform_setup((uintptr_t)arg0, (meminfo_t *)arg1);
 
+#if AUTH_VERIFIED_CACHE && !RESET_TO_BL2
+	/* BL1 passes the certificates it verified in arg3 */
+	if (auth_mod_cache_init((struct transfer_list_header *)arg3) != 0) {
+		WARN("BL2: verified certificate cache not available\n");
+	}
+#endif
+
 	/* Initialize the platform config for future decision making */
 	fvp_config_setup();
 }
@@ -58,18 +58,21 @@
 					 TC_NS_DRAM1_SIZE - 1)
 
 /*
- * Mappings for TC DRAM1 (non-secure) and TC TZC DRAM1 (secure)
+ * Mappings for TC DRAM1 (non-secure) and TC TZC DRAM1 (secure), whose
+ * attributes are never changed, with the Contiguous hint.
  */
 #define TC_MAP_NS_DRAM1		MAP_REGION_FLAT(		\
 						TC_NS_DRAM1_BASE,	\
 						TC_NS_DRAM1_SIZE,	\
-						MT_MEMORY | MT_RW | MT_NS)
+						MT_MEMORY | MT_RW | MT_NS | \
+						MT_CONTIG)
 
 
 #define TC_MAP_TZC_DRAM1		MAP_REGION_FLAT(		\
 						TC_TZC_DRAM1_BASE,	\
 						TC_TZC_DRAM1_SIZE,	\
-						MT_MEMORY | MT_RW | MT_SECURE)
+						MT_MEMORY | MT_RW | MT_SECURE | \
+						MT_CONTIG)
 
 #define PLAT_HW_CONFIG_DTB_BASE	ULL(0x83000000)
 #define PLAT_HW_CONFIG_DTB_SIZE	ULL(0x8000)
@@ -9,11 +9,14 @@
 #include <platform_def.h>
 
 #include <arch.h>
+#include <arch_helpers.h>
 #include <bl1/bl1.h>
 #include <common/bl_common.h>
 #include <common/debug.h>
+#include <drivers/auth/auth_mod.h>
 #include <lib/fconf/fconf.h>
 #include <lib/fconf/fconf_dyn_cfg_getter.h>
+#include <lib/transfer_list.h>
 #include <lib/utils.h>
 #include <lib/xlat_tables/xlat_tables_compat.h>
 #include <plat/arm/common/plat_arm.h>
@@ -61,6 +64,13 @@ static meminfo_t bl1_tzram_layout;
 /* Boolean variable to hold condition whether firmware update needed or not */
 static bool is_fwu_needed;
 
+#if AUTH_VERIFIED_CACHE
+/* Transfer list holding the certificates verified by BL1, passed to BL2 */
+static uint8_t arm_auth_cache[ARM_AUTH_CACHE_SIZE]
+	__aligned(TRANSFER_LIST_GRANULE);
+static struct transfer_list_header *arm_auth_cache_tl;
+#endif
+
 struct meminfo *bl1_plat_sec_mem_layout(void)
 {
 	return &bl1_tzram_layout;
@@ -165,6 +175,19 @@ void arm_bl1_platform_setup(void)
 		return;
 	}
 
+#if AUTH_VERIFIED_CACHE
+	/*
+	 * Cache the certificates verified from now on, starting with the ones
+	 * of the configuration images, so that BL2 does not verify them again.
+	 */
+	arm_auth_cache_tl = transfer_list_init(arm_auth_cache,
+					       sizeof(arm_auth_cache));
+	if (auth_mod_cache_init(arm_auth_cache_tl) != 0) {
+		WARN("BL1: unable to set up the verified certificate cache\n");
+		arm_auth_cache_tl = NULL;
+	}
+#endif
+
 	/* Set global DTB info for fixed fw_config information */
 	fw_config_max_size = ARM_FW_CONFIG_LIMIT - ARM_FW_CONFIG_BASE;
 	set_config_info(ARM_FW_CONFIG_BASE, ~0UL, fw_config_max_size, FW_CONFIG_ID);
@@ -203,6 +226,11 @@ void arm_bl1_platform_setup(void)
 	assert(desc != NULL);
 	desc->ep_info.args.arg0 = fw_config_info->config_addr;
 
+#if AUTH_VERIFIED_CACHE
+	/* The BL2 ep_info arg3 points to the verified certificate cache */
+	desc->ep_info.args.arg3 = (uintptr_t)arm_auth_cache_tl;
+#endif
+
 #if CRYPTO_SUPPORT
 	/* Share the Mbed TLS heap info with other images */
 	arm_bl1_set_mbedtls_heap();
@@ -227,6 +255,14 @@ void bl1_plat_prepare_exit(entry_point_info_t *ep_info)
 	plat_arm_secure_wdt_stop();
 #endif
 
+#if AUTH_VERIFIED_CACHE
+	/* Make the verified certificate cache visible to BL2 */
+	if (arm_auth_cache_tl != NULL) {
+		flush_dcache_range((uintptr_t)arm_auth_cache_tl,
+				   arm_auth_cache_tl->size);
+	}
+#endif
+
 #ifdef EL3_PAYLOAD_BASE
 	/*
 	 * Program the EL3 payload's entry point address into the CPUs mailbox
@@ -14,6 +14,7 @@
 #include <common/bl_common.h>
 #include <common/debug.h>
 #include <common/desc_image_load.h>
+#include <drivers/auth/auth_mod.h>
 #include <drivers/generic_delay_timer.h>
 #include <drivers/partition/partition.h>
 #include <lib/fconf/fconf.h>
@@ -22,6 +23,7 @@
 #ifdef SPD_opteed
 #include <lib/optee_utils.h>
 #endif
+#include <lib/transfer_list.h>
 #include <lib/utils.h>
 #if ENABLE_RME
 #include <plat/arm/common/arm_pas_def.h>
@@ -91,6 +93,13 @@ void bl2_early_platform_setup2(u_register_t arg0, u_register_t arg1, u_register_
 {
 	arm_bl2_early_platform_setup((uintptr_t)arg0, (meminfo_t *)arg1);
 
+#if AUTH_VERIFIED_CACHE && !RESET_TO_BL2
+	/* BL1 passes the certificates it verified in arg3 */
+	if (auth_mod_cache_init((struct transfer_list_header *)arg3) != 0) {
+		WARN("BL2: verified certificate cache not available\n");
+	}
+#endif
+
 	generic_delay_timer_init();
 }
 
@@ -199,6 +199,7 @@ endif
 ifeq (${ARM_ARCH_MAJOR},8)
     ifeq (${ARM_ARCH_MINOR},0)
         BL2_CPPFLAGS += -march=armv8-a+crc
+        ENABLE_FEAT_CRC32 := 1
     endif
 endif
 
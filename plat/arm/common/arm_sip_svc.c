@@ -113,6 +113,26 @@ static uintptr_t arm_sip_handler(unsigned int smc_fid,
 #endif /* __aarch64__ */
 		}
 
+#if CONSOLE_DEFERRED_LOG
+	case ARM_SIP_SVC_CONSOLE_LOG_READ: {
+		/*
+		 * Return the number of characters read in x0 and the
+		 * characters, in order, in the bytes of x1-x7.
+		 */
+		u_register_t buf[7] = { 0 };
+		size_t len;
+
+		/* Allow calls from non-secure only */
+		if (!is_caller_non_secure(flags))
+			SMC_RET1(handle, SMC_UNK);
+
+		len = console_log_read((char *)buf, sizeof(buf));
+
+		SMC_RET8(handle, len, buf[0], buf[1], buf[2], buf[3], buf[4],
+			 buf[5], buf[6]);
+		}
+#endif /* CONSOLE_DEFERRED_LOG */
+
 	case ARM_SIP_SVC_CALL_COUNT:
 		/* PMF calls */
 		call_count += PMF_NUM_SMC_CALLS;
@@ -122,6 +142,11 @@ static uintptr_t arm_sip_handler(unsigned int smc_fid,
 		call_count += ETHOSN_NUM_SMC_CALLS;
 #endif          /* ETHOSN_NPU_DRIVER */
 
+#if CONSOLE_DEFERRED_LOG
+		/* Console log read call */
+		call_count += 1;
+#endif
+
 		/* State switch call */
 		call_count += 1;
 
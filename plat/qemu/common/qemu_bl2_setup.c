@@ -101,6 +101,14 @@ static void update_dt(void)
 		return;
 	}
 
+#if EL3_TRACE
+	if (fdt_add_reserved_memory(fdt, "el3-trace", PLAT_EL3_TRACE_BASE,
+				    PLAT_EL3_TRACE_SIZE)) {
+		ERROR("Failed to reserve EL3 trace buffer in Device Tree\n");
+		return;
+	}
+#endif
+
 	ret = fdt_pack(fdt);
 	if (ret < 0)
 		ERROR("Failed to pack Device Tree at %p: error %d\n", fdt, ret);
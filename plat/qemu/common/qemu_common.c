@@ -51,6 +51,11 @@
 #define MAP_FW_HANDOFF MAP_REGION_FLAT(FW_HANDOFF_BASE, FW_HANDOFF_SIZE, \
 				       MT_MEMORY | MT_RW | MT_SECURE)
 #endif
+#ifdef PLAT_EL3_TRACE_BASE
+#define MAP_EL3_TRACE	MAP_REGION_FLAT(PLAT_EL3_TRACE_BASE,		\
+					PLAT_EL3_TRACE_SIZE,		\
+					MT_MEMORY | MT_RW | MT_NS)
+#endif
 #ifdef FW_NS_HANDOFF_BASE
 #define MAP_FW_NS_HANDOFF MAP_REGION_FLAT(FW_NS_HANDOFF_BASE, FW_HANDOFF_SIZE, \
 					  MT_MEMORY | MT_RW | MT_NS)
@@ -115,6 +120,9 @@ static const mmap_region_t plat_qemu_mmap[] = {
 #ifdef MAP_FW_NS_HANDOFF
 	MAP_FW_NS_HANDOFF,
 #endif
+#ifdef MAP_EL3_TRACE
+	MAP_EL3_TRACE,
+#endif
 #if SPM_MM
 	MAP_NS_DRAM0,
 	QEMU_SPM_BUF_EL3_MMAP,
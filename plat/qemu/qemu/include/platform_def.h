@@ -197,10 +197,23 @@
 #define NS_IMAGE_OFFSET			(NS_DRAM0_BASE + 0x20000000)
 #define NS_IMAGE_MAX_SIZE		(NS_DRAM0_SIZE - 0x20000000)
 
+#if EL3_TRACE
+/* Non-secure buffer holding the EL3 trace rings, reserved in the DT by BL2 */
+#define PLAT_EL3_TRACE_BASE		(NS_IMAGE_OFFSET - 0x200000)
+#define PLAT_EL3_TRACE_SIZE		0x100000
+#define MAX_MMAP_REGIONS_EL3_TRACE	1
+#define MAX_XLAT_TABLES_EL3_TRACE	1
+#else
+#define MAX_MMAP_REGIONS_EL3_TRACE	0
+#define MAX_XLAT_TABLES_EL3_TRACE	0
+#endif
+
 #define PLAT_PHY_ADDR_SPACE_SIZE	(1ULL << 32)
 #define PLAT_VIRT_ADDR_SPACE_SIZE	(1ULL << 32)
-#define MAX_MMAP_REGIONS		(11 + MAX_MMAP_REGIONS_SPMC)
-#define MAX_XLAT_TABLES			(6 + MAX_XLAT_TABLES_SPMC)
+#define MAX_MMAP_REGIONS		(11 + MAX_MMAP_REGIONS_SPMC + \
+					 MAX_MMAP_REGIONS_EL3_TRACE)
+#define MAX_XLAT_TABLES			(6 + MAX_XLAT_TABLES_SPMC + \
+					 MAX_XLAT_TABLES_EL3_TRACE)
 #define MAX_IO_DEVICES			4
 #define MAX_IO_HANDLES			4
 
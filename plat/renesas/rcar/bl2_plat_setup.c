@@ -414,6 +414,9 @@ static uint32_t is_ddr_backup_mode(void)
 void bl2_plat_preload_setup(void)
 {
 	image_decompress_init(BL33_COMP_BASE, BL33_COMP_SIZE, gunzip);
+#if IMAGE_DECOMPRESS_STREAM
+	image_decompress_init_stream(&gunzip_stream);
+#endif
 }
 #endif
 
@@ -116,12 +116,22 @@ $(ROTPK_HASH): $(ROT_KEY)
 
 endif
 
+# The images loaded by BL2 can be compressed with gzip, lz4 or zstd. BL2
+# detects the format of each image, so the filter of each image can also be
+# selected individually, e.g. BL33_PRE_TOOL_FILTER=LZ4.
+ifneq ($(filter 1,${FIP_GZIP} ${FIP_LZ4} ${FIP_ZSTD}),)
+
+BL2_SOURCES		+=	common/image_decompress.c
+
+$(eval $(call add_define,UNIPHIER_DECOMPRESS))
+
+endif
+
 ifeq (${FIP_GZIP},1)
 
 include lib/zlib/zlib.mk
 
-BL2_SOURCES		+=	common/image_decompress.c		\
-				$(ZLIB_SOURCES)
+BL2_SOURCES		+=	$(ZLIB_SOURCES)
 
 $(eval $(call add_define,UNIPHIER_DECOMPRESS_GZIP))
 
@@ -133,6 +143,38 @@ BL33_PRE_TOOL_FILTER	:= GZIP
 
 endif
 
+ifeq (${FIP_LZ4},1)
+
+include lib/lz4/lz4.mk
+
+BL2_SOURCES		+=	$(LZ4_SOURCES)
+
+$(eval $(call add_define,UNIPHIER_DECOMPRESS_LZ4))
+
+# compress all images loaded by BL2
+SCP_BL2_PRE_TOOL_FILTER	:= LZ4
+BL31_PRE_TOOL_FILTER	:= LZ4
+BL32_PRE_TOOL_FILTER	:= LZ4
+BL33_PRE_TOOL_FILTER	:= LZ4
+
+endif
+
+ifeq (${FIP_ZSTD},1)
+
+include lib/zstd/zstd.mk
+
+BL2_SOURCES		+=	$(ZSTD_SOURCES)
+
+$(eval $(call add_define,UNIPHIER_DECOMPRESS_ZSTD))
+
+# compress all images loaded by BL2
+SCP_BL2_PRE_TOOL_FILTER	:= ZSTD
+BL31_PRE_TOOL_FILTER	:= ZSTD
+BL32_PRE_TOOL_FILTER	:= ZSTD
+BL33_PRE_TOOL_FILTER	:= ZSTD
+
+endif
+
 .PHONY: bl2_gzip
 bl2_gzip: $(BUILD_PLAT)/bl2.bin.gz
 %.gz: %
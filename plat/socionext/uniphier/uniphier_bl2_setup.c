@@ -18,6 +18,12 @@
 #ifdef UNIPHIER_DECOMPRESS_GZIP
 #include <tf_gunzip.h>
 #endif
+#ifdef UNIPHIER_DECOMPRESS_LZ4
+#include <tf_unlz4.h>
+#endif
+#ifdef UNIPHIER_DECOMPRESS_ZSTD
+#include <tf_unzstd.h>
+#endif
 
 #include "uniphier.h"
 
@@ -28,6 +34,22 @@ static uintptr_t uniphier_mem_base = UNIPHIER_MEM_BASE;
 static unsigned int uniphier_soc = UNIPHIER_SOC_UNKNOWN;
 static int uniphier_bl2_kick_scp;
 
+#ifdef UNIPHIER_DECOMPRESS
+/* The decompressor of each image is selected by its magic number */
+static const image_decompressor_t *const uniphier_decompressors[] = {
+#ifdef UNIPHIER_DECOMPRESS_GZIP
+	&gunzip_decompressor,
+#endif
+#ifdef UNIPHIER_DECOMPRESS_LZ4
+	&unlz4_decompressor,
+	&unlz4_legacy_decompressor,
+#endif
+#ifdef UNIPHIER_DECOMPRESS_ZSTD
+	&unzstd_decompressor,
+#endif
+};
+#endif
+
 void bl2_el3_early_platform_setup(u_register_t x0, u_register_t x1,
 				  u_register_t x2, u_register_t x3)
 {
@@ -110,7 +132,7 @@ bl_params_t *plat_get_next_bl_params(void)
 
 void bl2_plat_preload_setup(void)
 {
-#ifdef UNIPHIER_DECOMPRESS_GZIP
+#ifdef UNIPHIER_DECOMPRESS
 	uintptr_t buf_base = uniphier_mem_base + UNIPHIER_IMAGE_BUF_OFFSET;
 	int ret;
 
@@ -120,7 +142,12 @@ void bl2_plat_preload_setup(void)
 	if (ret)
 		plat_error_handler(ret);
 
-	image_decompress_init(buf_base, UNIPHIER_IMAGE_BUF_SIZE, gunzip);
+	image_decompress_init_multi(buf_base, UNIPHIER_IMAGE_BUF_SIZE,
+				    uniphier_decompressors,
+				    ARRAY_SIZE(uniphier_decompressors));
+#if defined(UNIPHIER_DECOMPRESS_GZIP) && IMAGE_DECOMPRESS_STREAM
+	image_decompress_init_stream(&gunzip_stream);
+#endif
 #endif
 
 	uniphier_init_image_descs(uniphier_mem_base);
@@ -140,7 +167,7 @@ int bl2_plat_handle_pre_image_load(unsigned int image_id)
 	if (ret)
 		return ret;
 
-#ifdef UNIPHIER_DECOMPRESS_GZIP
+#ifdef UNIPHIER_DECOMPRESS
 	image_decompress_prepare(image_info);
 #endif
 	return 0;
@@ -149,7 +176,7 @@ int bl2_plat_handle_pre_image_load(unsigned int image_id)
 int bl2_plat_handle_post_image_load(unsigned int image_id)
 {
 	struct image_info *image_info = uniphier_get_image_info(image_id);
-#ifdef UNIPHIER_DECOMPRESS_GZIP
+#ifdef UNIPHIER_DECOMPRESS
 	int ret;
 
 	if (!(image_info->h.attr & IMAGE_ATTRIB_SKIP_LOADING)) {
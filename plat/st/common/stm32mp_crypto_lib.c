@@ -656,18 +656,15 @@ static int crypto_auth_decrypt(enum crypto_dec_algo dec_algo, void *data_ptr, si
 
 REGISTER_CRYPTO_LIB("stm32_crypto_lib",
 		    crypto_lib_init,
-		    crypto_verify_signature,
-		    crypto_verify_hash,
-		    NULL,
-		    crypto_auth_decrypt,
-		    crypto_convert_pk);
+		    .verify_signature = crypto_verify_signature,
+		    .verify_hash = crypto_verify_hash,
+		    .auth_decrypt = crypto_auth_decrypt,
+		    .convert_pk = crypto_convert_pk);
 
 #else /* No decryption support */
 REGISTER_CRYPTO_LIB("stm32_crypto_lib",
 		    crypto_lib_init,
-		    crypto_verify_signature,
-		    crypto_verify_hash,
-		    NULL,
-		    NULL,
-		    crypto_convert_pk);
+		    .verify_signature = crypto_verify_signature,
+		    .verify_hash = crypto_verify_hash,
+		    .convert_pk = crypto_convert_pk);
 #endif
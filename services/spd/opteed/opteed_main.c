@@ -163,6 +163,12 @@ static int32_t opteed_setup(void)
 				dt_addr,
 				&opteed_sp_context[linear_id]);
 
+	/*
+	 * OP-TEE runs Trusted Applications at S-EL0, possibly in AArch32
+	 * state, and may use MTE, so it keeps switching the complete EL1
+	 * system register context (no cm_set_el1_sysregs_groups()).
+	 */
+
 	/*
 	 * All OPTEED initialization done. Now register our init function with
 	 * BL31 for deferred invocation
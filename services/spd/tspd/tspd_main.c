@@ -282,6 +282,15 @@ static int32_t tspd_setup(void)
 				tsp_ep_info->pc,
 				&tspd_sp_context[linear_id]);
 
+	/*
+	 * The TSP runs at S-EL1 without any S-EL0 software, AArch32 state or
+	 * use of MTE. Only switch the EL1 system registers it relies on when
+	 * entering and exiting it.
+	 */
+	cm_set_el1_sysregs_groups(SECURE, CTX_EL1_REGS_EXCEPTION |
+				  CTX_EL1_REGS_MMU | CTX_EL1_REGS_SYSTEM |
+				  CTX_EL1_REGS_TIMER);
+
 #if TSP_INIT_ASYNC
 	bl31_set_next_image_type(SECURE);
 #else
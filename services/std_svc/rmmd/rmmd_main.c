@@ -423,6 +423,17 @@ static int gpt_to_gts_error(int error, uint32_t smc_fid, uint64_t address)
 	return ret;
 }
 
+/*
+ * Number of granules transitioned by an RMM_GTSI_*_RANGE call for the count
+ * requested by the RMM. Larger ranges are split so that EL3 is never held for
+ * longer than RMM_GTSI_RANGE_MAX_GRANULES transitions, the RMM issues further
+ * calls for the rest of the range.
+ */
+static uint64_t gts_range_granules(uint64_t granule_count)
+{
+	return MIN(granule_count, (uint64_t)RMM_GTSI_RANGE_MAX_GRANULES);
+}
+
 /*******************************************************************************
  * This function handles RMM-EL3 interface SMCs
  ******************************************************************************/
@@ -431,6 +442,7 @@ uint64_t rmmd_rmm_el3_handler(uint32_t smc_fid, uint64_t x1, uint64_t x2,
 				void *handle, uint64_t flags)
 {
 	uint32_t src_sec_state;
+	uint64_t count;
 	int ret;
 
 	/* If RMM failed to boot, treat any RMM-EL3 interface SMC as unknown */
@@ -454,6 +466,22 @@ uint64_t rmmd_rmm_el3_handler(uint32_t smc_fid, uint64_t x1, uint64_t x2,
 	case RMM_GTSI_UNDELEGATE:
 		ret = gpt_undelegate_pas(x1, PAGE_SIZE_4KB, SMC_FROM_REALM);
 		SMC_RET1(handle, gpt_to_gts_error(ret, smc_fid, x1));
+	case RMM_GTSI_DELEGATE_RANGE:
+		if (x2 == 0UL) {
+			SMC_RET2(handle, E_RMM_INVAL, 0UL);
+		}
+		count = gts_range_granules(x2);
+		ret = gpt_delegate_pas(x1, count * PAGE_SIZE_4KB, SMC_FROM_REALM);
+		SMC_RET2(handle, gpt_to_gts_error(ret, smc_fid, x1),
+			 (ret == 0) ? count : 0UL);
+	case RMM_GTSI_UNDELEGATE_RANGE:
+		if (x2 == 0UL) {
+			SMC_RET2(handle, E_RMM_INVAL, 0UL);
+		}
+		count = gts_range_granules(x2);
+		ret = gpt_undelegate_pas(x1, count * PAGE_SIZE_4KB, SMC_FROM_REALM);
+		SMC_RET2(handle, gpt_to_gts_error(ret, smc_fid, x1),
+			 (ret == 0) ? count : 0UL);
 	case RMM_ATTEST_GET_PLAT_TOKEN:
 		ret = rmmd_attest_get_platform_token(x1, &x2, x3);
 		SMC_RET2(handle, ret, x2);
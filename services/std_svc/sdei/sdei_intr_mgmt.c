@@ -17,6 +17,7 @@
 #include <common/debug.h>
 #include <common/runtime_svc.h>
 #include <lib/cassert.h>
+#include <lib/el3_trace.h>
 #include <services/sdei.h>
 
 #include "sdei_private.h"
@@ -333,6 +334,9 @@ static void setup_ns_dispatch(sdei_ev_map_t *map, sdei_entry_t *se,
 	/* Setup the elr and spsr register to prepare for ERET */
 	sdei_set_elr_spsr(se, disp_ctx);
 
+	EL3_TRACE_EVENT(EL3_TRACE_SDEI_DISPATCH, map->ev_num,
+			disp_ctx->elr_el3);
+
 #if DYNAMIC_WORKAROUND_CVE_2018_3639
 	cve_2018_3639_t *tgt_cve_2018_3639;
 	tgt_cve_2018_3639 = get_cve_2018_3639_ctx(ctx);
@@ -705,6 +709,8 @@ int sdei_event_complete(bool resume, uint64_t pc)
 	/* Having done sanity checks, pop dispatch */
 	(void) pop_dispatch();
 
+	EL3_TRACE_EVENT(EL3_TRACE_SDEI_COMPLETE, map->ev_num, resume);
+
 	SDEI_LOG("EOI:%lx, %d spsr:%lx elr:%lx\n", read_mpidr_el1(),
 			map->ev_num, read_spsr_el3(), read_elr_el3());
 
@@ -809,6 +809,9 @@ static uint64_t rxtx_unmap_handler(uint32_t smc_fid,
 					     FFA_ERROR_INVALID_PARAMETER);
 	}
 
+	/* Invalidate the TLB entries of both buffers together. */
+	xlat_begin_batch();
+
 	/* Unmap RX Buffer */
 	if (mmap_remove_dynamic_region((uintptr_t) mbox->rx_buffer,
 				       buf_size) != 0) {
@@ -823,6 +826,8 @@ static uint64_t rxtx_unmap_handler(uint32_t smc_fid,
 		WARN("Unable to unmap TX buffer!\n");
 	}
 
+	xlat_commit_batch();
+
 	mbox->tx_buffer = 0;
 	mbox->rxtx_page_count = 0;
 
@@ -9,6 +9,7 @@
 
 #include <common/debug.h>
 #include <common/runtime_svc.h>
+#include <lib/cassert.h>
 #include <lib/object_pool.h>
 #include <lib/spinlock.h>
 #include <lib/xlat_tables/xlat_tables_v2.h>
@@ -46,6 +47,189 @@ struct spmc_shmem_obj_state spmc_shmem_obj_state = {
 	.next_handle = 0xffffffc0U,
 };
 
+/*
+ * Number of entries in the handle index. This bounds the number of objects
+ * that can be found without walking the datastore, it must be a power of 2.
+ */
+#ifndef PLAT_SPMC_SHMEM_INDEX_SIZE
+#define PLAT_SPMC_SHMEM_INDEX_SIZE	U(128)
+#endif
+CASSERT(IS_POWER_OF_TWO(PLAT_SPMC_SHMEM_INDEX_SIZE),
+	assert_spmc_shmem_index_size_power_of_two);
+
+/**
+ * struct spmc_shmem_index_entry - Handle index entry.
+ * @handle:     Handle of the indexed object.
+ * @offset:     Offset of the object in spmc_shmem_obj_state.data.
+ * @used:       Set if the entry holds a valid mapping.
+ */
+struct spmc_shmem_index_entry {
+	uint64_t handle;
+	size_t offset;
+	bool used;
+};
+
+/**
+ * struct spmc_shmem_index - Index of shared memory objects by handle.
+ * @entries:    Open addressed hash table, probed linearly from the low bits
+ *              of the handle. Handles are allocated sequentially so they
+ *              spread evenly over the table.
+ * @count:      Number of used entries.
+ * @overflow:   Set if an object could not be indexed because the table was
+ *              full. Lookups that miss the index then fall back to walking
+ *              the datastore, until the datastore is empty again.
+ *
+ * The index is protected by spmc_shmem_obj_state.lock.
+ */
+struct spmc_shmem_index {
+	struct spmc_shmem_index_entry entries[PLAT_SPMC_SHMEM_INDEX_SIZE];
+	unsigned int count;
+	bool overflow;
+};
+
+static struct spmc_shmem_index spmc_shmem_index;
+
+static unsigned int spmc_shmem_index_slot(uint64_t handle)
+{
+	return (unsigned int)handle & (PLAT_SPMC_SHMEM_INDEX_SIZE - 1U);
+}
+
+static unsigned int spmc_shmem_index_next(unsigned int slot)
+{
+	return (slot + 1U) & (PLAT_SPMC_SHMEM_INDEX_SIZE - 1U);
+}
+
+/**
+ * spmc_shmem_index_find - Find the index entry of a handle.
+ * @handle:     Handle to look for.
+ *
+ * Return: Pointer to the index entry for @handle, %NULL if not indexed.
+ */
+static struct spmc_shmem_index_entry *spmc_shmem_index_find(uint64_t handle)
+{
+	struct spmc_shmem_index_entry *entry;
+	unsigned int slot = spmc_shmem_index_slot(handle);
+	unsigned int i;
+
+	for (i = 0U; i < PLAT_SPMC_SHMEM_INDEX_SIZE; i++) {
+		entry = &spmc_shmem_index.entries[slot];
+		if (!entry->used) {
+			return NULL;
+		}
+		if (entry->handle == handle) {
+			return entry;
+		}
+		slot = spmc_shmem_index_next(slot);
+	}
+	return NULL;
+}
+
+/**
+ * spmc_shmem_index_add - Index an object by its handle.
+ * @state:      Global state.
+ * @obj:        Object to index, its handle must already be set.
+ *
+ * If @obj's handle is already indexed, the entry is updated to point to @obj.
+ * This is used when an object is replaced by a converted copy.
+ */
+static void spmc_shmem_index_add(struct spmc_shmem_obj_state *state,
+				 struct spmc_shmem_obj *obj)
+{
+	struct spmc_shmem_index_entry *entry;
+	size_t offset = (uint8_t *)obj - state->data;
+	unsigned int slot;
+
+	entry = spmc_shmem_index_find(obj->desc.handle);
+	if (entry != NULL) {
+		entry->offset = offset;
+		return;
+	}
+
+	/* Keep one entry free so that probing always terminates. */
+	if (spmc_shmem_index.count >= (PLAT_SPMC_SHMEM_INDEX_SIZE - 1U)) {
+		spmc_shmem_index.overflow = true;
+		return;
+	}
+
+	slot = spmc_shmem_index_slot(obj->desc.handle);
+	while (spmc_shmem_index.entries[slot].used) {
+		slot = spmc_shmem_index_next(slot);
+	}
+
+	entry = &spmc_shmem_index.entries[slot];
+	entry->handle = obj->desc.handle;
+	entry->offset = offset;
+	entry->used = true;
+	spmc_shmem_index.count++;
+}
+
+/**
+ * spmc_shmem_index_remove - Remove an entry from the index.
+ * @entry:      Entry to remove.
+ *
+ * Use backward shift deletion, so that the probe sequence of the remaining
+ * entries stays intact without the need for tombstones.
+ */
+static void spmc_shmem_index_remove(struct spmc_shmem_index_entry *entry)
+{
+	struct spmc_shmem_index_entry *entries = spmc_shmem_index.entries;
+	unsigned int hole = entry - entries;
+	unsigned int slot = hole;
+	unsigned int home;
+
+	for (;;) {
+		slot = spmc_shmem_index_next(slot);
+		if (!entries[slot].used) {
+			break;
+		}
+
+		/*
+		 * The entry can fill the hole if its home slot is not
+		 * cyclically between the hole and its current slot.
+		 */
+		home = spmc_shmem_index_slot(entries[slot].handle);
+		if (((slot - home) & (PLAT_SPMC_SHMEM_INDEX_SIZE - 1U)) >=
+		    ((slot - hole) & (PLAT_SPMC_SHMEM_INDEX_SIZE - 1U))) {
+			entries[hole] = entries[slot];
+			hole = slot;
+		}
+	}
+
+	entries[hole].used = false;
+	spmc_shmem_index.count--;
+}
+
+/**
+ * spmc_shmem_index_obj_free - Update the index for an object being freed.
+ * @state:      Global state.
+ * @obj:        Object being freed.
+ * @free_size:  Size of @obj in the datastore.
+ *
+ * Must be called before @obj is released. Removes @obj from the index and
+ * moves the entries of the objects that follow it, to match the compaction
+ * done by spmc_shmem_obj_free().
+ */
+static void spmc_shmem_index_obj_free(struct spmc_shmem_obj_state *state,
+				      struct spmc_shmem_obj *obj,
+				      size_t free_size)
+{
+	struct spmc_shmem_index_entry *entry;
+	size_t offset = (uint8_t *)obj - state->data;
+	unsigned int i;
+
+	entry = spmc_shmem_index_find(obj->desc.handle);
+	if ((entry != NULL) && (entry->offset == offset)) {
+		spmc_shmem_index_remove(entry);
+	}
+
+	for (i = 0U; i < PLAT_SPMC_SHMEM_INDEX_SIZE; i++) {
+		entry = &spmc_shmem_index.entries[i];
+		if (entry->used && (entry->offset > offset)) {
+			entry->offset -= free_size;
+		}
+	}
+}
+
 /**
  * spmc_shmem_obj_size - Convert from descriptor size to object size.
  * @desc_size:  Size of struct ffa_memory_region_descriptor object.
@@ -131,10 +315,18 @@ static void spmc_shmem_obj_free(struct spmc_shmem_obj_state *state,
 	uint8_t *shift_src = shift_dest + free_size;
 	size_t shift_size = state->allocated - (shift_src - state->data);
 
+	spmc_shmem_index_obj_free(state, obj, free_size);
+
 	if (shift_size != 0U) {
 		memmove(shift_dest, shift_src, shift_size);
 	}
 	state->allocated -= free_size;
+
+	if (state->allocated == 0U) {
+		/* All objects are gone, so is anything left out of the index. */
+		assert(spmc_shmem_index.count == 0U);
+		spmc_shmem_index.overflow = false;
+	}
 }
 
 /**
@@ -142,14 +334,32 @@ static void spmc_shmem_obj_free(struct spmc_shmem_obj_state *state,
  * @state:      Global state.
  * @handle:     Unique handle of object to return.
  *
+ * The handle index is searched first. The datastore is only walked if the
+ * index has overflowed and so may not hold every object.
+ *
  * Return: struct spmc_shmem_obj_state object with handle matching @handle.
  *         %NULL, if not object in @state->data has a matching handle.
  */
 static struct spmc_shmem_obj *
 spmc_shmem_obj_lookup(struct spmc_shmem_obj_state *state, uint64_t handle)
 {
+	struct spmc_shmem_index_entry *entry;
 	uint8_t *curr = state->data;
 
+	entry = spmc_shmem_index_find(handle);
+	if (entry != NULL) {
+		struct spmc_shmem_obj *obj;
+
+		assert(entry->offset < state->allocated);
+		obj = (struct spmc_shmem_obj *)(state->data + entry->offset);
+		assert(obj->desc.handle == handle);
+		return obj;
+	}
+
+	if (!spmc_shmem_index.overflow) {
+		return NULL;
+	}
+
 	while (curr - state->data < state->allocated) {
 		struct spmc_shmem_obj *obj = (struct spmc_shmem_obj *)curr;
 
@@ -1070,6 +1280,7 @@ static long spmc_ffa_fill_desc(struct mailbox *mbox,
 
 		obj->desc.handle = spmc_shmem_obj_state.next_handle++;
 		obj->desc.flags |= mtd_flag;
+		spmc_shmem_index_add(&spmc_shmem_obj_state, obj);
 	}
 
 	obj->desc_filled += fragment_length;
@@ -1136,6 +1347,7 @@ static long spmc_ffa_fill_desc(struct mailbox *mbox,
 		 * We're finished with the v1.0 descriptor so free it
 		 * and continue our checks with the new v1.1 descriptor.
 		 */
+		spmc_shmem_index_add(&spmc_shmem_obj_state, v1_1_obj);
 		mem_handle = obj->desc.handle;
 		spmc_shmem_obj_free(&spmc_shmem_obj_state, obj);
 		obj = spmc_shmem_obj_lookup(&spmc_shmem_obj_state, mem_handle);
@@ -18,6 +18,7 @@
 #include <common/runtime_svc.h>
 #include <common/tbbr/tbbr_img_def.h>
 #include <lib/el3_runtime/context_mgmt.h>
+#include <lib/el3_trace.h>
 #include <lib/fconf/fconf.h>
 #include <lib/fconf/fconf_dyn_cfg_getter.h>
 #include <lib/smccc.h>
@@ -553,6 +554,12 @@ static int spmd_spmc_init(void *pm_addr)
 		write_ctx_reg(get_gpregs_ctx(cpu_ctx), CTX_GPREG_X4, core_id);
 	}
 
+	/*
+	 * The Secure EL1 registers belong to the SPMC or, with an S-EL2 SPMC,
+	 * to the partitions it runs, whose usage is not known here. Keep
+	 * switching all of them (no cm_set_el1_sysregs_groups()).
+	 */
+
 	/* Register power management hooks with PSCI */
 	psci_register_spd_pm_hook(&spmd_pm);
 
@@ -666,6 +673,8 @@ uint64_t spmd_smc_switch_state(uint32_t smc_fid,
 	unsigned int secure_state_in = (secure_origin) ? SECURE : NON_SECURE;
 	unsigned int secure_state_out = (!secure_origin) ? SECURE : NON_SECURE;
 
+	EL3_TRACE_EVENT(EL3_TRACE_SPMD_SWITCH, smc_fid, secure_state_out);
+
 	/* Save incoming security state */
 #if SPMD_SPM_AT_SEL2
 	if (secure_state_in == NON_SECURE) {
@@ -793,6 +802,140 @@ static int spmd_handle_spmc_message(unsigned long long msg,
 	return -EINVAL;
 }
 
+/*******************************************************************************
+ * This function handles FFA_MSG_SEND_DIRECT_REQ calls from either security
+ * state.
+ ******************************************************************************/
+static uint64_t spmd_ffa_direct_req_handler(uint32_t smc_fid,
+					    bool secure_origin,
+					    uint64_t x1,
+					    uint64_t x2,
+					    uint64_t x3,
+					    uint64_t x4,
+					    void *cookie,
+					    void *handle,
+					    uint64_t flags)
+{
+	spmd_spm_core_context_t *ctx = spmd_get_context();
+
+	/*
+	 * Regardless of secure_origin, SPMD logical partitions cannot
+	 * handle direct messages. They can only initiate direct
+	 * messages and consume direct responses or errors.
+	 */
+	if (is_spmd_lp_id(ffa_endpoint_source(x1)) ||
+			  is_spmd_lp_id(ffa_endpoint_destination(x1))) {
+		return spmd_ffa_error_return(handle,
+					     FFA_ERROR_INVALID_PARAMETER
+					     );
+	}
+
+	/*
+	 * When there is an ongoing SPMD logical partition direct
+	 * request, there cannot be another direct request. Return
+	 * error in this case. Panic'ing is an option but that does
+	 * not provide the opportunity for caller to abort based on
+	 * error codes.
+	 */
+	if (is_spmd_logical_sp_dir_req_in_progress(ctx)) {
+		assert(secure_origin);
+		return spmd_ffa_error_return(handle,
+					     FFA_ERROR_DENIED);
+	}
+
+	if (!secure_origin) {
+		/* Validate source endpoint is non-secure for non-secure caller. */
+		if (ffa_is_secure_world_id(ffa_endpoint_source(x1))) {
+			return spmd_ffa_error_return(handle,
+					FFA_ERROR_INVALID_PARAMETER);
+		}
+	}
+	if (secure_origin && spmd_is_spmc_message(x1)) {
+		int32_t ret;
+
+		ret = spmd_handle_spmc_message(x3, x4,
+			SMC_GET_GP(handle, CTX_GPREG_X5),
+			SMC_GET_GP(handle, CTX_GPREG_X6),
+			SMC_GET_GP(handle, CTX_GPREG_X7));
+
+		SMC_RET8(handle, FFA_SUCCESS_SMC32,
+			FFA_TARGET_INFO_MBZ, ret,
+			FFA_PARAM_MBZ, FFA_PARAM_MBZ,
+			FFA_PARAM_MBZ, FFA_PARAM_MBZ,
+			FFA_PARAM_MBZ);
+	}
+
+	/* Forward direct message to the other world */
+	return spmd_smc_forward(smc_fid, secure_origin, x1, x2, x3, x4, cookie,
+				handle, flags);
+}
+
+/*******************************************************************************
+ * This function handles FFA_MSG_SEND_DIRECT_RESP calls from either security
+ * state.
+ ******************************************************************************/
+static uint64_t spmd_ffa_direct_resp_handler(uint32_t smc_fid,
+					     bool secure_origin,
+					     uint64_t x1,
+					     uint64_t x2,
+					     uint64_t x3,
+					     uint64_t x4,
+					     void *cookie,
+					     void *handle,
+					     uint64_t flags)
+{
+	spmd_spm_core_context_t *ctx = spmd_get_context();
+
+	if (secure_origin && (spmd_is_spmc_message(x1) ||
+	    is_spmd_logical_sp_dir_req_in_progress(ctx))) {
+		spmd_spm_core_sync_exit(0ULL);
+	}
+
+	/* Forward direct message to the other world */
+	return spmd_smc_forward(smc_fid, secure_origin, x1, x2, x3, x4, cookie,
+				handle, flags);
+}
+
+/*******************************************************************************
+ * This function handles FF-A direct message requests and responses only, for
+ * use on the SMC fast path. It performs the same checks as
+ * spmd_ffa_smc_handler() and spmd_smc_handler() for these function ids.
+ ******************************************************************************/
+uint64_t spmd_ffa_direct_msg_smc_handler(uint32_t smc_fid,
+					 uint64_t x1,
+					 uint64_t x2,
+					 uint64_t x3,
+					 uint64_t x4,
+					 void *cookie,
+					 void *handle,
+					 uint64_t flags)
+{
+	bool secure_origin = is_caller_secure(flags);
+
+	if (is_spmc_at_el3() && secure_origin) {
+		return spmc_smc_handler(smc_fid, secure_origin, x1, x2, x3, x4,
+					cookie, handle, flags);
+	}
+
+	if (is_spmd_logical_sp_info_regs_req_in_progress(spmd_get_context())) {
+		assert(secure_origin);
+		spmd_spm_core_sync_exit(0ULL);
+	}
+
+	if ((smc_fid == FFA_MSG_SEND_DIRECT_REQ_SMC32) ||
+	    (smc_fid == FFA_MSG_SEND_DIRECT_REQ_SMC64)) {
+		return spmd_ffa_direct_req_handler(smc_fid, secure_origin,
+						   x1, x2, x3, x4, cookie,
+						   handle, flags);
+	}
+
+	assert((smc_fid == FFA_MSG_SEND_DIRECT_RESP_SMC32) ||
+	       (smc_fid == FFA_MSG_SEND_DIRECT_RESP_SMC64));
+	return spmd_ffa_direct_resp_handler(smc_fid, secure_origin,
+					    x1, x2, x3, x4, cookie,
+					    handle, flags);
+}
+
 /*******************************************************************************
  * This function forwards FF-A SMCs to either the main SPMD handler or the
  * SPMC at EL3, depending on the origin security state, if enabled.
@@ -1071,69 +1214,15 @@ uint64_t spmd_smc_handler(uint32_t smc_fid,
 
 	case FFA_MSG_SEND_DIRECT_REQ_SMC32:
 	case FFA_MSG_SEND_DIRECT_REQ_SMC64:
-		/*
-		 * Regardless of secure_origin, SPMD logical partitions cannot
-		 * handle direct messages. They can only initiate direct
-		 * messages and consume direct responses or errors.
-		 */
-		if (is_spmd_lp_id(ffa_endpoint_source(x1)) ||
-				  is_spmd_lp_id(ffa_endpoint_destination(x1))) {
-			return spmd_ffa_error_return(handle,
-						     FFA_ERROR_INVALID_PARAMETER
-						     );
-		}
-
-		/*
-		 * When there is an ongoing SPMD logical partition direct
-		 * request, there cannot be another direct request. Return
-		 * error in this case. Panic'ing is an option but that does
-		 * not provide the opportunity for caller to abort based on
-		 * error codes.
-		 */
-		if (is_spmd_logical_sp_dir_req_in_progress(ctx)) {
-			assert(secure_origin);
-			return spmd_ffa_error_return(handle,
-						     FFA_ERROR_DENIED);
-		}
-
-		if (!secure_origin) {
-			/* Validate source endpoint is non-secure for non-secure caller. */
-			if (ffa_is_secure_world_id(ffa_endpoint_source(x1))) {
-				return spmd_ffa_error_return(handle,
-						FFA_ERROR_INVALID_PARAMETER);
-			}
-		}
-		if (secure_origin && spmd_is_spmc_message(x1)) {
-			ret = spmd_handle_spmc_message(x3, x4,
-				SMC_GET_GP(handle, CTX_GPREG_X5),
-				SMC_GET_GP(handle, CTX_GPREG_X6),
-				SMC_GET_GP(handle, CTX_GPREG_X7));
-
-			SMC_RET8(handle, FFA_SUCCESS_SMC32,
-				FFA_TARGET_INFO_MBZ, ret,
-				FFA_PARAM_MBZ, FFA_PARAM_MBZ,
-				FFA_PARAM_MBZ, FFA_PARAM_MBZ,
-				FFA_PARAM_MBZ);
-		} else {
-			/* Forward direct message to the other world */
-			return spmd_smc_forward(smc_fid, secure_origin,
-						x1, x2, x3, x4, cookie,
-						handle, flags);
-		}
-		break; /* Not reached */
+		return spmd_ffa_direct_req_handler(smc_fid, secure_origin,
+						   x1, x2, x3, x4, cookie,
+						   handle, flags);
 
 	case FFA_MSG_SEND_DIRECT_RESP_SMC32:
 	case FFA_MSG_SEND_DIRECT_RESP_SMC64:
-		if (secure_origin && (spmd_is_spmc_message(x1) ||
-		    is_spmd_logical_sp_dir_req_in_progress(ctx))) {
-			spmd_spm_core_sync_exit(0ULL);
-		} else {
-			/* Forward direct message to the other world */
-			return spmd_smc_forward(smc_fid, secure_origin,
-						x1, x2, x3, x4, cookie,
-						handle, flags);
-		}
-		break; /* Not reached */
+		return spmd_ffa_direct_resp_handler(smc_fid, secure_origin,
+						    x1, x2, x3, x4, cookie,
+						    handle, flags);
 
 	case FFA_RX_RELEASE:
 	case FFA_RXTX_MAP_SMC32:
@@ -244,3 +244,68 @@ DECLARE_RT_SVC(
 		std_svc_setup,
 		std_svc_smc_handler
 );
+
+#if SMC_FAST_PATH
+/*
+ * Fast-path handlers for the most frequent Standard Service Calls. They are
+ * called directly from the SMC entry code, bypassing std_svc_smc_handler(), so
+ * they must sanitise their arguments in the same way.
+ */
+#if !ENABLE_RUNTIME_INSTRUMENTATION
+static uintptr_t std_svc_psci_cpu_suspend_handler(uint32_t smc_fid,
+						  u_register_t x1,
+						  u_register_t x2,
+						  u_register_t x3,
+						  u_register_t x4,
+						  void *cookie,
+						  void *handle,
+						  u_register_t flags)
+{
+	SMC_RET1(handle, psci_cpu_suspend_smc_handler(smc_fid, x1, x2, x3,
+						      flags));
+}
+
+DECLARE_RT_SVC_FID(psci_cpu_suspend32, PSCI_CPU_SUSPEND_AARCH32,
+		   std_svc_psci_cpu_suspend_handler);
+DECLARE_RT_SVC_FID(psci_cpu_suspend64, PSCI_CPU_SUSPEND_AARCH64,
+		   std_svc_psci_cpu_suspend_handler);
+#endif /* !ENABLE_RUNTIME_INSTRUMENTATION */
+
+#if defined(SPD_spmd)
+static uintptr_t std_svc_ffa_direct_msg_handler(uint32_t smc_fid,
+						u_register_t x1,
+						u_register_t x2,
+						u_register_t x3,
+						u_register_t x4,
+						void *cookie,
+						void *handle,
+						u_register_t flags)
+{
+	if (((smc_fid >> FUNCID_CC_SHIFT) & FUNCID_CC_MASK) == SMC_32) {
+		/* 32-bit SMC function, clear top parameter bits */
+
+		x1 &= UINT32_MAX;
+		x2 &= UINT32_MAX;
+		x3 &= UINT32_MAX;
+		x4 &= UINT32_MAX;
+	}
+
+	return spmd_ffa_direct_msg_smc_handler(smc_fid, x1, x2, x3, x4, cookie,
+					       handle, flags);
+}
+
+DECLARE_RT_SVC_FID(ffa_direct_req32, FFA_MSG_SEND_DIRECT_REQ_SMC32,
+		   std_svc_ffa_direct_msg_handler);
+DECLARE_RT_SVC_FID(ffa_direct_req64, FFA_MSG_SEND_DIRECT_REQ_SMC64,
+		   std_svc_ffa_direct_msg_handler);
+DECLARE_RT_SVC_FID(ffa_direct_resp32, FFA_MSG_SEND_DIRECT_RESP_SMC32,
+		   std_svc_ffa_direct_msg_handler);
+DECLARE_RT_SVC_FID(ffa_direct_resp64, FFA_MSG_SEND_DIRECT_RESP_SMC64,
+		   std_svc_ffa_direct_msg_handler);
+#endif /* SPD_spmd */
+
+#if TRNG_SUPPORT
+DECLARE_RT_SVC_FID(trng_rnd32, ARM_TRNG_RND32, trng_rnd_smc_handler);
+DECLARE_RT_SVC_FID(trng_rnd64, ARM_TRNG_RND64, trng_rnd_smc_handler);
+#endif /* TRNG_SUPPORT */
+#endif /* SMC_FAST_PATH */
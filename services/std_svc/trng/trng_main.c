@@ -144,3 +144,21 @@ uintptr_t trng_smc_handler(uint32_t smc_fid, u_register_t x1, u_register_t x2,
 		break; /* unreachable */
 	}
 }
+
+/* Handler of the TRNG_RND calls only, for use on the SMC fast path */
+uintptr_t trng_rnd_smc_handler(uint32_t smc_fid, u_register_t x1,
+			       u_register_t x2, u_register_t x3,
+			       u_register_t x4, void *cookie, void *handle,
+			       u_register_t flags)
+{
+	if (!memcmp(&plat_trng_uuid, &uuid_null, sizeof(uuid_t))) {
+		SMC_RET1(handle, TRNG_E_NOT_IMPLEMENTED);
+	}
+
+	if (smc_fid == ARM_TRNG_RND64) {
+		return trng_rnd64((uint32_t)x1, handle);
+	}
+
+	assert(smc_fid == ARM_TRNG_RND32);
+	return trng_rnd32((uint32_t)x1, handle);
+}
@@ -0,0 +1,28 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef ARCH_FEATURES_H
+#define ARCH_FEATURES_H
+
+/*
+ * Host replacement of the feature detection of the firmware, used when
+ * tf_crc32() is built for the host. The tool builds each implementation
+ * separately, so the runtime detection is never used.
+ */
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <common/feat_detect.h>
+#include <lib/utils_def.h>
+
+typedef uintptr_t u_register_t;
+
+static inline bool is_feat_crc32_supported(void)
+{
+	return ENABLE_FEAT_CRC32 == FEAT_STATE_ALWAYS;
+}
+
+#endif /* ARCH_FEATURES_H */
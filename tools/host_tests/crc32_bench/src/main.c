@@ -0,0 +1,248 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host test and benchmark of tf_crc32(), the CRC32 of the GPT and FWU
+ * metadata. Its table-driven implementation, and the one using the CRC32
+ * instructions on AArch64 hosts, are built for the host as they are and
+ * checked against the crc32() of zlib on random buffers of random sizes and
+ * alignments, in one call and split across several calls. Their throughput
+ * is then measured against the size of the buffer.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <zlib.h>
+
+#include <lib/utils_def.h>
+
+#define MAX_SIZE		(1U << 20)
+#define RANDOM_CHECKS		20000U
+#define DEFAULT_BYTES		(256U << 20)
+
+typedef uint32_t (*crc32_fn_t)(uint32_t crc, const unsigned char *buf,
+			       size_t size);
+
+uint32_t tf_crc32_table(uint32_t crc, const unsigned char *buf, size_t size);
+#ifdef HAVE_CRC32_INSN
+uint32_t tf_crc32_insn(uint32_t crc, const unsigned char *buf, size_t size);
+#endif
+
+static uint32_t zlib_crc32(uint32_t crc, const unsigned char *buf, size_t size)
+{
+	return (uint32_t)crc32(crc, buf, (uInt)size);
+}
+
+typedef struct {
+	const char *name;
+	crc32_fn_t crc32;
+} crc32_impl_t;
+
+static const crc32_impl_t impls[] = {
+	{ "table", tf_crc32_table },
+#ifdef HAVE_CRC32_INSN
+	{ "insn", tf_crc32_insn },
+#endif
+	{ "zlib", zlib_crc32 },
+};
+
+#define IMPL_COUNT	(sizeof(impls) / sizeof(impls[0]))
+/* The last implementation is the reference */
+#define TESTED_COUNT	(IMPL_COUNT - 1U)
+
+static unsigned char *buf;
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+static size_t random_size(void)
+{
+	/* Mostly small buffers, like a GPT header, sometimes large ones */
+	switch (rand() % 4) {
+	case 0:
+		return (size_t)rand() % 16U;
+	case 1:
+		return (size_t)rand() % 256U;
+	case 2:
+		return (size_t)rand() % 16384U;
+	default:
+		return (size_t)rand() % (MAX_SIZE - 64U);
+	}
+}
+
+static int check(const crc32_impl_t *impl, uint32_t init,
+		 const unsigned char *data, size_t size)
+{
+	uint32_t expected, crc;
+	size_t done, part;
+
+	expected = zlib_crc32(init, data, size);
+
+	crc = impl->crc32(init, data, size);
+	if (crc != expected) {
+		fprintf(stderr,
+			"FAIL: %s, offset %zu, size %zu: 0x%08x instead of 0x%08x\n",
+			impl->name, (size_t)(data - buf), size, crc, expected);
+		return -1;
+	}
+
+	/* Same CRC when the buffer is split across several calls */
+	crc = init;
+	for (done = 0U; done < size; done += part) {
+		part = MIN((size_t)rand() % 1024U, size - done);
+		crc = impl->crc32(crc, data + done, part);
+	}
+	if (crc != expected) {
+		fprintf(stderr,
+			"FAIL: %s, offset %zu, size %zu in parts: 0x%08x instead of 0x%08x\n",
+			impl->name, (size_t)(data - buf), size, crc, expected);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int run_tests(void)
+{
+	static const unsigned char check_string[] = "123456789";
+	unsigned int i, n;
+	size_t size, offset;
+	uint32_t init;
+
+	for (n = 0U; n < TESTED_COUNT; n++) {
+		/* Check value of the CRC-32 of zlib */
+		if (impls[n].crc32(0U, check_string, 9U) != 0xcbf43926U) {
+			fprintf(stderr, "FAIL: %s, check value\n",
+				impls[n].name);
+			return -1;
+		}
+
+		for (size = 0U; size < 64U; size++) {
+			for (offset = 0U; offset < 16U; offset++) {
+				if (check(&impls[n], 0U, buf + offset,
+					  size) != 0) {
+					return -1;
+				}
+			}
+		}
+
+		for (i = 0U; i < RANDOM_CHECKS; i++) {
+			size = random_size();
+			offset = (size_t)rand() % 64U;
+			init = ((rand() % 2) == 0) ? 0U : (uint32_t)rand();
+			if (check(&impls[n], init, buf + offset, size) != 0) {
+				return -1;
+			}
+		}
+	}
+
+	return 0;
+}
+
+/* Throughput of each implementation in MB/s for buffers of `size` bytes */
+static void run_benchmark(size_t size, size_t total)
+{
+	unsigned int n, i, calls;
+	uint32_t crc = 0U;
+	uint64_t start;
+
+	calls = (unsigned int)MAX(total / size, (size_t)1U);
+
+	printf("%8zu", size);
+	for (n = 0U; n < IMPL_COUNT; n++) {
+		start = now_ns();
+		for (i = 0U; i < calls; i++) {
+			crc = impls[n].crc32(crc, buf + (i % 8U), size);
+		}
+		start = now_ns() - start;
+		printf(" %10.1f", ((double)calls * size * 1e3) / (double)start);
+	}
+	printf("\n");
+
+	/* Keep the computations from being optimised out. */
+	if (crc == 0x12345678U) {
+		printf("\n");
+	}
+}
+
+static void usage(const char *name)
+{
+	fprintf(stderr, "Usage: %s [-t] [-n bytes]\n", name);
+	fprintf(stderr, "  -t  only run the correctness tests\n");
+	fprintf(stderr, "  -n  bytes hashed per measurement (default: %u)\n",
+		DEFAULT_BYTES);
+	exit(EXIT_FAILURE);
+}
+
+int main(int argc, char *argv[])
+{
+	static const size_t sizes[] = {
+		16U, 92U, 512U, 4096U, 16384U, 65536U, MAX_SIZE - 8U
+	};
+	size_t total = DEFAULT_BYTES;
+	int tests_only = 0;
+	unsigned int i;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "tn:")) != -1) {
+		switch (opt) {
+		case 't':
+			tests_only = 1;
+			break;
+		case 'n':
+			total = strtoul(optarg, NULL, 0);
+			if (total == 0U) {
+				usage(argv[0]);
+			}
+			break;
+		default:
+			usage(argv[0]);
+		}
+	}
+
+	buf = malloc(MAX_SIZE);
+	if (buf == NULL) {
+		fprintf(stderr, "Out of memory\n");
+		return EXIT_FAILURE;
+	}
+
+	srand(1U);
+	for (i = 0U; i < MAX_SIZE; i++) {
+		buf[i] = (unsigned char)rand();
+	}
+
+	if (run_tests() != 0) {
+		return EXIT_FAILURE;
+	}
+	printf("All checks passed\n");
+
+	if (tests_only == 0) {
+		printf("Throughput in MB/s:\n");
+		printf("%8s", "size");
+		for (i = 0U; i < IMPL_COUNT; i++) {
+			printf(" %10s", impls[i].name);
+		}
+		printf("\n");
+		for (i = 0U; i < (sizeof(sizes) / sizeof(sizes[0])); i++) {
+			run_benchmark(sizes[i], total);
+		}
+	}
+
+	free(buf);
+
+	return EXIT_SUCCESS;
+}
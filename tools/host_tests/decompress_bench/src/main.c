@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host benchmark of the image decompressors of TF-A. Each compressed file
+ * given on the command line is decompressed several times with the same code
+ * as BL2, and the compression ratio and decode throughput are reported, so
+ * that the formats can be compared on real images.
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <common/image_decompress.h>
+#include <tf_gunzip.h>
+#include <tf_unlz4.h>
+#include <tf_unzstd.h>
+
+#define DEFAULT_ITERATIONS	10U
+#define MAX_OUT_SIZE		(256U << 20)
+#define WORK_SIZE		(1U << 20)
+
+static const image_decompressor_t *const decompressors[] = {
+	&gunzip_decompressor,
+	&unlz4_decompressor,
+	&unlz4_legacy_decompressor,
+	&unzstd_decompressor,
+};
+
+static const image_decompressor_t *find_decompressor(const uint8_t *buf,
+						     size_t len)
+{
+	unsigned int i;
+
+	for (i = 0U; i < (sizeof(decompressors) / sizeof(decompressors[0]));
+	     i++) {
+		if ((len >= decompressors[i]->magic_len) &&
+		    (memcmp(buf, decompressors[i]->magic,
+			    decompressors[i]->magic_len) == 0)) {
+			return decompressors[i];
+		}
+	}
+
+	return NULL;
+}
+
+static uint8_t *read_file(const char *name, size_t *len)
+{
+	uint8_t *buf;
+	FILE *fp;
+	long size;
+
+	fp = fopen(name, "rb");
+	if (fp == NULL) {
+		perror(name);
+		return NULL;
+	}
+
+	if ((fseek(fp, 0L, SEEK_END) != 0) || ((size = ftell(fp)) <= 0L) ||
+	    (fseek(fp, 0L, SEEK_SET) != 0)) {
+		fprintf(stderr, "%s: cannot get the size of the file\n", name);
+		fclose(fp);
+		return NULL;
+	}
+
+	buf = malloc((size_t)size);
+	if ((buf != NULL) && (fread(buf, 1U, (size_t)size, fp) != (size_t)size)) {
+		fprintf(stderr, "%s: cannot read the file\n", name);
+		free(buf);
+		buf = NULL;
+	}
+
+	fclose(fp);
+	*len = (size_t)size;
+
+	return buf;
+}
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (double)ts.tv_sec + ((double)ts.tv_nsec / 1e9);
+}
+
+static int bench_file(const char *name, unsigned int iterations,
+		      uint8_t *out, uint8_t *work)
+{
+	const image_decompressor_t *desc;
+	uintptr_t in_buf, out_buf;
+	size_t in_len, out_len = 0U;
+	double start, elapsed;
+	unsigned int i;
+	uint8_t *in;
+	int ret = 0;
+
+	in = read_file(name, &in_len);
+	if (in == NULL) {
+		return -1;
+	}
+
+	desc = find_decompressor(in, in_len);
+	if (desc == NULL) {
+		fprintf(stderr, "%s: unknown compression format\n", name);
+		free(in);
+		return -1;
+	}
+
+	start = now();
+	for (i = 0U; i < iterations; i++) {
+		in_buf = (uintptr_t)in;
+		out_buf = (uintptr_t)out;
+		ret = desc->decompress(&in_buf, in_len, &out_buf, MAX_OUT_SIZE,
+				       (uintptr_t)work, WORK_SIZE);
+		if (ret != 0) {
+			fprintf(stderr, "%s: decompression failed (%d)\n",
+				name, ret);
+			break;
+		}
+		out_len = out_buf - (uintptr_t)out;
+	}
+	elapsed = (now() - start) / iterations;
+
+	if (ret == 0) {
+		printf("%-32s %-12s %10zu %10zu %6.2f%% %9.1f\n", name,
+		       desc->name, in_len, out_len,
+		       (100.0 * (double)in_len) / (double)out_len,
+		       ((double)out_len / (1024.0 * 1024.0)) / elapsed);
+	}
+
+	free(in);
+
+	return ret;
+}
+
+int main(int argc, char *argv[])
+{
+	unsigned int iterations = DEFAULT_ITERATIONS;
+	uint8_t *out, *work;
+	int i, first = 1, ret = 0;
+
+	if ((argc > 2) && (strcmp(argv[1], "-n") == 0)) {
+		iterations = (unsigned int)strtoul(argv[2], NULL, 0);
+		first = 3;
+	}
+
+	if ((first >= argc) || (iterations == 0U)) {
+		fprintf(stderr, "Usage: %s [-n iterations] file...\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	out = malloc(MAX_OUT_SIZE);
+	work = malloc(WORK_SIZE);
+	if ((out == NULL) || (work == NULL)) {
+		fprintf(stderr, "Out of memory\n");
+		return EXIT_FAILURE;
+	}
+
+	printf("%-32s %-12s %10s %10s %7s %9s\n", "File", "Format", "Input",
+	       "Output", "Ratio", "MB/s");
+
+	for (i = first; i < argc; i++) {
+		if (bench_file(argv[i], iterations, out, work) != 0) {
+			ret = EXIT_FAILURE;
+		}
+	}
+
+	free(out);
+	free(work);
+
+	return ret;
+}
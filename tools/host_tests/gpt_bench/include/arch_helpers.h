@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef ARCH_HELPERS_H
+#define ARCH_HELPERS_H
+
+/*
+ * Host replacement of the architectural helpers used by the GPT library.
+ * The GPT registers are plain variables, barriers only order the accesses of
+ * the compiler, and the cache maintenance and TLB invalidation by PA are
+ * provided by the tool, which can make them take time to model the cost they
+ * have on hardware.
+ */
+#include <stddef.h>
+#include <stdint.h>
+
+#include <arch.h>
+
+typedef unsigned long u_register_t;
+
+extern u_register_t host_gpccr_el3;
+extern u_register_t host_gptbr_el3;
+
+static inline u_register_t read_sctlr_el3(void)
+{
+	return SCTLR_C_BIT;
+}
+
+static inline u_register_t read_gpccr_el3(void)
+{
+	return host_gpccr_el3;
+}
+
+static inline void write_gpccr_el3(u_register_t v)
+{
+	host_gpccr_el3 = v;
+}
+
+static inline u_register_t read_gptbr_el3(void)
+{
+	return host_gptbr_el3;
+}
+
+static inline void write_gptbr_el3(u_register_t v)
+{
+	host_gptbr_el3 = v;
+}
+
+#define HOST_BARRIER()	__asm__ volatile("" : : : "memory")
+
+static inline void isb(void)
+{
+	HOST_BARRIER();
+}
+
+static inline void dsb(void)
+{
+	HOST_BARRIER();
+}
+
+static inline void dsbsy(void)
+{
+	HOST_BARRIER();
+}
+
+static inline void dsbishst(void)
+{
+	HOST_BARRIER();
+}
+
+static inline void dsbosh(void)
+{
+	HOST_BARRIER();
+}
+
+static inline void dsboshst(void)
+{
+	HOST_BARRIER();
+}
+
+void flush_dcache_range(uintptr_t addr, size_t size);
+void flush_dcache_to_popa_range(uintptr_t addr, size_t size);
+void gpt_tlbi_by_pa_ll(uint64_t pa, size_t size);
+void tlbipaallos(void);
+
+#endif /* ARCH_HELPERS_H */
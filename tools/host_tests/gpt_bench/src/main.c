@@ -0,0 +1,356 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host multi-threaded stress test and benchmark of the granule transitions of
+ * the GPT library. The library is built for the host with its tables in host
+ * memory, and each thread plays the part of a CPU delegating and undelegating
+ * granules, either in an L0 region of its own or interleaved with the other
+ * threads in a single L0 region. Every transition must succeed, and the GPT
+ * must be back to its initial state at the end of each run. The transition
+ * throughput is reported against the number of threads.
+ */
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Include the library to check its tables with its static functions. */
+#include <gpt_rme.c>
+
+#define MAX_THREADS		64U
+#define REGION_COUNT		64U
+#define L0_TABLE_SIZE		(8U * 1024U)
+#define GRANULE_SIZE		PAGE_SIZE_4KB
+#define BATCH_GRANULES		64U
+#define DEFAULT_TRANSITIONS	20000U
+
+u_register_t host_gpccr_el3;
+u_register_t host_gptbr_el3;
+
+/* Time taken by each cache maintenance or TLBI operation on a granule */
+static unsigned long maint_ns;
+
+/* Lock serialising the transitions, as the library used to. */
+static spinlock_t global_lock;
+
+typedef enum {
+	MODE_OWN_REGION,
+	MODE_OWN_REGION_GLOBAL_LOCK,
+	MODE_SHARED_REGION,
+	MODE_COUNT
+} bench_mode_t;
+
+static const char *const mode_names[MODE_COUNT] = {
+	"own region",
+	"global lock",
+	"shared region",
+};
+
+typedef struct {
+	pthread_t thread;
+	unsigned int id;
+	unsigned int nthreads;
+	unsigned int transitions;
+	bench_mode_t mode;
+	unsigned int errors;
+} worker_t;
+
+static pthread_barrier_t start_barrier;
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+static void spin_ns(unsigned long ns)
+{
+	uint64_t end;
+
+	if (ns == 0UL) {
+		return;
+	}
+
+	end = now_ns() + ns;
+	while (now_ns() < end) {
+	}
+}
+
+void flush_dcache_range(uintptr_t addr, size_t size)
+{
+}
+
+void flush_dcache_to_popa_range(uintptr_t addr, size_t size)
+{
+	spin_ns(maint_ns * (size / GRANULE_SIZE));
+}
+
+void gpt_tlbi_by_pa_ll(uint64_t pa, size_t size)
+{
+	spin_ns(maint_ns);
+}
+
+void tlbipaallos(void)
+{
+	spin_ns(maint_ns);
+}
+
+bool xlat_arch_is_granule_size_supported(size_t size)
+{
+	return true;
+}
+
+static int setup_gpt(void)
+{
+	static pas_region_t pas_regions[] = {
+		GPT_MAP_REGION_GRANULE(0UL, (size_t)REGION_COUNT << 30,
+				       GPT_GPI_NS),
+	};
+	size_t l1_size = REGION_COUNT * GPT_L1_TABLE_SIZE(12U);
+	void *l0, *l1;
+
+	/* The 1TB PPS needs 8KB of L0 table, aligned to its size. */
+	if ((posix_memalign(&l0, L0_TABLE_SIZE, L0_TABLE_SIZE) != 0) ||
+	    (posix_memalign(&l1, GPT_L1_TABLE_SIZE(12U), l1_size) != 0)) {
+		fprintf(stderr, "Out of memory\n");
+		return -1;
+	}
+
+	if ((gpt_init_l0_tables(GPCCR_PPS_1TB, (uintptr_t)l0,
+				L0_TABLE_SIZE) != 0) ||
+	    (gpt_init_pas_l1_tables(GPCCR_PGS_4K, (uintptr_t)l1, l1_size,
+				    pas_regions,
+				    ARRAY_SIZE(pas_regions)) != 0) ||
+	    (gpt_enable() != 0) || (gpt_runtime_init() != 0)) {
+		fprintf(stderr, "GPT initialisation failed\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+static uint64_t granule_pa(const worker_t *w, unsigned int n)
+{
+	if (w->mode == MODE_SHARED_REGION) {
+		/*
+		 * Granules of all the threads are interleaved, so they share
+		 * L1 descriptors and a lost update would be detected.
+		 */
+		return ((uint64_t)n * w->nthreads + w->id) * GRANULE_SIZE;
+	}
+
+	return ((uint64_t)w->id << 30) + ((uint64_t)n * GRANULE_SIZE);
+}
+
+static int transition(const worker_t *w, uint64_t pa, bool delegate)
+{
+	int ret;
+
+	if (w->mode == MODE_OWN_REGION_GLOBAL_LOCK) {
+		spin_lock(&global_lock);
+	}
+
+	if (delegate) {
+		ret = gpt_delegate_pas(pa, GRANULE_SIZE, SMC_FROM_REALM);
+	} else {
+		ret = gpt_undelegate_pas(pa, GRANULE_SIZE, SMC_FROM_REALM);
+	}
+
+	if (w->mode == MODE_OWN_REGION_GLOBAL_LOCK) {
+		spin_unlock(&global_lock);
+	}
+
+	return ret;
+}
+
+/*
+ * Delegate a batch of granules one by one, then undelegate them, like a Realm
+ * being created and destroyed, until the requested number of transitions is
+ * reached.
+ */
+static void *worker_main(void *arg)
+{
+	worker_t *w = arg;
+	unsigned int done = 0U;
+	unsigned int n;
+
+	pthread_barrier_wait(&start_barrier);
+
+	while (done < w->transitions) {
+		for (n = 0U; n < BATCH_GRANULES; n++) {
+			if (transition(w, granule_pa(w, n), true) != 0) {
+				w->errors++;
+			}
+		}
+		for (n = 0U; n < BATCH_GRANULES; n++) {
+			if (transition(w, granule_pa(w, n), false) != 0) {
+				w->errors++;
+			}
+		}
+		done += 2U * BATCH_GRANULES;
+	}
+
+	return NULL;
+}
+
+/* Check that every granule is back in the NS PAS. */
+static int check_gpt(void)
+{
+	unsigned int i;
+
+	for (i = 0U; i < REGION_COUNT; i++) {
+		if (gpt_check_range_gpi((uint64_t)i << 30, 1UL << 30,
+					GPT_GPI_NS) != 0) {
+			fprintf(stderr, "FAIL: L0 region %u not all NS\n", i);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+/* Run one configuration, return the throughput in transitions per second. */
+static double run(bench_mode_t mode, unsigned int nthreads,
+		  unsigned int transitions)
+{
+	static worker_t workers[MAX_THREADS];
+	unsigned int errors = 0U;
+	uint64_t start;
+	unsigned int i;
+
+	pthread_barrier_init(&start_barrier, NULL, nthreads + 1U);
+
+	for (i = 0U; i < nthreads; i++) {
+		workers[i] = (worker_t) {
+			.id = i,
+			.nthreads = nthreads,
+			.transitions = transitions,
+			.mode = mode,
+		};
+		if (pthread_create(&workers[i].thread, NULL, worker_main,
+				   &workers[i]) != 0) {
+			fprintf(stderr, "Cannot create thread\n");
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	start = now_ns();
+	pthread_barrier_wait(&start_barrier);
+	for (i = 0U; i < nthreads; i++) {
+		pthread_join(workers[i].thread, NULL);
+		errors += workers[i].errors;
+	}
+	start = now_ns() - start;
+
+	pthread_barrier_destroy(&start_barrier);
+
+	if ((errors != 0U) || (check_gpt() != 0)) {
+		fprintf(stderr, "FAIL: %s, %u threads, %u failed transitions\n",
+			mode_names[mode], nthreads, errors);
+		exit(EXIT_FAILURE);
+	}
+
+	return ((double)nthreads * transitions * 1e9) / (double)start;
+}
+
+/* Double the number of threads up to the largest one, 0 when done. */
+static unsigned int next_thread_count(unsigned int nthreads,
+				      unsigned int max_threads)
+{
+	if (nthreads == max_threads) {
+		return 0U;
+	}
+
+	return (2U * nthreads > max_threads) ? max_threads : 2U * nthreads;
+}
+
+static void usage(const char *name)
+{
+	fprintf(stderr, "Usage: %s [-t threads] [-n transitions] [-c ns]\n",
+		name);
+	fprintf(stderr, "  -t  largest number of threads (default: CPUs)\n");
+	fprintf(stderr, "  -n  transitions per thread (default: %u)\n",
+		DEFAULT_TRANSITIONS);
+	fprintf(stderr, "  -c  time of each cache or TLB maintenance ");
+	fprintf(stderr, "operation on a granule (default: 0)\n");
+	exit(EXIT_FAILURE);
+}
+
+int main(int argc, char *argv[])
+{
+	unsigned int transitions = DEFAULT_TRANSITIONS;
+	unsigned int max_threads;
+	unsigned int nthreads;
+	double base[MODE_COUNT];
+	double res;
+	bench_mode_t mode;
+	int opt;
+
+	max_threads = (unsigned int)sysconf(_SC_NPROCESSORS_ONLN);
+	if (max_threads > MAX_THREADS) {
+		max_threads = MAX_THREADS;
+	}
+
+	while ((opt = getopt(argc, argv, "t:n:c:")) != -1) {
+		switch (opt) {
+		case 't':
+			max_threads = (unsigned int)strtoul(optarg, NULL, 0);
+			if ((max_threads == 0U) || (max_threads > MAX_THREADS)) {
+				usage(argv[0]);
+			}
+			break;
+		case 'n':
+			transitions = (unsigned int)strtoul(optarg, NULL, 0);
+			if (transitions == 0U) {
+				usage(argv[0]);
+			}
+			break;
+		case 'c':
+			maint_ns = strtoul(optarg, NULL, 0);
+			break;
+		default:
+			usage(argv[0]);
+		}
+	}
+
+	if (setup_gpt() != 0) {
+		return EXIT_FAILURE;
+	}
+
+	printf("Transitions per second (speedup over 1 thread), ");
+	printf("maintenance %lu ns per granule:\n", maint_ns);
+	printf("%8s", "threads");
+	for (mode = 0; mode < MODE_COUNT; mode++) {
+		printf(" %22s", mode_names[mode]);
+	}
+	printf("\n");
+
+	for (nthreads = 1U; nthreads != 0U;
+	     nthreads = next_thread_count(nthreads, max_threads)) {
+		printf("%8u", nthreads);
+		for (mode = 0; mode < MODE_COUNT; mode++) {
+			res = run(mode, nthreads, transitions);
+			if (nthreads == 1U) {
+				base[mode] = res;
+			}
+			printf(" %14.0f (%5.2f)", res, res / base[mode]);
+		}
+		printf("\n");
+	}
+
+	printf("All transitions succeeded\n");
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,68 @@
+#
+# Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+
+# Common part of the Makefiles of the host tests. A test sets HOST_TEST to its
+# name, OBJECTS to the objects it is linked from and TF_ROOT, then includes
+# this file. It may add to HOSTCCFLAGS, INC_DIR, LDLIBS and CHECK_ARGS, and
+# add rules for the objects built from the sources of the firmware.
+
+V		?= 0
+DEBUG		:= 0
+BENCHTOOL	?= ${HOST_TEST}${BIN_EXT}
+BINARY		:= $(notdir ${BENCHTOOL})
+
+HOST_TEST_DIR	:= ${TF_ROOT}/tools/host_tests
+
+MAKE_HELPERS_DIRECTORY := ${TF_ROOT}/make_helpers/
+include ${MAKE_HELPERS_DIRECTORY}build_macros.mk
+include ${MAKE_HELPERS_DIRECTORY}build_env.mk
+
+HOSTCC ?= gcc
+
+HOSTCCFLAGS += -Wall -std=gnu99 -O2
+
+ifeq (${DEBUG},1)
+  HOSTCCFLAGS += -g
+endif
+ifeq (${V},0)
+  Q := @
+else
+  Q :=
+endif
+
+# Include from the directory of the test first, then from the shared one, to
+# replace the headers of the firmware that are not usable on the host.
+HOST_INC_DIR := -I ./include -I ${HOST_TEST_DIR}/include -I ${TF_ROOT}/include \
+		${INC_DIR}
+
+# Arguments of the test to only run its checks, or "none" if it has none.
+CHECK_ARGS	?= -t
+
+.PHONY: all check clean realclean
+
+all: ${BINARY}
+
+${BINARY}: ${OBJECTS} Makefile
+	@echo "  HOSTLD  $@"
+	${Q}${HOSTCC} ${HOSTLDFLAGS} ${OBJECTS} ${LDLIBS} -o $@
+
+%.o: %.c
+	@echo "  HOSTCC  $<"
+	${Q}${HOSTCC} -c ${HOSTCCFLAGS} ${HOST_INC_DIR} $< -o $@
+
+check: ${BINARY}
+ifeq (${CHECK_ARGS},none)
+	@echo "  CHECK   ${BINARY}: no checks"
+else
+	@echo "  CHECK   ${BINARY}"
+	${Q}./${BINARY} ${CHECK_ARGS}
+endif
+
+clean:
+	$(call SHELL_DELETE_ALL, ${OBJECTS})
+
+realclean: clean
+	$(call SHELL_DELETE,${BINARY})
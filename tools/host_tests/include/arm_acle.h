@@ -0,0 +1,19 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef ARM_ACLE_H
+#define ARM_ACLE_H
+
+/*
+ * Host replacement of the ACLE header of the firmware libc: the one of the
+ * compiler is used on AArch64 hosts, and none is needed on other hosts, where
+ * the code using the ACLE intrinsics is not built.
+ */
+#ifdef __aarch64__
+#include_next <arm_acle.h>
+#endif
+
+#endif /* ARM_ACLE_H */
@@ -0,0 +1,13 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef CDEFS_H_SHIM
+#define CDEFS_H_SHIM
+
+/* The attribute macros of the firmware libc are used as they are. */
+#include "../../../include/lib/libc/cdefs.h"
+
+#endif /* CDEFS_H_SHIM */
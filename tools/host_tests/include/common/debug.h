@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef DEBUG_H
+#define DEBUG_H
+
+/*
+ * Host replacement of the logging functions of the firmware, used when its
+ * code is built for the host tests. Errors and warnings go to stderr, the
+ * other messages are dropped.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Check the format and arguments of a message, but print nothing. */
+#define HOST_LOG_DROP(...)				\
+	do {						\
+		if (0) {				\
+			printf(__VA_ARGS__);		\
+		}					\
+	} while (0)
+
+#define ERROR(...)	fprintf(stderr, "ERROR:   " __VA_ARGS__)
+#define WARN(...)	fprintf(stderr, "WARNING: " __VA_ARGS__)
+#define NOTICE(...)	HOST_LOG_DROP(__VA_ARGS__)
+#define INFO(...)	HOST_LOG_DROP(__VA_ARGS__)
+#define VERBOSE(...)	HOST_LOG_DROP(__VA_ARGS__)
+
+#define panic()		abort()
+
+#endif /* DEBUG_H */
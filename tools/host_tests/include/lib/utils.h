@@ -0,0 +1,25 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef UTILS_H
+#define UTILS_H
+
+/*
+ * Host replacement of the utility functions of the firmware. Apart from the
+ * macros, only zeromem() is needed by the code built for the host tests.
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <lib/utils_def.h>
+
+static inline void zeromem(void *mem, unsigned long length)
+{
+	memset(mem, 0, length);
+}
+
+#endif /* UTILS_H */
@@ -0,0 +1,13 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef XLAT_TABLES_V2_H
+#define XLAT_TABLES_V2_H
+
+/* Host replacement of the translation tables library, only with the sizes. */
+#include <lib/xlat_tables/xlat_tables_defs.h>
+
+#endif /* XLAT_TABLES_V2_H */
@@ -0,0 +1,20 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef PLATFORM_DEF_H
+#define PLATFORM_DEF_H
+
+/*
+ * Platform definitions used by the code built for the host tests, with the
+ * values of a typical Arm platform.
+ */
+#define CACHE_WRITEBACK_GRANULE		64
+#define PLATFORM_CORE_COUNT		8
+#define MAX_IO_BLOCK_DEVICES		1U
+#define MAX_IO_DEVICES			3
+#define MAX_IO_HANDLES			4
+
+#endif /* PLATFORM_DEF_H */
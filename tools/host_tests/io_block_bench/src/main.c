@@ -0,0 +1,366 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host test and benchmark of the block driver (drivers/io/io_block.c), built
+ * for the host as it is with its read cache enabled, on top of a block device
+ * in host memory. Like the low level drivers, the device only accepts reads
+ * and writes of whole blocks. Reads and writes of random sizes and positions
+ * in regions of random sizes must return the contents of the device. As in a
+ * release build, the end of a region is not always block-aligned. The number of calls to the low level
+ * driver is then compared with what the driver does without the cache, for
+ * several access patterns.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <cdefs.h>
+
+#include <drivers/io/io_block.h>
+#include <drivers/io/io_driver.h>
+#include <drivers/io/io_storage.h>
+#include <lib/utils_def.h>
+
+#define BLOCK_SIZE		512U
+#define DISK_SIZE		(4U * 1024U * 1024U)
+#define BUFFER_SIZE		(16U * 1024U)
+#define ROUNDS			2000U
+#define OPS_PER_ROUND		16U
+#define MAX_OP_SIZE		(12U * 1024U)
+#define BENCH_SIZE		(1024U * 1024U)
+
+static uint8_t disk[DISK_SIZE];
+static uint8_t model[DISK_SIZE];
+static uint8_t dev_buffer[BUFFER_SIZE] __aligned(BLOCK_SIZE);
+static uint8_t data[MAX_OP_SIZE];
+
+/* Requests that were not made of whole blocks within the device */
+static unsigned int bad_requests;
+static unsigned long long bytes_read;
+
+static bool check_request(int lba, size_t size)
+{
+	if (((size % BLOCK_SIZE) != 0U) || (size == 0U) || (lba < 0) ||
+	    (((size_t)lba * BLOCK_SIZE) + size > DISK_SIZE)) {
+		fprintf(stderr, "FAIL: request of %zu bytes at block %d\n",
+			size, lba);
+		bad_requests++;
+		return false;
+	}
+
+	return true;
+}
+
+static size_t disk_read(int lba, uintptr_t buf, size_t size)
+{
+	if (!check_request(lba, size)) {
+		return 0U;
+	}
+	memcpy((void *)buf, &disk[(size_t)lba * BLOCK_SIZE], size);
+	bytes_read += size;
+
+	return size;
+}
+
+static size_t disk_write(int lba, const uintptr_t buf, size_t size)
+{
+	if (!check_request(lba, size)) {
+		return 0U;
+	}
+	memcpy(&disk[(size_t)lba * BLOCK_SIZE], (void *)buf, size);
+
+	return size;
+}
+
+static io_block_dev_spec_t dev_spec = {
+	.buffer = {
+		.offset = (uintptr_t)dev_buffer,
+		.length = BUFFER_SIZE,
+	},
+	.ops = {
+		.read = disk_read,
+		.write = disk_write,
+	},
+	.block_size = BLOCK_SIZE,
+};
+
+static uintptr_t dev_handle;
+
+static unsigned int random_below(unsigned int n)
+{
+	return (unsigned int)rand() % n;
+}
+
+static int open_region(io_block_spec_t *region, uintptr_t *handle)
+{
+	int result = io_open(dev_handle, (uintptr_t)region, handle);
+
+	if (result != 0) {
+		fprintf(stderr, "FAIL: open of region 0x%zx+0x%zx: %d\n",
+			region->offset, region->length, result);
+	}
+
+	return result;
+}
+
+/* Read a range of a region and compare it with the model of the device */
+static int check_read(io_block_spec_t *region, uintptr_t handle,
+		      size_t pos, size_t size)
+{
+	size_t length_read = 0U;
+	int result;
+
+	result = io_seek(handle, IO_SEEK_SET, (signed long long)pos);
+	if (result == 0) {
+		result = io_read(handle, (uintptr_t)data, size, &length_read);
+	}
+	if ((result != 0) || (length_read != size)) {
+		fprintf(stderr,
+			"FAIL: read of 0x%zx bytes at 0x%zx of region 0x%zx+0x%zx: %d\n",
+			size, pos, region->offset, region->length, result);
+		return -1;
+	}
+	if (memcmp(data, &model[region->offset + pos], size) != 0) {
+		fprintf(stderr,
+			"FAIL: wrong data read at 0x%zx of region 0x%zx+0x%zx\n",
+			pos, region->offset, region->length);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int do_write(io_block_spec_t *region, uintptr_t handle, size_t pos,
+		    size_t size)
+{
+	size_t length_written = 0U;
+	size_t i;
+	int result;
+
+	for (i = 0U; i < size; i++) {
+		data[i] = (uint8_t)rand();
+	}
+
+	result = io_seek(handle, IO_SEEK_SET, (signed long long)pos);
+	if (result == 0) {
+		result = io_write(handle, (uintptr_t)data, size,
+				  &length_written);
+	}
+	if ((result != 0) || (length_written != size)) {
+		fprintf(stderr,
+			"FAIL: write of 0x%zx bytes at 0x%zx of region 0x%zx+0x%zx: %d\n",
+			size, pos, region->offset, region->length, result);
+		return -1;
+	}
+	memcpy(&model[region->offset + pos], data, size);
+
+	return 0;
+}
+
+/*
+ * Read the last bytes of regions whose end is not block-aligned, through the
+ * cache, after reading the start of the region or not.
+ */
+static int test_region_ends(void)
+{
+	static const size_t tails[] = { 1U, 100U, BLOCK_SIZE - 1U,
+					BLOCK_SIZE + 1U, 4096U - 1U };
+	io_block_spec_t region;
+	uintptr_t handle;
+	unsigned int i, warm;
+	size_t size;
+
+	for (warm = 0U; warm < 2U; warm++) {
+		for (i = 0U; i < (sizeof(tails) / sizeof(tails[0])); i++) {
+			region.offset = 64U * 1024U * (i + 1U);
+			region.length = (3U * 4096U) + tails[i];
+			if (open_region(&region, &handle) != 0) {
+				return -1;
+			}
+			if ((warm != 0U) &&
+			    (check_read(&region, handle, 0U, 64U) != 0)) {
+				return -1;
+			}
+			size = MIN(tails[i], (size_t)64U);
+			if (check_read(&region, handle, region.length - size,
+				       size) != 0) {
+				return -1;
+			}
+			io_close(handle);
+		}
+	}
+
+	return 0;
+}
+
+/* Random reads and writes in random regions */
+static int test_random(void)
+{
+	io_block_spec_t region;
+	uintptr_t handle;
+	unsigned int round, op;
+	size_t pos, size;
+
+	for (round = 0U; round < ROUNDS; round++) {
+		region.offset = random_below(DISK_SIZE / BLOCK_SIZE) *
+				BLOCK_SIZE;
+		region.length = 1U + random_below(DISK_SIZE - region.offset);
+		region.length = MIN(region.length, (size_t)(256U * 1024U));
+		if (random_below(2U) == 0U) {
+			region.length = round_up(region.length, BLOCK_SIZE);
+		}
+		if (open_region(&region, &handle) != 0) {
+			return -1;
+		}
+
+		for (op = 0U; op < OPS_PER_ROUND; op++) {
+			/* Mostly small reads, which are served by the cache */
+			switch (random_below(4U)) {
+			case 0U:
+				size = 1U + random_below(MAX_OP_SIZE);
+				break;
+			default:
+				size = 1U + random_below(256U);
+				break;
+			}
+			size = MIN(size, region.length);
+			pos = random_below(region.length - size + 1U);
+
+			if (random_below(8U) == 0U) {
+				if (do_write(&region, handle, pos, size) != 0) {
+					return -1;
+				}
+			} else if (check_read(&region, handle, pos,
+					      size) != 0) {
+				return -1;
+			}
+		}
+		io_close(handle);
+	}
+
+	return 0;
+}
+
+static int run_tests(void)
+{
+	size_t i;
+
+	for (i = 0U; i < DISK_SIZE; i++) {
+		disk[i] = (uint8_t)rand();
+	}
+	memcpy(model, disk, DISK_SIZE);
+
+	if ((test_region_ends() != 0) || (test_random() != 0)) {
+		return -1;
+	}
+	if (memcmp(disk, model, DISK_SIZE) != 0) {
+		fprintf(stderr, "FAIL: wrong data written to the device\n");
+		return -1;
+	}
+	if (bad_requests != 0U) {
+		return -1;
+	}
+
+	return 0;
+}
+
+/*
+ * Read BENCH_SIZE bytes of a region with reads of a given size, sequentially
+ * or at random positions, and print the number of calls to the low level
+ * driver. Without the cache, the driver makes one call per read.
+ */
+static int run_benchmark(const char *name, size_t size, bool sequential)
+{
+	io_block_spec_t region = {
+		.offset = DISK_SIZE - BENCH_SIZE,
+		.length = BENCH_SIZE,
+	};
+	io_block_cache_stats_t before, after;
+	unsigned long long bytes_before = bytes_read;
+	unsigned int reads = BENCH_SIZE / size;
+	uintptr_t handle;
+	unsigned int i;
+	size_t pos;
+
+	io_block_get_cache_stats(&before);
+	if (open_region(&region, &handle) != 0) {
+		return -1;
+	}
+	for (i = 0U; i < reads; i++) {
+		pos = sequential ? (i * size) :
+		      (random_below(BENCH_SIZE / size) * size);
+		if (check_read(&region, handle, pos, size) != 0) {
+			return -1;
+		}
+	}
+	io_close(handle);
+	io_block_get_cache_stats(&after);
+
+	printf("%-12s %6zu %10u %10u %10u %12llu\n", name, size, reads,
+	       after.reads - before.reads, after.hits - before.hits,
+	       (bytes_read - bytes_before) / 1024U);
+
+	return 0;
+}
+
+static void usage(const char *name)
+{
+	fprintf(stderr, "Usage: %s [-t]\n", name);
+	fprintf(stderr, "  -t  only run the correctness tests\n");
+	exit(EXIT_FAILURE);
+}
+
+int main(int argc, char *argv[])
+{
+	static const size_t sizes[] = { 16U, 92U, 512U, 4096U };
+	const io_dev_connector_t *dev_con;
+	int tests_only = 0;
+	unsigned int i;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "t")) != -1) {
+		switch (opt) {
+		case 't':
+			tests_only = 1;
+			break;
+		default:
+			usage(argv[0]);
+		}
+	}
+
+	srand(1U);
+
+	if ((register_io_dev_block(&dev_con) != 0) ||
+	    (io_dev_open(dev_con, (uintptr_t)&dev_spec, &dev_handle) != 0)) {
+		fprintf(stderr, "FAIL: can't open the block device\n");
+		return EXIT_FAILURE;
+	}
+
+	if (run_tests() != 0) {
+		return EXIT_FAILURE;
+	}
+	printf("All checks passed\n");
+
+	if (tests_only == 0) {
+		printf("Reads of %uKB, calls to the low level driver:\n",
+		       BENCH_SIZE / 1024U);
+		printf("%-12s %6s %10s %10s %10s %12s\n", "pattern", "size",
+		       "uncached", "cached", "hits", "KB read");
+		for (i = 0U; i < (sizeof(sizes) / sizeof(sizes[0])); i++) {
+			if ((run_benchmark("sequential", sizes[i], true) != 0) ||
+			    (run_benchmark("random", sizes[i], false) != 0)) {
+				return EXIT_FAILURE;
+			}
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,362 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host test and benchmark of the AArch64 string functions of the TF-A libc.
+ * The assembly versions of memcpy, memmove, memcmp and strlen are first
+ * checked against simple reference loops for all the combinations of sizes
+ * and alignments, then their throughput is compared with the generic C
+ * versions of the TF-A libc and with the libc of the host.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MAX_TEST_SIZE		1024U
+#define MAX_ALIGN		16U
+#define RANDOM_TESTS		100000U
+#define BENCH_BYTES		(256UL << 20)
+#define BUF_SIZE		((2UL << 20) + 64U)
+
+void *tf_memcpy(void *dst, const void *src, size_t len);
+void *tf_memmove(void *dst, const void *src, size_t len);
+int tf_memcmp(const void *s1, const void *s2, size_t len);
+size_t tf_strlen(const char *s);
+
+void *c_memcpy(void *dst, const void *src, size_t len);
+void *c_memmove(void *dst, const void *src, size_t len);
+int c_memcmp(const void *s1, const void *s2, size_t len);
+size_t c_strlen(const char *s);
+
+typedef void *(*copy_fn_t)(void *dst, const void *src, size_t len);
+typedef int (*cmp_fn_t)(const void *s1, const void *s2, size_t len);
+typedef size_t (*len_fn_t)(const char *s);
+
+/* Called through volatile pointers so that the calls are not inlined. */
+static copy_fn_t volatile host_memcpy = memcpy;
+static copy_fn_t volatile host_memmove = memmove;
+static cmp_fn_t volatile host_memcmp = memcmp;
+static len_fn_t volatile host_strlen = strlen;
+
+static unsigned int failures;
+
+static void fail(const char *func, size_t len, size_t a1, size_t a2)
+{
+	if (failures++ < 20U) {
+		fprintf(stderr, "FAIL: %s len %zu offsets %zu %zu\n",
+			func, len, a1, a2);
+	}
+}
+
+static void fill_random(uint8_t *buf, size_t len)
+{
+	size_t i;
+
+	for (i = 0U; i < len; i++) {
+		buf[i] = (uint8_t)rand();
+	}
+}
+
+static int sign(int v)
+{
+	return (v > 0) - (v < 0);
+}
+
+/* Copy 'len' bytes and check that nothing around 'dst' is written. */
+static void check_memcpy(size_t len, size_t s_off, size_t d_off)
+{
+	static uint8_t src[MAX_TEST_SIZE + 2U * MAX_ALIGN];
+	static uint8_t dst[MAX_TEST_SIZE + 2U * MAX_ALIGN];
+	static uint8_t exp[MAX_TEST_SIZE + 2U * MAX_ALIGN];
+	size_t i;
+
+	fill_random(src, sizeof(src));
+	fill_random(dst, sizeof(dst));
+	memcpy(exp, dst, sizeof(dst));
+	for (i = 0U; i < len; i++) {
+		exp[d_off + i] = src[s_off + i];
+	}
+
+	if ((tf_memcpy(dst + d_off, src + s_off, len) != dst + d_off) ||
+	    (memcmp(dst, exp, sizeof(dst)) != 0)) {
+		fail("memcpy", len, s_off, d_off);
+	}
+}
+
+/* Move 'len' bytes inside one buffer, the objects may overlap. */
+static void check_memmove(size_t len, size_t s_off, size_t d_off)
+{
+	static uint8_t buf[2U * MAX_TEST_SIZE + 2U * MAX_ALIGN];
+	static uint8_t exp[2U * MAX_TEST_SIZE + 2U * MAX_ALIGN];
+	static uint8_t tmp[MAX_TEST_SIZE];
+	size_t i;
+
+	fill_random(buf, sizeof(buf));
+	memcpy(exp, buf, sizeof(buf));
+	for (i = 0U; i < len; i++) {
+		tmp[i] = exp[s_off + i];
+	}
+	for (i = 0U; i < len; i++) {
+		exp[d_off + i] = tmp[i];
+	}
+
+	if ((tf_memmove(buf + d_off, buf + s_off, len) != buf + d_off) ||
+	    (memcmp(buf, exp, sizeof(buf)) != 0)) {
+		fail("memmove", len, s_off, d_off);
+	}
+}
+
+/* Compare objects that differ at 'diff', or are equal if diff >= len. */
+static void check_memcmp(size_t len, size_t off1, size_t off2, size_t diff)
+{
+	static uint8_t b1[MAX_TEST_SIZE + MAX_ALIGN];
+	static uint8_t b2[MAX_TEST_SIZE + MAX_ALIGN];
+	int expected = 0;
+
+	fill_random(b1, sizeof(b1));
+	memcpy(b2 + off2, b1 + off1, len);
+	if (diff < len) {
+		do {
+			b2[off2 + diff] = (uint8_t)rand();
+		} while (b2[off2 + diff] == b1[off1 + diff]);
+		expected = (b1[off1 + diff] < b2[off2 + diff]) ? -1 : 1;
+	}
+
+	if (sign(tf_memcmp(b1 + off1, b2 + off2, len)) != expected) {
+		fail("memcmp", len, off1, off2);
+	}
+}
+
+/*
+ * Place strings so that their terminating NUL is the last byte before an
+ * inaccessible page, to check that strlen never reads across it.
+ */
+static void check_strlen(uint8_t *page_end)
+{
+	size_t len, off;
+	char *s;
+
+	for (len = 0U; len < MAX_TEST_SIZE; len++) {
+		s = (char *)page_end - len - 1U;
+		memset(s, 'a', len);
+		s[len] = '\0';
+		if (tf_strlen(s) != len) {
+			fail("strlen", len, (uintptr_t)s & 7U, 0U);
+		}
+	}
+
+	/* NUL at any position in a word, with other bytes >= 0x80 */
+	for (off = 0U; off < MAX_ALIGN; off++) {
+		s = (char *)page_end - MAX_TEST_SIZE + off;
+		for (len = 0U; len < 64U; len++) {
+			memset(s, 0x80 | (rand() & 0x7f), 64U);
+			s[len] = '\0';
+			if (tf_strlen(s) != len) {
+				fail("strlen", len, off, 0U);
+			}
+		}
+	}
+}
+
+static int run_tests(void)
+{
+	size_t len, a1, a2, page_size;
+	unsigned int i;
+	uint8_t *pages;
+
+	/* Small objects with all the combinations of alignments */
+	for (len = 0U; len <= 80U; len++) {
+		for (a1 = 0U; a1 < MAX_ALIGN; a1++) {
+			for (a2 = 0U; a2 < MAX_ALIGN; a2++) {
+				check_memcpy(len, a1, a2);
+				check_memmove(len, a1, a2 + MAX_TEST_SIZE);
+				check_memmove(len, a1 + len / 2U, a2);
+				check_memmove(len, a1, a2 + len / 2U);
+				check_memcmp(len, a1, a2, len);
+				check_memcmp(len, a1, a2, len - 1U);
+				check_memcmp(len, a1, a2, len / 2U);
+			}
+		}
+	}
+
+	/* Random sizes, alignments and overlaps */
+	for (i = 0U; i < RANDOM_TESTS; i++) {
+		len = (size_t)rand() % MAX_TEST_SIZE;
+		a1 = (size_t)rand() % (2U * MAX_ALIGN);
+		a2 = (size_t)rand() % (2U * MAX_ALIGN);
+		check_memcpy(len, a1, a2);
+		check_memmove(len, a1, (size_t)rand() % (MAX_TEST_SIZE + 1U));
+		check_memmove(len, (size_t)rand() % (MAX_TEST_SIZE + 1U), a2);
+		check_memcmp(len, a1 % MAX_ALIGN, a2 % MAX_ALIGN,
+			      (size_t)rand() % (MAX_TEST_SIZE + 1U));
+	}
+
+	page_size = (size_t)sysconf(_SC_PAGESIZE);
+	pages = mmap(NULL, 2U * page_size, PROT_READ | PROT_WRITE,
+		     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if ((pages == MAP_FAILED) ||
+	    (mprotect(pages + page_size, page_size, PROT_NONE) != 0)) {
+		perror("mmap");
+		return -1;
+	}
+	check_strlen(pages + page_size);
+	munmap(pages, 2U * page_size);
+
+	return (failures == 0U) ? 0 : -1;
+}
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (double)ts.tv_sec + ((double)ts.tv_nsec / 1e9);
+}
+
+static void print_result(const char *func, const char *impl, size_t len,
+			 unsigned long iterations, double secs)
+{
+	printf("%-8s %-6s %8zu %10.1f MB/s\n", func, impl, len,
+	       ((double)len * iterations) / (secs * 1e6));
+}
+
+static void bench_copy(const char *func, const char *impl, copy_fn_t fn,
+		       uint8_t *dst, const uint8_t *src, size_t len)
+{
+	unsigned long i, iterations = BENCH_BYTES / len;
+	double start;
+
+	start = now();
+	for (i = 0UL; i < iterations; i++) {
+		fn(dst, src, len);
+	}
+	print_result(func, impl, len, iterations, now() - start);
+}
+
+static void bench_cmp(const char *impl, cmp_fn_t fn, const uint8_t *b1,
+		      const uint8_t *b2, size_t len)
+{
+	unsigned long i, iterations = BENCH_BYTES / len;
+	volatile int res;
+	double start;
+
+	start = now();
+	for (i = 0UL; i < iterations; i++) {
+		res = fn(b1, b2, len);
+	}
+	print_result("memcmp", impl, len, iterations, now() - start);
+	(void)res;
+}
+
+static void bench_len(const char *impl, len_fn_t fn, const char *s,
+		      size_t len)
+{
+	unsigned long i, iterations = BENCH_BYTES / len;
+	volatile size_t res;
+	double start;
+
+	start = now();
+	for (i = 0UL; i < iterations; i++) {
+		res = fn(s);
+	}
+	print_result("strlen", impl, len, iterations, now() - start);
+	(void)res;
+}
+
+static void run_benchmarks(unsigned int max_shift)
+{
+	static const char *const impls[] = { "asm", "c", "host" };
+	const copy_fn_t memcpys[] = { tf_memcpy, c_memcpy, host_memcpy };
+	const copy_fn_t memmoves[] = { tf_memmove, c_memmove, host_memmove };
+	const cmp_fn_t memcmps[] = { tf_memcmp, c_memcmp, host_memcmp };
+	const len_fn_t strlens[] = { tf_strlen, c_strlen, host_strlen };
+	uint8_t *b1 = malloc(BUF_SIZE);
+	uint8_t *b2 = malloc(BUF_SIZE);
+	unsigned int shift, i;
+	size_t len;
+
+	if ((b1 == NULL) || (b2 == NULL)) {
+		fprintf(stderr, "Out of memory\n");
+		exit(EXIT_FAILURE);
+	}
+
+	memset(b1, 'a', BUF_SIZE);
+	memset(b2, 'a', BUF_SIZE);
+
+	printf("%-8s %-6s %8s %15s\n", "function", "impl", "size",
+	       "throughput");
+	for (shift = 3U; shift <= max_shift; shift += 3U) {
+		len = 1UL << shift;
+		for (i = 0U; i < 3U; i++) {
+			bench_copy("memcpy", impls[i], memcpys[i], b1, b2, len);
+		}
+		for (i = 0U; i < 3U; i++) {
+			/* Overlapping backward move */
+			bench_copy("memmove", impls[i], memmoves[i], b1 + 8U,
+				   b1, len);
+		}
+		for (i = 0U; i < 3U; i++) {
+			bench_cmp(impls[i], memcmps[i], b1, b2, len);
+		}
+		b1[len] = '\0';
+		for (i = 0U; i < 3U; i++) {
+			bench_len(impls[i], strlens[i], (const char *)b1, len);
+		}
+		b1[len] = 'a';
+	}
+
+	free(b1);
+	free(b2);
+}
+
+static void usage(const char *name)
+{
+	fprintf(stderr, "Usage: %s [-t] [-s max_size_log2]\n", name);
+	fprintf(stderr, "  -t  only run the correctness tests\n");
+	exit(EXIT_FAILURE);
+}
+
+int main(int argc, char *argv[])
+{
+	unsigned int max_shift = 21U;
+	int tests_only = 0;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "ts:")) != -1) {
+		switch (opt) {
+		case 't':
+			tests_only = 1;
+			break;
+		case 's':
+			max_shift = (unsigned int)strtoul(optarg, NULL, 0);
+			if ((max_shift < 3U) || (max_shift > 21U)) {
+				usage(argv[0]);
+			}
+			break;
+		default:
+			usage(argv[0]);
+		}
+	}
+
+	srand(1U);
+	if (run_tests() != 0) {
+		fprintf(stderr, "%u check(s) failed\n", failures);
+		return EXIT_FAILURE;
+	}
+	printf("All checks passed\n");
+
+	if (tests_only == 0) {
+		run_benchmarks(max_shift);
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,316 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host benchmark of the acquire latency of the exclusive locks of the
+ * firmware: the spinlock and the ticket lock that PSCI_USE_TICKET_LOCK selects
+ * for the power domain locks. The assembly implementations are built as they
+ * are and each thread plays the part of a CPU. The latency of an uncontended
+ * acquisition is measured first, then the latency seen by each contender when
+ * all the threads take the same lock in a loop. Mutual exclusion is checked
+ * in every critical section.
+ */
+
+#define _GNU_SOURCE
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <lib/spinlock.h>
+#include <lib/ticket_lock.h>
+
+#define MAX_THREADS		256U
+#define CACHE_LINE_SIZE		64U
+#define DEFAULT_ACQUIRES	100000U
+#define UNCONTENDED_ACQUIRES	10000000U
+
+typedef struct {
+	const char *name;
+	void (*get)(void *lock);
+	void (*release)(void *lock);
+} lock_ops_t;
+
+static void spinlock_get_op(void *lock)
+{
+	spin_lock(lock);
+}
+
+static void spinlock_release_op(void *lock)
+{
+	spin_unlock(lock);
+}
+
+static void ticket_lock_get_op(void *lock)
+{
+	ticket_lock_get(lock);
+}
+
+static void ticket_lock_release_op(void *lock)
+{
+	ticket_lock_release(lock);
+}
+
+static const lock_ops_t lock_ops[] = {
+	{ "spinlock", spinlock_get_op, spinlock_release_op },
+	{ "ticket lock", ticket_lock_get_op, ticket_lock_release_op },
+};
+
+#define LOCK_COUNT	(sizeof(lock_ops) / sizeof(lock_ops[0]))
+
+/* Each lock, and the data it protects, in a cache line of its own. */
+static union {
+	spinlock_t spinlock;
+	ticket_lock_t ticket_lock;
+	uint8_t pad[CACHE_LINE_SIZE];
+} the_lock __attribute__((aligned(CACHE_LINE_SIZE)));
+
+static struct {
+	volatile unsigned long count;
+	volatile unsigned int owner;
+} shared __attribute__((aligned(CACHE_LINE_SIZE)));
+
+/* Time spent in and out of the critical section by each thread. */
+static unsigned long hold_ns;
+static unsigned long delay_ns;
+
+typedef struct {
+	pthread_t thread;
+	unsigned int id;
+	unsigned int acquires;
+	const lock_ops_t *ops;
+	uint64_t total_ns;
+	uint64_t max_ns;
+	unsigned int errors;
+} worker_t;
+
+static pthread_barrier_t start_barrier;
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+static void spin_ns(unsigned long ns)
+{
+	uint64_t end;
+
+	if (ns == 0UL) {
+		return;
+	}
+
+	end = now_ns() + ns;
+	while (now_ns() < end) {
+	}
+}
+
+static void pin_to_cpu(unsigned int cpu)
+{
+	cpu_set_t set;
+
+	CPU_ZERO(&set);
+	CPU_SET(cpu % (unsigned int)sysconf(_SC_NPROCESSORS_ONLN), &set);
+	(void)pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+static void *worker_main(void *arg)
+{
+	worker_t *w = arg;
+	uint64_t start, elapsed;
+	unsigned int i;
+
+	pin_to_cpu(w->id);
+	pthread_barrier_wait(&start_barrier);
+
+	for (i = 0U; i < w->acquires; i++) {
+		start = now_ns();
+		w->ops->get(&the_lock);
+		elapsed = now_ns() - start;
+
+		/* Nobody else may enter the critical section meanwhile. */
+		shared.owner = w->id;
+		shared.count++;
+		spin_ns(hold_ns);
+		if (shared.owner != w->id) {
+			w->errors++;
+		}
+
+		w->ops->release(&the_lock);
+
+		w->total_ns += elapsed;
+		if (elapsed > w->max_ns) {
+			w->max_ns = elapsed;
+		}
+
+		spin_ns(delay_ns);
+	}
+
+	return NULL;
+}
+
+/* Both types of lock are free when all their fields are zero. */
+static void reset_lock(void)
+{
+	memset(&the_lock, 0, sizeof(the_lock));
+}
+
+/* Average time of an acquisition and release of a free lock. */
+static double run_uncontended(const lock_ops_t *ops)
+{
+	uint64_t start;
+	unsigned int i;
+
+	pin_to_cpu(0U);
+	reset_lock();
+
+	start = now_ns();
+	for (i = 0U; i < UNCONTENDED_ACQUIRES; i++) {
+		ops->get(&the_lock);
+		ops->release(&the_lock);
+	}
+
+	return (double)(now_ns() - start) / UNCONTENDED_ACQUIRES;
+}
+
+static void run_contended(const lock_ops_t *ops, unsigned int nthreads,
+			  unsigned int acquires)
+{
+	static worker_t workers[MAX_THREADS];
+	double mean, min_mean = 0.0, max_mean = 0.0;
+	uint64_t total_ns = 0U, max_ns = 0U;
+	unsigned int errors = 0U;
+	unsigned int i;
+
+	reset_lock();
+	shared.count = 0UL;
+	pthread_barrier_init(&start_barrier, NULL, nthreads);
+
+	for (i = 0U; i < nthreads; i++) {
+		workers[i] = (worker_t) {
+			.id = i,
+			.acquires = acquires,
+			.ops = ops,
+		};
+		if (pthread_create(&workers[i].thread, NULL, worker_main,
+				   &workers[i]) != 0) {
+			fprintf(stderr, "Cannot create thread\n");
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	for (i = 0U; i < nthreads; i++) {
+		pthread_join(workers[i].thread, NULL);
+
+		errors += workers[i].errors;
+		total_ns += workers[i].total_ns;
+		if (workers[i].max_ns > max_ns) {
+			max_ns = workers[i].max_ns;
+		}
+
+		mean = (double)workers[i].total_ns / acquires;
+		if ((i == 0U) || (mean < min_mean)) {
+			min_mean = mean;
+		}
+		if ((i == 0U) || (mean > max_mean)) {
+			max_mean = mean;
+		}
+	}
+
+	pthread_barrier_destroy(&start_barrier);
+
+	if ((errors != 0U) ||
+	    (shared.count != (unsigned long)nthreads * acquires)) {
+		fprintf(stderr, "FAIL: %s, %u threads, mutual exclusion broken\n",
+			ops->name, nthreads);
+		exit(EXIT_FAILURE);
+	}
+
+	printf("%-12s %8u %10.1f %10.1f %10.1f %12.1f\n", ops->name, nthreads,
+	       (double)total_ns / ((double)nthreads * acquires), min_mean,
+	       max_mean, (double)max_ns);
+}
+
+static void usage(const char *name)
+{
+	fprintf(stderr, "Usage: %s [-t threads] [-n acquires] [-w ns] [-d ns]\n",
+		name);
+	fprintf(stderr, "  -t  largest number of threads (default: CPUs)\n");
+	fprintf(stderr, "  -n  acquisitions per thread (default: %u)\n",
+		DEFAULT_ACQUIRES);
+	fprintf(stderr, "  -w  time spent holding the lock (default: 0)\n");
+	fprintf(stderr, "  -d  time spent between acquisitions (default: 0)\n");
+	exit(EXIT_FAILURE);
+}
+
+int main(int argc, char *argv[])
+{
+	unsigned int acquires = DEFAULT_ACQUIRES;
+	unsigned int max_threads;
+	unsigned int nthreads;
+	unsigned int i;
+	int opt;
+
+	max_threads = (unsigned int)sysconf(_SC_NPROCESSORS_ONLN);
+	if (max_threads > MAX_THREADS) {
+		max_threads = MAX_THREADS;
+	}
+
+	while ((opt = getopt(argc, argv, "t:n:w:d:")) != -1) {
+		switch (opt) {
+		case 't':
+			max_threads = (unsigned int)strtoul(optarg, NULL, 0);
+			if ((max_threads == 0U) || (max_threads > MAX_THREADS)) {
+				usage(argv[0]);
+			}
+			break;
+		case 'n':
+			acquires = (unsigned int)strtoul(optarg, NULL, 0);
+			if (acquires == 0U) {
+				usage(argv[0]);
+			}
+			break;
+		case 'w':
+			hold_ns = strtoul(optarg, NULL, 0);
+			break;
+		case 'd':
+			delay_ns = strtoul(optarg, NULL, 0);
+			break;
+		default:
+			usage(argv[0]);
+		}
+	}
+
+	printf("Uncontended acquisition and release, in ns:\n");
+	for (i = 0U; i < LOCK_COUNT; i++) {
+		printf("%-12s %10.1f\n", lock_ops[i].name,
+		       run_uncontended(&lock_ops[i]));
+	}
+
+	printf("\nContended acquisition, in ns, holding the lock for %lu ns ",
+	       hold_ns);
+	printf("and waiting %lu ns between acquisitions:\n", delay_ns);
+	printf("%-12s %8s %10s %10s %10s %12s\n", "lock", "threads", "mean",
+	       "min thread", "max thread", "worst");
+	for (i = 0U; i < LOCK_COUNT; i++) {
+		for (nthreads = 1U; nthreads < max_threads; nthreads *= 2U) {
+			run_contended(&lock_ops[i], nthreads, acquires);
+		}
+		run_contended(&lock_ops[i], max_threads, acquires);
+	}
+
+	printf("Mutual exclusion held in all runs\n");
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,20 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef BL_COMMON_H
+#define BL_COMMON_H
+
+/*
+ * Host replacement of the common definitions of the boot loader stages, only
+ * with the types used by the SPMC headers.
+ */
+#include <stddef.h>
+#include <stdint.h>
+
+typedef unsigned long u_register_t;
+typedef struct entry_point_info entry_point_info_t;
+
+#endif /* BL_COMMON_H */
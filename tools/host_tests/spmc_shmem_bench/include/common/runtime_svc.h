@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef RUNTIME_SVC_H
+#define RUNTIME_SVC_H
+
+/*
+ * Host replacement of the runtime services framework. The SMC return macros
+ * return the first value, there is no context to write the others to.
+ */
+#include <common/bl_common.h>
+#include <lib/cassert.h>
+#include <lib/utils_def.h>
+
+#define SMC_RET1(_h, _x0)	return (uint64_t)(_x0)
+#define SMC_RET8(_h, _x0, _x1, _x2, _x3, _x4, _x5, _x6, _x7)	\
+	do {							\
+		(void)(_x1);					\
+		(void)(_x2);					\
+		(void)(_x3);					\
+		(void)(_x4);					\
+		(void)(_x5);					\
+		(void)(_x6);					\
+		(void)(_x7);					\
+		return (uint64_t)(_x0);				\
+	} while (false)
+
+#endif /* RUNTIME_SVC_H */
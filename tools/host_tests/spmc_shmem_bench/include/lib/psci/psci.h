@@ -0,0 +1,15 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef PSCI_H
+#define PSCI_H
+
+/* Host replacement of the PSCI library, only with the types used by the SPMC. */
+#include <platform_def.h>
+
+typedef struct spd_pm_ops spd_pm_ops_t;
+
+#endif /* PSCI_H */
@@ -0,0 +1,315 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host test and benchmark of the shared memory object datastore of the EL3
+ * SPMC. The datastore code is built for the host as it is, objects are
+ * allocated, looked up and freed like the FF-A memory management ABIs do,
+ * and the handle index is checked against a model of the live objects.
+ * The lookup latency is then measured against the number of objects, and
+ * compared with a walk of the datastore.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Include the datastore code to reach its static functions. */
+#include <spmc_shared_mem.c>
+
+#define MAX_OBJECTS		4096U
+#define MAX_DESC_SIZE		(sizeof(struct ffa_mtd) + 256U)
+#define DATASTORE_SIZE		(MAX_OBJECTS * \
+				 spmc_shmem_obj_size(MAX_DESC_SIZE))
+#define RANDOM_STEPS		200000U
+#define DEFAULT_LOOKUPS		100000U
+#define TAG_MAGIC		0x5a5a5a5a00000000ULL
+
+/*
+ * The datastore code is only linked with the functions below when the FF-A
+ * ABI handlers are built, which the tool never calls.
+ */
+struct secure_partition_desc *spmc_get_current_sp_ctx(void)
+{
+	return NULL;
+}
+
+uint64_t spmc_ffa_error_return(void *handle, int error_code)
+{
+	return (uint64_t)error_code;
+}
+
+struct mailbox *spmc_get_mbox_desc(bool secure_origin)
+{
+	static struct mailbox mbox;
+
+	return &mbox;
+}
+
+struct secure_partition_desc *spmc_get_sp_ctx(uint16_t id)
+{
+	return NULL;
+}
+
+uint32_t get_partition_ffa_version(bool secure_origin)
+{
+	return FFA_VERSION_COMPILED;
+}
+
+int plat_spmc_shmem_begin(struct ffa_mtd *desc)
+{
+	return 0;
+}
+
+int plat_spmc_shmem_reclaim(struct ffa_mtd *desc)
+{
+	return 0;
+}
+
+static uint64_t live[MAX_OBJECTS];
+static unsigned int live_count;
+
+static uint64_t elapsed_ns(const struct timespec *start)
+{
+	struct timespec end;
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	return ((uint64_t)(end.tv_sec - start->tv_sec) * 1000000000ULL) +
+	       (uint64_t)end.tv_nsec - (uint64_t)start->tv_nsec;
+}
+
+/* Lookup of the datastore before the handle index was added. */
+static struct spmc_shmem_obj *
+linear_lookup(struct spmc_shmem_obj_state *state, uint64_t handle)
+{
+	uint8_t *curr = state->data;
+
+	while (curr - state->data < state->allocated) {
+		struct spmc_shmem_obj *obj = (struct spmc_shmem_obj *)curr;
+
+		if (obj->desc.handle == handle) {
+			return obj;
+		}
+		curr += spmc_shmem_obj_size(obj->desc_size);
+	}
+	return NULL;
+}
+
+/* Allocate and index an object, as spmc_ffa_fill_desc() does. */
+static int add_object(size_t desc_size)
+{
+	struct spmc_shmem_obj *obj;
+
+	obj = spmc_shmem_obj_alloc(&spmc_shmem_obj_state, desc_size);
+	if (obj == NULL) {
+		return -1;
+	}
+
+	obj->desc.handle = spmc_shmem_obj_state.next_handle++;
+	obj->desc.tag = TAG_MAGIC ^ obj->desc.handle;
+	spmc_shmem_index_add(&spmc_shmem_obj_state, obj);
+	live[live_count++] = obj->desc.handle;
+
+	return 0;
+}
+
+static void remove_object(unsigned int i)
+{
+	struct spmc_shmem_obj *obj;
+
+	obj = spmc_shmem_obj_lookup(&spmc_shmem_obj_state, live[i]);
+	spmc_shmem_obj_free(&spmc_shmem_obj_state, obj);
+	live[i] = live[--live_count];
+}
+
+static size_t random_desc_size(void)
+{
+	return sizeof(struct ffa_mtd) + (16U * ((size_t)rand() % 17U));
+}
+
+static int check_state(uint64_t freed)
+{
+	struct spmc_shmem_obj *obj;
+	unsigned int i;
+
+	for (i = 0U; i < live_count; i++) {
+		obj = spmc_shmem_obj_lookup(&spmc_shmem_obj_state, live[i]);
+		if ((obj == NULL) || (obj->desc.handle != live[i]) ||
+		    (obj->desc.tag != (TAG_MAGIC ^ live[i]))) {
+			fprintf(stderr, "FAIL: handle 0x%llx not found\n",
+				(unsigned long long)live[i]);
+			return -1;
+		}
+	}
+
+	if ((freed != 0U) &&
+	    (spmc_shmem_obj_lookup(&spmc_shmem_obj_state, freed) != NULL)) {
+		fprintf(stderr, "FAIL: freed handle 0x%llx found\n",
+			(unsigned long long)freed);
+		return -1;
+	}
+
+	return 0;
+}
+
+static void reset_datastore(void)
+{
+	while (live_count != 0U) {
+		remove_object(0U);
+	}
+	assert(spmc_shmem_obj_state.allocated == 0U);
+	assert(spmc_shmem_index.count == 0U);
+}
+
+/*
+ * Randomly allocate and free objects, up to 'max_objects' live ones, and
+ * check after each step that every live object is found and the freed one
+ * is not. With more objects than the index can hold, this also covers the
+ * fallback to the datastore walk.
+ */
+static int run_tests(unsigned int max_objects)
+{
+	unsigned int step, i;
+	uint64_t freed;
+
+	for (step = 0U; step < RANDOM_STEPS; step++) {
+		freed = 0U;
+		if ((live_count < max_objects) &&
+		    ((live_count == 0U) || ((rand() % 3) != 0))) {
+			if (add_object(random_desc_size()) != 0) {
+				return -1;
+			}
+		} else {
+			i = (unsigned int)rand() % live_count;
+			freed = live[i];
+			remove_object(i);
+		}
+
+		/* Checking everything is O(n^2), so only check some steps. */
+		if (((step % 64U) == 0U) || (live_count < 16U) ||
+		    (freed != 0U && (rand() % 16) == 0)) {
+			if (check_state(freed) != 0) {
+				return -1;
+			}
+		}
+	}
+
+	if (check_state(0U) != 0) {
+		return -1;
+	}
+	reset_datastore();
+
+	return 0;
+}
+
+static void run_benchmark(unsigned int count, unsigned int lookups)
+{
+	struct spmc_shmem_obj *obj;
+	uint64_t index_ns, linear_ns;
+	struct timespec start;
+	unsigned int i;
+	uint64_t sum = 0U;
+
+	for (i = 0U; i < count; i++) {
+		if (add_object(random_desc_size()) != 0) {
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (i = 0U; i < lookups; i++) {
+		obj = spmc_shmem_obj_lookup(&spmc_shmem_obj_state,
+					    live[(unsigned int)rand() % count]);
+		sum += obj->desc.tag;
+	}
+	index_ns = elapsed_ns(&start);
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (i = 0U; i < lookups; i++) {
+		obj = linear_lookup(&spmc_shmem_obj_state,
+				    live[(unsigned int)rand() % count]);
+		sum += obj->desc.tag;
+	}
+	linear_ns = elapsed_ns(&start);
+
+	printf("%8u %12.1f %12.1f %s\n", count,
+	       (double)index_ns / lookups, (double)linear_ns / lookups,
+	       spmc_shmem_index.overflow ? "(index full)" : "");
+
+	/* Keep the lookups from being optimised out. */
+	if (sum == 0U) {
+		printf("\n");
+	}
+
+	reset_datastore();
+}
+
+static void usage(const char *name)
+{
+	fprintf(stderr, "Usage: %s [-t] [-n lookups]\n", name);
+	fprintf(stderr, "  -t  only run the correctness tests\n");
+	exit(EXIT_FAILURE);
+}
+
+int main(int argc, char *argv[])
+{
+	static const unsigned int counts[] = {
+		1U, 8U, 32U, 64U, 127U, 128U, 256U, 1024U, 4096U
+	};
+	unsigned int lookups = DEFAULT_LOOKUPS;
+	int tests_only = 0;
+	unsigned int i;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "tn:")) != -1) {
+		switch (opt) {
+		case 't':
+			tests_only = 1;
+			break;
+		case 'n':
+			lookups = (unsigned int)strtoul(optarg, NULL, 0);
+			if (lookups == 0U) {
+				usage(argv[0]);
+			}
+			break;
+		default:
+			usage(argv[0]);
+		}
+	}
+
+	spmc_shmem_obj_state.data_size = DATASTORE_SIZE;
+	spmc_shmem_obj_state.data = malloc(DATASTORE_SIZE);
+	if (spmc_shmem_obj_state.data == NULL) {
+		fprintf(stderr, "Out of memory\n");
+		return EXIT_FAILURE;
+	}
+
+	srand(1U);
+	if ((run_tests(PLAT_SPMC_SHMEM_INDEX_SIZE / 2U) != 0) ||
+	    (run_tests(PLAT_SPMC_SHMEM_INDEX_SIZE - 1U) != 0) ||
+	    (run_tests(MIN(4U * PLAT_SPMC_SHMEM_INDEX_SIZE,
+			MAX_OBJECTS)) != 0)) {
+		return EXIT_FAILURE;
+	}
+	printf("All checks passed\n");
+
+	if (tests_only == 0) {
+		printf("Index size %u, average lookup time in ns:\n",
+		       (unsigned int)PLAT_SPMC_SHMEM_INDEX_SIZE);
+		printf("%8s %12s %12s\n", "objects", "index", "walk");
+		for (i = 0U; i < ARRAY_SIZE(counts); i++) {
+			run_benchmark(counts[i], lookups);
+		}
+	}
+
+	free(spmc_shmem_obj_state.data);
+
+	return EXIT_SUCCESS;
+}
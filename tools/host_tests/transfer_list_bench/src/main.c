@@ -0,0 +1,422 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host test and benchmark of the transfer list library, built for the host as
+ * it is with TRANSFER_LIST_INDEX=1. Random sequences of additions, removals,
+ * resizes, compactions and relocations are applied to a list and mirrored in
+ * a model of its entries. After each operation, the entries of the list must
+ * match the model in order, tag, size, contents and data alignment, and every
+ * lookup through the tag index must return the entry found by walking the
+ * list. The time of a lookup through the index is then compared with a walk
+ * of the list, against the position of the entry in the list.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <lib/transfer_list.h>
+
+#define LIST_SIZE		(512U * 1024U)
+#define MAX_ENTRIES		512U
+#define MAX_TAG			30U
+#define NON_STD_TAG		0xfff000U	/* base of the non-standard tags */
+#define ROUNDS			300U
+#define OPS_PER_ROUND		400U
+#define DEFAULT_LOOKUPS		1000000U
+
+/* Expected state of each entry added to the list, in list order. */
+typedef struct {
+	uint32_t tag_id;
+	uint32_t data_size;
+	uint8_t seed;
+	uint8_t alignment;
+	bool live;
+} model_entry_t;
+
+static model_entry_t model[MAX_ENTRIES];
+static unsigned int model_count;
+
+/* Two buffers for the list to be relocated back and forth. */
+static uint64_t buffers[2][(LIST_SIZE * 2U) / sizeof(uint64_t)];
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+/* Lookup by walking the list, as the library does without the index. */
+static struct transfer_list_entry *walk_find(struct transfer_list_header *tl,
+					     uint32_t tag_id)
+{
+	struct transfer_list_entry *te = NULL;
+
+	do {
+		te = transfer_list_next(tl, te);
+	} while ((te != NULL) && (te->tag_id != tag_id));
+
+	return te;
+}
+
+static void fill_data(struct transfer_list_entry *te, uint8_t seed)
+{
+	uint8_t *data = transfer_list_entry_data(te);
+	uint32_t i;
+
+	for (i = 0U; i < te->data_size; i++) {
+		data[i] = (uint8_t)(seed + (i * 7U));
+	}
+}
+
+static bool check_data(struct transfer_list_entry *te, uint8_t seed)
+{
+	uint8_t *data = transfer_list_entry_data(te);
+	uint32_t i;
+
+	for (i = 0U; i < te->data_size; i++) {
+		if (data[i] != (uint8_t)(seed + (i * 7U))) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/*
+ * Random tag in use in the list. Half of them are non-standard tags, which
+ * only differ from the standard ones above the lower 16 bits.
+ */
+static uint32_t random_tag(void)
+{
+	uint32_t tag_id = 1U + ((unsigned int)rand() % MAX_TAG);
+
+	return ((rand() % 2) == 0) ? tag_id : (NON_STD_TAG | tag_id);
+}
+
+/* Index in the model of the first live entry of a tag. */
+static int model_find(uint32_t tag_id)
+{
+	unsigned int i;
+
+	for (i = 0U; i < model_count; i++) {
+		if (model[i].live && (model[i].tag_id == tag_id)) {
+			return (int)i;
+		}
+	}
+
+	return -1;
+}
+
+static int check_list(struct transfer_list_header *tl)
+{
+	struct transfer_list_entry *te = NULL;
+	unsigned int i = 0U;
+	uint32_t tag_id, n;
+	uintptr_t mask;
+
+	if (transfer_list_check_header(tl) != TL_OPS_ALL) {
+		fprintf(stderr, "FAIL: bad list header\n");
+		return -1;
+	}
+
+	while ((te = transfer_list_next(tl, te)) != NULL) {
+		if (te->tag_id == TL_TAG_EMPTY) {
+			continue;
+		}
+		while ((i < model_count) && !model[i].live) {
+			i++;
+		}
+		if (i == model_count) {
+			fprintf(stderr, "FAIL: unexpected entry of tag 0x%x\n",
+				te->tag_id);
+			return -1;
+		}
+
+		mask = (1UL << model[i].alignment) - 1UL;
+		if ((te->tag_id != model[i].tag_id) ||
+		    (te->data_size != model[i].data_size) ||
+		    !check_data(te, model[i].seed) ||
+		    (((uintptr_t)transfer_list_entry_data(te) & mask) != 0U)) {
+			fprintf(stderr, "FAIL: entry %u of tag 0x%x is corrupted\n",
+				i, model[i].tag_id);
+			return -1;
+		}
+		i++;
+	}
+
+	while ((i < model_count) && !model[i].live) {
+		i++;
+	}
+	if (i != model_count) {
+		fprintf(stderr, "FAIL: entry %u of tag 0x%x is missing\n",
+			i, model[i].tag_id);
+		return -1;
+	}
+
+	for (n = 1U; n <= ((MAX_TAG + 2U) * 2U); n++) {
+		tag_id = ((n % 2U) == 0U) ? (n / 2U) : (NON_STD_TAG | (n / 2U));
+		if (transfer_list_find(tl, tag_id) != walk_find(tl, tag_id)) {
+			fprintf(stderr, "FAIL: wrong lookup of tag 0x%x\n",
+				tag_id);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+static void op_add(struct transfer_list_header *tl)
+{
+	struct transfer_list_entry *te;
+	uint32_t tag_id = random_tag();
+	uint32_t data_size = (unsigned int)rand() % 200U;
+	uint8_t alignment = TRANSFER_LIST_INIT_MAX_ALIGN;
+
+	if (model_count == MAX_ENTRIES) {
+		return;
+	}
+
+	/* Sometimes raise the alignment of the list. */
+	if ((rand() % 4) == 0) {
+		alignment += (unsigned int)rand() % 4U;
+	}
+
+	if ((alignment == TRANSFER_LIST_INIT_MAX_ALIGN) && ((rand() % 2) == 0)) {
+		te = transfer_list_add(tl, tag_id, data_size, NULL);
+	} else {
+		te = transfer_list_add_with_align(tl, tag_id, data_size, NULL,
+						  alignment);
+	}
+	if (te == NULL) {
+		return;
+	}
+
+	model[model_count] = (model_entry_t) {
+		.tag_id = tag_id,
+		.data_size = data_size,
+		.seed = (uint8_t)rand(),
+		.alignment = alignment,
+		.live = true,
+	};
+	fill_data(te, model[model_count].seed);
+	transfer_list_update_checksum(tl);
+	model_count++;
+}
+
+static int op_rem(struct transfer_list_header *tl, bool behind_library)
+{
+	uint32_t tag_id = random_tag();
+	struct transfer_list_entry *te = transfer_list_find(tl, tag_id);
+	int i = model_find(tag_id);
+
+	if ((te == NULL) || (i < 0)) {
+		return ((te == NULL) && (i < 0)) ? 0 : -1;
+	}
+
+	model[i].live = false;
+
+	/*
+	 * Also void entries without the library, like code with its own view
+	 * of the list would. The index must notice the entry it holds is gone.
+	 */
+	if (behind_library) {
+		te->tag_id = TL_TAG_EMPTY;
+		transfer_list_update_checksum(tl);
+		return 0;
+	}
+
+	return transfer_list_rem(tl, te) ? 0 : -1;
+}
+
+static void op_resize(struct transfer_list_header *tl)
+{
+	uint32_t tag_id = random_tag();
+	struct transfer_list_entry *te = transfer_list_find(tl, tag_id);
+	uint32_t data_size = (unsigned int)rand() % 300U;
+	int i = model_find(tag_id);
+
+	if ((te == NULL) || (i < 0) ||
+	    !transfer_list_set_data_size(tl, te, data_size)) {
+		return;
+	}
+
+	model[i].data_size = data_size;
+	fill_data(te, model[i].seed);
+	transfer_list_update_checksum(tl);
+}
+
+static int op_compact(struct transfer_list_header *tl)
+{
+	uint32_t size = tl->size;
+
+	if (!transfer_list_compact(tl) || (tl->size > size)) {
+		fprintf(stderr, "FAIL: compaction\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+static struct transfer_list_header *op_relocate(struct transfer_list_header *tl)
+{
+	uint8_t *dst = (uint8_t *)buffers[((void *)tl == buffers[0]) ? 1 : 0];
+
+	/* Move it by a random multiple of the granule. */
+	dst += TRANSFER_LIST_GRANULE * ((unsigned int)rand() % 16U);
+
+	return transfer_list_relocate(tl, dst, LIST_SIZE);
+}
+
+static int run_tests(void)
+{
+	struct transfer_list_header *tl;
+	unsigned int round, op;
+	int r, ret;
+
+	for (round = 0U; round < ROUNDS; round++) {
+		tl = transfer_list_init(buffers[0], LIST_SIZE);
+		if (tl == NULL) {
+			fprintf(stderr, "FAIL: list initialisation\n");
+			return -1;
+		}
+		model_count = 0U;
+
+		for (op = 0U; op < OPS_PER_ROUND; op++) {
+			r = rand() % 100;
+			ret = 0;
+
+			if (r < 35) {
+				op_add(tl);
+			} else if (r < 55) {
+				ret = op_rem(tl, false);
+			} else if (r < 60) {
+				ret = op_rem(tl, true);
+			} else if (r < 75) {
+				op_resize(tl);
+			} else if (r < 85) {
+				ret = op_compact(tl);
+			} else if (r < 90) {
+				tl = op_relocate(tl);
+				if (tl == NULL) {
+					fprintf(stderr, "FAIL: relocation\n");
+					return -1;
+				}
+			}
+
+			if ((ret != 0) || (check_list(tl) != 0)) {
+				fprintf(stderr, "FAIL: round %u, operation %u\n",
+					round, op);
+				return -1;
+			}
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * Time of a lookup of the last entry of a list of `count` entries, through
+ * the index and by walking the list, in ns.
+ */
+static void run_benchmark(unsigned int count, unsigned int lookups)
+{
+	struct transfer_list_header *tl;
+	struct transfer_list_entry *te = NULL;
+	uint64_t start, indexed, walked;
+	uint32_t tag_id;
+	unsigned int i;
+
+	tl = transfer_list_init(buffers[0], LIST_SIZE);
+	for (i = 0U; i < count; i++) {
+		/* The first entries share a few tags, the last have their own. */
+		tag_id = (i + 4U < count) ? (100U + (i % 4U)) : (10U + i);
+		if (transfer_list_add(tl, tag_id, 64U, NULL) == NULL) {
+			fprintf(stderr, "List full after %u entries\n", i);
+			exit(EXIT_FAILURE);
+		}
+	}
+	tag_id = 10U + count - 1U;
+
+	start = now_ns();
+	for (i = 0U; i < lookups; i++) {
+		te = transfer_list_find(tl, tag_id);
+	}
+	indexed = now_ns() - start;
+
+	start = now_ns();
+	for (i = 0U; i < lookups; i++) {
+		te = walk_find(tl, tag_id);
+	}
+	walked = now_ns() - start;
+
+	/* Keep the lookups from being optimised out. */
+	if (te == NULL) {
+		printf("\n");
+	}
+
+	printf("%8u %10.1f %10.1f\n", count, (double)indexed / lookups,
+	       (double)walked / lookups);
+}
+
+static void usage(const char *name)
+{
+	fprintf(stderr, "Usage: %s [-t] [-n lookups]\n", name);
+	fprintf(stderr, "  -t  only run the correctness tests\n");
+	fprintf(stderr, "  -n  lookups per measurement (default: %u)\n",
+		DEFAULT_LOOKUPS);
+	exit(EXIT_FAILURE);
+}
+
+int main(int argc, char *argv[])
+{
+	static const unsigned int counts[] = { 4U, 16U, 64U, 212U, 1024U };
+	unsigned int lookups = DEFAULT_LOOKUPS;
+	int tests_only = 0;
+	unsigned int i;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "tn:")) != -1) {
+		switch (opt) {
+		case 't':
+			tests_only = 1;
+			break;
+		case 'n':
+			lookups = (unsigned int)strtoul(optarg, NULL, 0);
+			if (lookups == 0U) {
+				usage(argv[0]);
+			}
+			break;
+		default:
+			usage(argv[0]);
+		}
+	}
+
+	srand(1U);
+
+	if (run_tests() != 0) {
+		return EXIT_FAILURE;
+	}
+	printf("All checks passed\n");
+
+	if (tests_only == 0) {
+		printf("Lookup of the last entry, in ns:\n");
+		printf("%8s %10s %10s\n", "entries", "index", "walk");
+		for (i = 0U; i < (sizeof(counts) / sizeof(counts[0])); i++) {
+			run_benchmark(counts[i], lookups);
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
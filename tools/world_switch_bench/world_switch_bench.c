@@ -0,0 +1,199 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ */
+
+/*
+ * Normal world benchmark of the world switches of BL31. When loaded, the
+ * module issues fast TSP_ADD SMCs in a loop on the current CPU. Each of them
+ * switches to the TSP and back, so its round trip time is dominated by two
+ * world switches. The distribution of the round trip time is printed, along
+ * with the world switch histogram that BL31 keeps when built with
+ * PMF_LATENCY_HIST=1, covering the same SMCs. All the times are in system
+ * counter ticks.
+ *
+ * When the smc_fid parameter is set, the module times that SMC instead, with
+ * smc_arg as its first argument. This measures the round trip of an SMC
+ * handled in BL31 alone, such as TRNG_RND64, for example to compare the SMC
+ * dispatch of BL31 built with and without SMC_FAST_PATH.
+ */
+
+#include <linux/arm-smccc.h>
+#include <linux/bitops.h>
+#include <linux/kernel.h>
+#include <linux/math64.h>
+#include <linux/module.h>
+#include <linux/moduleparam.h>
+#include <linux/smp.h>
+
+#include <asm/barrier.h>
+#include <asm/cputype.h>
+#include <asm/sysreg.h>
+
+/* From include/bl32/tsp/tsp.h */
+#define TSP_FAST_ADD_FID		0xf2002000U
+
+/* From include/lib/smccc.h */
+#define SMC_UNK				0xffffffffUL
+
+/* From include/lib/pmf/pmf.h */
+#define PMF_SMC_GET_LATENCY_HIST_64	0xc2000011U
+#define PMF_HIST_WORLD_SWITCH_ID	11U
+#define PMF_HIST_BUCKETS		32U
+
+static unsigned int iterations = 100000U;
+module_param(iterations, uint, 0444);
+MODULE_PARM_DESC(iterations, "Number of SMCs to issue");
+
+static unsigned int smc_fid;
+module_param(smc_fid, uint, 0444);
+MODULE_PARM_DESC(smc_fid, "Function ID of the SMC to time instead of TSP_ADD");
+
+static unsigned long smc_arg;
+module_param(smc_arg, ulong, 0444);
+MODULE_PARM_DESC(smc_arg, "First argument of the smc_fid SMC");
+
+static u64 round_trips[PMF_HIST_BUCKETS];
+
+/* Same bucketing as the BL31 histograms. */
+static unsigned int hist_bucket(u64 ticks)
+{
+	return min_t(unsigned int, fls64(ticks), PMF_HIST_BUCKETS - 1U);
+}
+
+static int read_world_switch_hist(u32 *buckets)
+{
+	struct arm_smccc_1_2_regs args = {
+		.a0 = PMF_SMC_GET_LATENCY_HIST_64,
+		.a1 = PMF_HIST_WORLD_SWITCH_ID,
+		.a2 = read_cpuid_mpidr() & MPIDR_HWID_BITMASK,
+	};
+	struct arm_smccc_1_2_regs res;
+	const unsigned long *regs = &res.a1;
+	unsigned int i;
+
+	arm_smccc_1_2_smc(&args, &res);
+	if (res.a0 != 0UL)
+		return -EOPNOTSUPP;
+
+	for (i = 0U; i < PMF_HIST_BUCKETS; i += 2U) {
+		buckets[i] = lower_32_bits(regs[i / 2U]);
+		buckets[i + 1U] = upper_32_bits(regs[i / 2U]);
+	}
+
+	return 0;
+}
+
+static void print_hist(const char *name, const u64 *buckets)
+{
+	unsigned int i;
+
+	pr_info("%s:\n", name);
+	for (i = 0U; i < PMF_HIST_BUCKETS; i++) {
+		if (buckets[i] == 0U)
+			continue;
+		if (i == 0U)
+			pr_info("  %10u ticks: %llu\n", 0U, buckets[i]);
+		else
+			pr_info("  %10llu ticks: %llu\n", BIT_ULL(i - 1U),
+				buckets[i]);
+	}
+}
+
+/* Issue one SMC and return its round trip time in 'ticks'. */
+static int timed_smc(unsigned int i, u64 *ticks)
+{
+	struct arm_smccc_res res;
+	u64 start;
+
+	if (smc_fid != 0U) {
+		isb();
+		start = read_sysreg(cntvct_el0);
+		arm_smccc_smc(smc_fid, smc_arg, 0, 0, 0, 0, 0, 0, &res);
+		isb();
+		*ticks = read_sysreg(cntvct_el0) - start;
+
+		/* Any other result still went through BL31 and back. */
+		if ((u32)res.a0 == (u32)SMC_UNK) {
+			pr_err("SMC 0x%x is not implemented\n", smc_fid);
+			return -EOPNOTSUPP;
+		}
+
+		return 0;
+	}
+
+	isb();
+	start = read_sysreg(cntvct_el0);
+	arm_smccc_smc(TSP_FAST_ADD_FID, i, 1U, 0, 0, 0, 0, 0, &res);
+	isb();
+	*ticks = read_sysreg(cntvct_el0) - start;
+
+	/* The TSP adds each argument to itself. */
+	if ((res.a0 != 0UL) || (res.a1 != 2UL * i) || (res.a2 != 2UL)) {
+		pr_err("TSP_ADD failed, is the TSPD running?\n");
+		return -ENODEV;
+	}
+
+	return 0;
+}
+
+static int __init world_switch_bench_init(void)
+{
+	u32 before[PMF_HIST_BUCKETS], after[PMF_HIST_BUCKETS];
+	u64 world_switches[PMF_HIST_BUCKETS];
+	u64 ticks, total = 0U;
+	bool have_hist;
+	unsigned int i;
+	int cpu, ret;
+
+	cpu = get_cpu();
+
+	/* Only TSP_ADD switches worlds. */
+	have_hist = (smc_fid == 0U) && (read_world_switch_hist(before) == 0);
+
+	for (i = 0U; i < iterations; i++) {
+		ret = timed_smc(i, &ticks);
+		if (ret != 0) {
+			put_cpu();
+			return ret;
+		}
+
+		total += ticks;
+		round_trips[hist_bucket(ticks)]++;
+	}
+
+	if (have_hist)
+		have_hist = (read_world_switch_hist(after) == 0);
+
+	put_cpu();
+
+	pr_info("CPU%d: %u SMCs, mean round trip %llu ticks, counter at %llu Hz\n",
+		cpu, iterations, div_u64(total, iterations),
+		(u64)read_sysreg(cntfrq_el0));
+	print_hist("Round trip time of the SMCs", round_trips);
+
+	if (smc_fid != 0U)
+		return 0;
+
+	if (!have_hist) {
+		pr_info("No world switch histogram, BL31 built without PMF_LATENCY_HIST\n");
+		return 0;
+	}
+
+	/* The counters wrap around, only their difference is meaningful. */
+	for (i = 0U; i < PMF_HIST_BUCKETS; i++)
+		world_switches[i] = (u32)(after[i] - before[i]);
+	print_hist("BL31 world switch time", world_switches);
+
+	return 0;
+}
+
+static void __exit world_switch_bench_exit(void)
+{
+}
+
+module_init(world_switch_bench_init);
+module_exit(world_switch_bench_exit);
+
+MODULE_DESCRIPTION("TF-A world switch benchmark");
+MODULE_LICENSE("Dual BSD/GPL");